@@ -0,0 +1,368 @@
+/*
+ *  Name: batch.c
+ *  Description: Headless batch evaluation (mvqcalc --batch)
+ *
+ *  Copyright (C) 2012  Jason Hall
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Runs the calculator operations on operands read from files or stdin,
+ * without initializing GTK, so it works without a display:
+ *
+ *	mvqcalc --batch [--explain] [FILE...]
+ *
+ * Each input line names a button followed by operands A and B, every
+ * operand being a type letter and its components, separated by spaces
+ * or commas:
+ *
+ *	m  16 reals, column major like mat4x4_t
+ *	v  x y z
+ *	q  x y z w
+ *	s  a single real
+ *
+ * for example "cross v 1 0 0 v 0 1 0". Blank lines and lines starting
+ * with '#' are skipped. Every other line produces exactly one output line
+ * holding the result in the same notation ("v 0 0 1"), with the fewest
+ * digits that read back exactly, so the output can be fed back in. Swap
+ * prints the new A and B. A line that cannot be evaluated prints "error"
+ * and a message on stderr, keeping the output lines in step with the
+ * input.
+ *
+ * With --explain the step by step text the GUI shows in its notes window
+ * is written before each result as '#' comment lines. Without it the
+ * text is never formatted.
+ *
+ * The GUI runs batch files in the background with batch_run_file().
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <ctype.h>
+#include <errno.h>
+
+/* fstat() */
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include "calc.h"
+#include "numfmt.h"
+#include "numparse.h"
+
+#define BATCH_OUTPUT_BUFFER	(64 * 1024)
+
+/* lines between calls of the poll function */
+#define BATCH_POLL_LINES	1024
+
+typedef gboolean (*batch_poll_func_t)(long offset, void *data);
+
+typedef struct {
+    batch_progress_func_t progress;
+    void *data;
+    long size;
+} batch_file_poll_t;
+
+static const struct {
+    char tag;
+    operand_type_t type;
+} operand_tags[] = {
+    { 'm', OPERAND_MATRIX },
+    { 'v', OPERAND_VECTOR },
+    { 'q', OPERAND_QUAT },
+    { 's', OPERAND_SCALAR },
+};
+
+static void
+batch_explain(const char *fmt, ...)
+{
+    va_list ap;
+
+    fputs("# ", stdout);
+    va_start(ap, fmt);
+    vfprintf(stdout, fmt, ap);
+    va_end(ap);
+}
+
+static char
+operand_tag(operand_type_t type)
+{
+    int i;
+
+    for (i = 0; i < (int) G_N_ELEMENTS(operand_tags); i++) {
+	if (operand_tags[i].type == type)
+	    return operand_tags[i].tag;
+    }
+    return '?';
+}
+
+static char *
+skip_space(char *p)
+{
+    while (isspace((unsigned char) *p))
+	p++;
+    return p;
+}
+
+/*
+ * Parse one operand starting at *p, advancing *p past it.
+ * Returns FALSE on a malformed operand.
+ */
+static gboolean
+parse_operand(char **p, operand_t *op)
+{
+    char *s = skip_space(*p);
+    const char *end;
+    int i, n;
+
+    op->type = OPERAND_NONE;
+    for (i = 0; i < (int) G_N_ELEMENTS(operand_tags); i++) {
+	if (*s == operand_tags[i].tag && (s[1] == '\0' || isspace((unsigned char) s[1]))) {
+	    op->type = operand_tags[i].type;
+	    break;
+	}
+    }
+    if (op->type == OPERAND_NONE)
+	return FALSE;
+    s++;
+
+    // all union members start at the same address
+    n = calc_operand_size(op->type);
+    if (numparse_array(s, op->u.m, n, &end) != (size_t) n)
+	return FALSE;
+
+    *p = (char *) end;
+    return TRUE;
+}
+
+static void
+print_operand(FILE *out, operand_t *op)
+{
+    char buf[16 * NUMFMT_MAX];
+    size_t len;
+
+    // shortest round trip, so reading the output back is exact
+    len = numfmt_array(op->u.m, calc_operand_size(op->type), ' ', buf,
+	    sizeof(buf), NULL);
+
+    fputc(operand_tag(op->type), out);
+    fputc(' ', out);
+    fwrite(buf, 1, len - 1, out);
+}
+
+/*
+ * Evaluate one line. Returns TRUE if it was skipped or evaluated, FALSE
+ * on an error (already reported).
+ */
+static gboolean
+batch_line(const char *file, long lineno, char *line, FILE *out)
+{
+    operand_t a, b, c;
+    const calc_op_t *op;
+    char *p, *name;
+
+    p = skip_space(line);
+    if (*p == '\0' || *p == '#')
+	return TRUE;
+
+    name = p;
+    while (*p != '\0' && !isspace((unsigned char) *p))
+	p++;
+    if (*p != '\0')
+	*p++ = '\0';
+
+    if (!parse_operand(&p, &a) || !parse_operand(&p, &b)) {
+	fprintf(stderr, "mvqcalc: %s:%ld: malformed operand\n", file, lineno);
+	goto error;
+    }
+    if (*skip_space(p) != '\0') {
+	fprintf(stderr, "mvqcalc: %s:%ld: trailing input\n", file, lineno);
+	goto error;
+    }
+
+    op = calc_op_find(name, a.type, b.type);
+    if (op == NULL) {
+	fprintf(stderr, "mvqcalc: %s:%ld: no %s operation for %c and %c\n",
+		file, lineno, name, operand_tag(a.type), operand_tag(b.type));
+	goto error;
+    }
+
+    c.type = op->c;
+    op->func(&a, &b, &c);
+
+    if (op->c == OPERAND_NONE) {
+	print_operand(out, &a);
+	fputc(' ', out);
+	print_operand(out, &b);
+    } else {
+	print_operand(out, &c);
+    }
+    fputc('\n', out);
+    return TRUE;
+
+error:
+    fputs("error\n", out);
+    return FALSE;
+}
+
+/*
+ * Evaluate every line of in. If poll is given it is called every
+ * BATCH_POLL_LINES lines with how far into in we are, and the file is
+ * abandoned when it returns FALSE. Line counts are added to stats.
+ */
+static gboolean
+batch_file(const char *file, FILE *in, FILE *out, batch_poll_func_t poll,
+	void *data, batch_stats_t *stats)
+{
+    gboolean ok = TRUE;
+    char *line = NULL;
+    size_t size = 0;
+    long lineno = 0;
+
+    while (getline(&line, &size, in) != -1) {
+	if (!batch_line(file, ++lineno, line, out)) {
+	    ok = FALSE;
+	    stats->errors++;
+	}
+	stats->lines++;
+
+	if (poll != NULL && lineno % BATCH_POLL_LINES == 0 &&
+		!poll(ftell(in), data)) {
+	    stats->cancelled = TRUE;
+	    ok = FALSE;
+	    break;
+	}
+    }
+    if (ferror(in)) {
+	perror(file);
+	ok = FALSE;
+    }
+
+    free(line);
+    return ok;
+}
+
+static gboolean
+batch_file_poll(long offset, void *data)
+{
+    batch_file_poll_t *fp = data;
+
+    return fp->progress(fp->size > 0 ? (double) offset / fp->size : 0, fp->data);
+}
+
+/*
+ * Evaluate the file in_path into out_path, for use off the main thread:
+ * nothing goes to stdout, only malformed lines are reported on stderr.
+ * progress gets the fraction of the input done so far and returns FALSE
+ * to stop. Returns TRUE if every line was evaluated.
+ */
+gboolean
+batch_run_file(const char *in_path, const char *out_path,
+	batch_progress_func_t progress, void *data, batch_stats_t *stats)
+{
+    batch_file_poll_t fp;
+    struct stat st;
+    FILE *in, *out;
+    gboolean ok;
+
+    memset(stats, 0, sizeof(*stats));
+
+    if ((in = fopen(in_path, "r")) == NULL) {
+	perror(in_path);
+	return FALSE;
+    }
+    if ((out = fopen(out_path, "w")) == NULL) {
+	perror(out_path);
+	fclose(in);
+	return FALSE;
+    }
+
+    fp.progress = progress;
+    fp.data = data;
+    fp.size = fstat(fileno(in), &st) == 0 ? st.st_size : 0;
+
+    ok = batch_file(in_path, in, out, progress != NULL ? batch_file_poll : NULL,
+	    &fp, stats);
+
+    fclose(in);
+    if (fclose(out) != 0) {
+	perror(out_path);
+	ok = FALSE;
+    }
+
+    return ok;
+}
+
+static void
+batch_usage(void)
+{
+    fprintf(stderr, "usage: mvqcalc --batch [--explain] [FILE...]\n");
+    exit(2);
+}
+
+/*
+ * Entry point for --batch, argv[0] is the --batch argument itself.
+ * Returns the process exit status: 0 if every line was evaluated.
+ */
+int
+batch_main(int argc, char **argv)
+{
+    static char outbuf[BATCH_OUTPUT_BUFFER];
+    gboolean ok = TRUE, files = FALSE;
+    batch_stats_t stats = { 0 };
+    FILE *in;
+    int i;
+
+    setvbuf(stdout, outbuf, _IOFBF, sizeof(outbuf));
+
+    for (i = 1; i < argc; i++) {
+	if (strcmp(argv[i], "--explain") == 0) {
+	    calc_explain = batch_explain;
+	} else if (strcmp(argv[i], "--") == 0) {
+	    i++;
+	    break;
+	} else if (argv[i][0] == '-' && argv[i][1] != '\0') {
+	    batch_usage();
+	} else {
+	    break;
+	}
+    }
+
+    for (; i < argc; i++) {
+	files = TRUE;
+	if (strcmp(argv[i], "-") == 0) {
+	    ok &= batch_file("<stdin>", stdin, stdout, NULL, NULL, &stats);
+	    continue;
+	}
+	if ((in = fopen(argv[i], "r")) == NULL) {
+	    perror(argv[i]);
+	    ok = FALSE;
+	    continue;
+	}
+	ok &= batch_file(argv[i], in, stdout, NULL, NULL, &stats);
+	fclose(in);
+    }
+
+    if (!files)
+	ok = batch_file("<stdin>", stdin, stdout, NULL, NULL, &stats);
+
+    if (fflush(stdout) != 0) {
+	perror("mvqcalc: stdout");
+	ok = FALSE;
+    }
+
+    return ok ? 0 : 1;
+}
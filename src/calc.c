@@ -0,0 +1,485 @@
+/*
+ *  Name: calc.c
+ *  Description: Calculator operations shared by the GUI and batch mode
+ *
+ *  Copyright (C) 2012  Jason Hall
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+
+#include "calc.h"
+
+__thread calc_explain_func_t calc_explain = NULL;
+
+/* only evaluates the arguments when somebody is listening */
+#define explain(...)							\
+    do {								\
+	if (calc_explain != NULL)					\
+	    calc_explain(__VA_ARGS__);					\
+    } while (0)
+
+///////////////////////////////////////////////////////////////////////
+//////////////////////////////  ADD  //////////////////////////////////
+///////////////////////////////////////////////////////////////////////
+
+void
+calc_add_vector_vector_vector(vec3_t a, vec3_t b, vec3_t c)
+{
+    vec3_add(a, b, c);
+}
+
+void
+calc_add_quat_quat_quat(quat_t a, quat_t b, quat_t c)
+{
+    quat_add(a, b, c);
+}
+
+///////////////////////////////////////////////////////////////////////
+////////////////////////////  SUBTRACT  ///////////////////////////////
+///////////////////////////////////////////////////////////////////////
+
+void
+calc_subtract_vector_vector_vector(vec3_t a, vec3_t b, vec3_t c)
+{
+    vec3_sub(a, b, c);
+}
+
+void
+calc_subtract_quat_quat_quat(quat_t a, quat_t b, quat_t c)
+{
+    quat_sub_quick(a, b, c);
+}
+
+///////////////////////////////////////////////////////////////////////
+//////////////////////////////  DOT  //////////////////////////////////
+///////////////////////////////////////////////////////////////////////
+
+void
+calc_dot_vector_vector_scalar(vec3_t a, vec3_t b, real *c)
+{
+    explain(">>> obtaining dot product of vector A and vector B\n");
+
+    *c = vec3_dot(a, b);
+}
+
+///////////////////////////////////////////////////////////////////////
+/////////////////////////////  CROSS  /////////////////////////////////
+///////////////////////////////////////////////////////////////////////
+
+void
+calc_cross_vector_vector_vector(vec3_t a, vec3_t b, vec3_t c)
+{
+    explain(">>> Performing cross product operation\n");
+    explain("X = (AY*BZ) - (AZ*BY)\n");
+    explain("X = (%g*%g) - (%g*%g)\n", a[Y], b[Z], a[Z], b[Y]);
+    explain("Y = (AZ*BX) - (AX*BZ)\n");
+    explain("Y = (%g*%g) - (%g*%g)\n", a[Z], b[X], a[X], b[Z]);
+    explain("Z = (AX*BY) - (AY*BX)\n");
+    explain("Z = (%g*%g) - (%g*%g)\n", a[X], b[Y], a[Y], b[X]);
+
+    vec3_cross(a, b, c);
+}
+
+///////////////////////////////////////////////////////////////////////
+/////////////////////////////  ANGLE  /////////////////////////////////
+///////////////////////////////////////////////////////////////////////
+
+void
+calc_angle_vector_vector_scalar(vec3_t a, vec3_t b, real *c)
+{
+    explain("WARNING: answer may not be correct, verification required\n");
+    explain(">>> calculating angle between vector A & vector B (units in radians)\n");
+
+    vec3_angle(a, b, c);
+
+    explain("C = %g degrees\n", *c * RAD2DEG);
+}
+
+///////////////////////////////////////////////////////////////////////
+///////////////////////////  MULTIPLY  ////////////////////////////////
+///////////////////////////////////////////////////////////////////////
+
+void
+calc_multiply_matrix_matrix_matrix(mat4x4_t a, mat4x4_t b, mat4x4_t c)
+{
+    int i, j;
+
+    explain(">>> multiplying matrix a & matrix b\n");
+
+    mat4x4_mult(a, b, c);
+
+    if (calc_explain == NULL)
+	return;
+
+#define M1(row,col)  a[(col<<2)+row]
+#define M2(row,col)  b[(col<<2)+row]
+
+    for (i = 0; i < 4; i++) {
+	for (j = 0; j < 4; j++) {
+	    explain("C%d%d = (A%d0 * B0%d) + (A%d1 * B1%d) + (A%d2 * B2%d) + (A%d3 * B3%d)\n",
+		    i, j, i, j, i, j, i, j, i, j);
+	    explain("C%d%d = (%g * %g) + (%g * %g) + (%g * %g) + (%g * %g)\n",
+		    i, j,
+		    M1(i,0), M2(0,j),
+		    M1(i,1), M2(1,j),
+		    M1(i,2), M2(2,j),
+		    M1(i,3), M2(3,j));
+	}
+    }
+
+#undef M1
+#undef M2
+}
+
+// same as calc_scale_scalar_vector_vector
+void
+calc_multiply_scalar_vector_vector(real a, vec3_t b, vec3_t c)
+{
+    explain(">>> Multiplying vector by scalar\n");
+
+    vec3_cp(b, c);
+    vec3_scale(c, a);
+}
+
+void
+calc_multiply_vector_vector_vector(vec3_t a, vec3_t b, vec3_t c)
+{
+    explain(">>> Multiplying vector by vector\n");
+
+    vec3_mult(a, b, c);
+}
+
+void
+calc_multiply_quat_quat_quat(quat_t a, quat_t b, quat_t c)
+{
+    quat_cp(a, c);
+
+    explain(">>> Multiplying quaternion by quaternion\n");
+    // q1[X] = q2[W] * tmp[X] + q2[X] * tmp[W] + q2[Y] * tmp[Z] - q2[Z] * tmp[Y];
+    explain("X = (AX * BW) + (AW * BX) + (AZ * BY) - (AY * BZ)\n");
+    explain("X = (%g * %g) + (%g * %g) + (%g * %g) - (%g * %g)\n",
+	    a[X], b[W], a[W], b[X], a[Z], b[Y], a[Y], b[Z]);
+    // q1[Y] = q2[W] * tmp[Y] - q2[X] * tmp[Z] + q2[Y] * tmp[W] + q2[Z] * tmp[X];
+    explain("Y = (AY * BW) - (AZ * BX) + (AW * BY) + (AX * BZ)\n");
+    explain("Y = (%g * %g) - (%g * %g) + (%g * %g) + (%g * %g)\n",
+	    a[Y], b[W], a[Z], b[X], a[W], b[Y], a[X], b[Z]);
+    // q1[Z] = q2[W] * tmp[Z] + q2[X] * tmp[Y] - q2[Y] * tmp[X] + q2[Z] * tmp[W];
+    explain("Z = (AZ * BW) + (AY * BX) - (AX * BY) + (AW * BZ)\n");
+    explain("Z = (%g * %g) + (%g * %g) - (%g * %g) + (%g * %g)\n",
+	    a[Z], b[W], a[Y], b[X], a[X], b[Y], a[W], b[Z]);
+    // q1[W] = q2[W] * tmp[W] - q2[X] * tmp[X] - q2[Y] * tmp[Y] - q2[Z] * tmp[Z];
+    explain("W = (AW * BW) - (AX * BX) - (AY * BY) - (AZ * BZ)\n");
+    explain("W = (%g * %g) - (%g * %g) - (%g * %g) - (%g * %g)\n",
+	    a[W], b[W], a[X], b[X], a[Y], b[Y], a[Z], b[Z]);
+
+    quat_mult(c, b);
+}
+
+///////////////////////////////////////////////////////////////////////
+////////////////////////////  DIVIDE  /////////////////////////////////
+///////////////////////////////////////////////////////////////////////
+
+void
+calc_divide_vector_vector_vector(vec3_t a, vec3_t b, vec3_t c)
+{
+    explain(">>> dividing vector A by vector B\n");
+
+    c[X] = a[X] / b[X];
+    c[Y] = a[Y] / b[Y];
+    c[Z] = a[Z] / b[Z];
+}
+
+/*
+ * This is sort of backwards...
+ */
+void
+calc_divide_scalar_vector_vector(real a, vec3_t b, vec3_t c)
+{
+    explain(">>> dividing vector B by scalar A\n");
+
+    vec3_cp(b, c);
+    vec3_div(c, a);
+}
+
+///////////////////////////////////////////////////////////////////////
+///////////////////////////  TRANSLATE  ///////////////////////////////
+///////////////////////////////////////////////////////////////////////
+
+void
+calc_translate_vector_matrix_matrix(vec3_t a, mat4x4_t b, mat4x4_t c)
+{
+    explain(">>> translating matrix by vector\n");
+
+    mat4x4_copy(b, c);
+    mat4x4_translate(c, a[X], a[Y], a[Z]);
+}
+
+///////////////////////////////////////////////////////////////////////
+/////////////////////////////  SCALE  /////////////////////////////////
+///////////////////////////////////////////////////////////////////////
+
+void
+calc_scale_scalar_matrix_matrix(real a, mat4x4_t b, mat4x4_t c)
+{
+    explain(">>> scaling matrix by scalar\n");
+
+    mat4x4_copy(b, c);
+    mat4x4_scale(c, a);
+}
+
+// same as calc_multiply_scalar_vector_vector
+void
+calc_scale_scalar_vector_vector(real a, vec3_t b, vec3_t c)
+{
+    explain(">>> scaling vector by scalar\n");
+
+    vec3_cp(b, c);
+    vec3_scale(c, a);
+}
+
+///////////////////////////////////////////////////////////////////////
+////////////////////////////  ROTATE  /////////////////////////////////
+///////////////////////////////////////////////////////////////////////
+
+void
+calc_rotate_vector_matrix_matrix(vec3_t a, mat4x4_t b, mat4x4_t c)
+{
+    mat4x4_t tmp;
+    real angle;
+
+    explain(">>> rotating matrix B by vector A\n");
+    explain(">>> NOTE: rotating in parts: value X on the X axis, then Y on the Y axis, then Z on the Z axis\n");
+    explain(">>> using degrees for input and placing radians in the matrix\n");
+
+    mat4x4_copy(b, c);
+
+#define M1(row,col) tmp[col * 4 + row]
+    if (a[X] != 0.0) {
+	mat4x4_id(tmp);
+	angle = a[X] * DEG2RAD;
+	M1(1,1) = cos(angle);
+	M1(1,2) = -1.0 * sin(angle);
+	M1(2,1) = sin(angle);
+	M1(2,2) = cos(angle);
+    	mat4x4_mult(c, tmp, c);
+    }
+    if (a[Y] != 0.0) {
+	mat4x4_id(tmp);
+	angle = a[Y] * DEG2RAD;
+	M1(0,0) = cos(angle);
+	M1(0,2) = sin(angle);
+	M1(2,0) = -1.0 * sin(angle);
+	M1(2,2) = cos(angle);
+    	mat4x4_mult(c, tmp, c);
+    }
+    if (a[Z] != 0.0) {
+	mat4x4_id(tmp);
+	angle = a[Z] * DEG2RAD;
+	M1(0,0) = cos(angle);
+	M1(0,1) = -1.0 * sin(angle);
+	M1(1,0) = sin(angle);
+	M1(1,1) = cos(angle);
+    	mat4x4_mult(c, tmp, c);
+    }
+#undef M1
+}
+
+void
+calc_rotate_vector_quat_quat(vec3_t a, quat_t b, quat_t c)
+{
+    quat_cp(b, c);
+
+    quat_set3(c, a[X], a[Y], a[Z]);
+}
+
+///////////////////////////////////////////////////////////////////////
+/////////////////////////////  SWAP  //////////////////////////////////
+///////////////////////////////////////////////////////////////////////
+
+void
+calc_swap_matrix_matrix(mat4x4_t a, mat4x4_t b)
+{
+    mat4x4_t c;
+
+    explain(">>> swapping values of matrix a & matrix b\n");
+
+    mat4x4_copy(a, c);
+    mat4x4_copy(b, a);
+    mat4x4_copy(c, b);
+}
+
+void
+calc_swap_vector_vector(vec3_t a, vec3_t b)
+{
+    vec3_t c;
+
+    explain(">>> swapping values of vector a & vector b\n");
+
+    vec3_cp(a, c);
+    vec3_cp(b, a);
+    vec3_cp(c, b);
+}
+
+void
+calc_swap_quat_quat(quat_t a, quat_t b)
+{
+    quat_t c;
+
+    explain(">>> swapping values of quaternion a & quaternion b\n");
+
+    quat_cp(a, c);
+    quat_cp(b, a);
+    quat_cp(c, b);
+}
+
+///////////////////////////////////////////////////////////////////////
+///////////////////////////  TRANSFORM  ///////////////////////////////
+///////////////////////////////////////////////////////////////////////
+
+void
+calc_transform_matrix_vector_vector(mat4x4_t a, vec3_t b, vec3_t c)
+{
+    explain(">>> transforming vector b by matrix a\n");
+
+    vec3_cp(b, c);
+
+// does not apply translation
+//    transform_point(cc, a, bb);
+
+    vec3_transform((vec3_t *) c, 1, a);
+}
+
+///////////////////////////////////////////////////////////////////////
+/////////////////////////  OPERATION TABLE  ///////////////////////////
+///////////////////////////////////////////////////////////////////////
+
+/*
+ * Adapters from the generic operand form to the typed functions above,
+ * the arguments are the operand members each function takes.
+ */
+#define CALC_OP(func, ma, mb, mc)					\
+    static void								\
+    func##_op(operand_t *a, operand_t *b, operand_t *c)			\
+    {									\
+	calc_##func(ma, mb, mc);					\
+    }
+
+#define CALC_SWAP_OP(func, ma, mb)					\
+    static void								\
+    func##_op(operand_t *a, operand_t *b, operand_t *c)			\
+    {									\
+	calc_##func(ma, mb);						\
+    }
+
+CALC_OP(add_vector_vector_vector,		a->u.v, b->u.v, c->u.v)
+CALC_OP(add_quat_quat_quat,			a->u.q, b->u.q, c->u.q)
+CALC_OP(subtract_vector_vector_vector,		a->u.v, b->u.v, c->u.v)
+CALC_OP(subtract_quat_quat_quat,		a->u.q, b->u.q, c->u.q)
+CALC_OP(dot_vector_vector_scalar,		a->u.v, b->u.v, &c->u.s)
+CALC_OP(cross_vector_vector_vector,		a->u.v, b->u.v, c->u.v)
+CALC_OP(angle_vector_vector_scalar,		a->u.v, b->u.v, &c->u.s)
+CALC_OP(multiply_matrix_matrix_matrix,		a->u.m, b->u.m, c->u.m)
+CALC_OP(multiply_scalar_vector_vector,		a->u.s, b->u.v, c->u.v)
+CALC_OP(multiply_vector_vector_vector,		a->u.v, b->u.v, c->u.v)
+CALC_OP(multiply_quat_quat_quat,		a->u.q, b->u.q, c->u.q)
+CALC_OP(divide_vector_vector_vector,		a->u.v, b->u.v, c->u.v)
+CALC_OP(divide_scalar_vector_vector,		a->u.s, b->u.v, c->u.v)
+CALC_OP(translate_vector_matrix_matrix,		a->u.v, b->u.m, c->u.m)
+CALC_OP(scale_scalar_matrix_matrix,		a->u.s, b->u.m, c->u.m)
+CALC_OP(scale_scalar_vector_vector,		a->u.s, b->u.v, c->u.v)
+CALC_OP(rotate_vector_matrix_matrix,		a->u.v, b->u.m, c->u.m)
+CALC_OP(rotate_vector_quat_quat,		a->u.v, b->u.q, c->u.q)
+CALC_SWAP_OP(swap_matrix_matrix,		a->u.m, b->u.m)
+CALC_SWAP_OP(swap_vector_vector,		a->u.v, b->u.v)
+CALC_SWAP_OP(swap_quat_quat,			a->u.q, b->u.q)
+CALC_OP(transform_matrix_vector_vector,		a->u.m, b->u.v, c->u.v)
+
+#undef CALC_OP
+#undef CALC_SWAP_OP
+
+#define OM OPERAND_MATRIX
+#define OV OPERAND_VECTOR
+#define OQ OPERAND_QUAT
+#define OS OPERAND_SCALAR
+#define ON OPERAND_NONE
+
+static const calc_op_t calc_ops[] = {
+    { "add",       OV, OV, OV, add_vector_vector_vector_op },
+    { "add",       OQ, OQ, OQ, add_quat_quat_quat_op },
+    { "subtract",  OV, OV, OV, subtract_vector_vector_vector_op },
+    { "subtract",  OQ, OQ, OQ, subtract_quat_quat_quat_op },
+    { "dot",       OV, OV, OS, dot_vector_vector_scalar_op },
+    { "cross",     OV, OV, OV, cross_vector_vector_vector_op },
+    { "angle",     OV, OV, OS, angle_vector_vector_scalar_op },
+    { "multiply",  OM, OM, OM, multiply_matrix_matrix_matrix_op },
+    { "multiply",  OS, OV, OV, multiply_scalar_vector_vector_op },
+    { "multiply",  OV, OV, OV, multiply_vector_vector_vector_op },
+    { "multiply",  OQ, OQ, OQ, multiply_quat_quat_quat_op },
+    { "divide",    OV, OV, OV, divide_vector_vector_vector_op },
+    { "divide",    OS, OV, OV, divide_scalar_vector_vector_op },
+    { "translate", OV, OM, OM, translate_vector_matrix_matrix_op },
+    { "scale",     OS, OM, OM, scale_scalar_matrix_matrix_op },
+    { "scale",     OS, OV, OV, scale_scalar_vector_vector_op },
+    { "rotate",    OV, OM, OM, rotate_vector_matrix_matrix_op },
+    { "rotate",    OV, OQ, OQ, rotate_vector_quat_quat_op },
+    { "swap",      OM, OM, ON, swap_matrix_matrix_op },
+    { "swap",      OV, OV, ON, swap_vector_vector_op },
+    { "swap",      OQ, OQ, ON, swap_quat_quat_op },
+    { "transform", OM, OV, OV, transform_matrix_vector_vector_op },
+};
+
+#undef OM
+#undef OV
+#undef OQ
+#undef OS
+#undef ON
+
+/*
+ * Look up the operation the button 'name' performs on operands of type
+ * a and b, the same pairing the notebook pages select in the GUI.
+ * Returns NULL if there is none.
+ */
+const calc_op_t *
+calc_op_find(const char *name, operand_type_t a, operand_type_t b)
+{
+    int i;
+
+    for (i = 0; i < (int) G_N_ELEMENTS(calc_ops); i++) {
+	if (calc_ops[i].a == a && calc_ops[i].b == b &&
+		strcmp(calc_ops[i].name, name) == 0)
+	    return &calc_ops[i];
+    }
+
+    return NULL;
+}
+
+/* number of reals making up an operand */
+int
+calc_operand_size(operand_type_t type)
+{
+    switch (type) {
+	case OPERAND_MATRIX:
+	    return 16;
+	case OPERAND_VECTOR:
+	    return 3;
+	case OPERAND_QUAT:
+	    return 4;
+	case OPERAND_SCALAR:
+	    return 1;
+	default:
+	    return 0;
+    }
+}
@@ -0,0 +1,109 @@
+/*
+ *  Name: calc.h
+ *  Description: Calculator operations shared by the GUI and batch mode
+ *
+ *  Copyright (C) 2012  Jason Hall
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CALC_H
+#define CALC_H
+
+#include "mathlib.h"
+
+/*
+ * The operations take their operands by value and write the result
+ * into c, they never touch a widget. Both the GTK callbacks and the
+ * headless batch mode (mvqcalc --batch) are thin wrappers around them.
+ *
+ * The step by step explanation of the math goes through calc_explain.
+ * It is NULL by default, in which case no explanation text is formatted
+ * at all. Every thread has its own, so what the GUI sets does not reach
+ * the operations background jobs run (see jobs.h).
+ */
+
+typedef void (*calc_explain_func_t)(const char *fmt, ...);
+
+extern __thread calc_explain_func_t calc_explain;
+
+typedef enum {
+    OPERAND_NONE = 0,
+    OPERAND_MATRIX,
+    OPERAND_VECTOR,
+    OPERAND_QUAT,
+    OPERAND_SCALAR
+} operand_type_t;
+
+typedef struct {
+    operand_type_t type;
+    union {
+	mat4x4_t m;
+	vec3_t v;
+	quat_t q;
+	real s;
+    } u;
+} operand_t;
+
+/*
+ * One entry per button and operand combination. Operations without a
+ * result (swap) have c set to OPERAND_NONE and update a and b instead.
+ */
+typedef struct {
+    const char *name;
+    operand_type_t a, b, c;
+    void (*func)(operand_t *a, operand_t *b, operand_t *c);
+} calc_op_t;
+
+const calc_op_t *calc_op_find(const char *name, operand_type_t a,
+	operand_type_t b);
+int calc_operand_size(operand_type_t type);
+
+void calc_add_vector_vector_vector(vec3_t a, vec3_t b, vec3_t c);
+void calc_add_quat_quat_quat(quat_t a, quat_t b, quat_t c);
+void calc_subtract_vector_vector_vector(vec3_t a, vec3_t b, vec3_t c);
+void calc_subtract_quat_quat_quat(quat_t a, quat_t b, quat_t c);
+void calc_dot_vector_vector_scalar(vec3_t a, vec3_t b, real *c);
+void calc_cross_vector_vector_vector(vec3_t a, vec3_t b, vec3_t c);
+void calc_angle_vector_vector_scalar(vec3_t a, vec3_t b, real *c);
+void calc_multiply_matrix_matrix_matrix(mat4x4_t a, mat4x4_t b, mat4x4_t c);
+void calc_multiply_scalar_vector_vector(real a, vec3_t b, vec3_t c);
+void calc_multiply_vector_vector_vector(vec3_t a, vec3_t b, vec3_t c);
+void calc_multiply_quat_quat_quat(quat_t a, quat_t b, quat_t c);
+void calc_divide_vector_vector_vector(vec3_t a, vec3_t b, vec3_t c);
+void calc_divide_scalar_vector_vector(real a, vec3_t b, vec3_t c);
+void calc_translate_vector_matrix_matrix(vec3_t a, mat4x4_t b, mat4x4_t c);
+void calc_scale_scalar_matrix_matrix(real a, mat4x4_t b, mat4x4_t c);
+void calc_scale_scalar_vector_vector(real a, vec3_t b, vec3_t c);
+void calc_rotate_vector_matrix_matrix(vec3_t a, mat4x4_t b, mat4x4_t c);
+void calc_rotate_vector_quat_quat(vec3_t a, quat_t b, quat_t c);
+void calc_swap_matrix_matrix(mat4x4_t a, mat4x4_t b);
+void calc_swap_vector_vector(vec3_t a, vec3_t b);
+void calc_swap_quat_quat(quat_t a, quat_t b);
+void calc_transform_matrix_vector_vector(mat4x4_t a, vec3_t b, vec3_t c);
+
+/* batch.c */
+typedef struct {
+    long lines;
+    long errors;
+    gboolean cancelled;		// stopped part way through writing the output
+} batch_stats_t;
+
+typedef gboolean (*batch_progress_func_t)(double fraction, void *data);
+
+int batch_main(int argc, char **argv);
+gboolean batch_run_file(const char *in_path, const char *out_path,
+	batch_progress_func_t progress, void *data, batch_stats_t *stats);
+
+#endif /* CALC_H */
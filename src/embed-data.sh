@@ -0,0 +1,29 @@
+#!/bin/sh
+#
+# embed-data.sh FILE... > embedded_data.h
+#
+# Writes the files as C arrays, for --enable-embedded-data. Each array
+# gets a trailing nul, so text files can be used as strings, which is not
+# counted in the size. mvqcalc.c defines embedded_file_t.
+
+echo "/* generated by embed-data.sh, do not edit */"
+
+for file
+do
+    name=`basename "$file" | sed 's/[^A-Za-z0-9]/_/g'`
+    echo
+    echo "static const char embedded_$name[] = {"
+    od -An -v -tx1 "$file" | sed -e 's/ \([0-9a-f][0-9a-f]\)/ 0x\1,/g' -e 's/^ */    /'
+    echo "    0x00"
+    echo "};"
+done
+
+echo
+echo "static const embedded_file_t embedded_files[] = {"
+for file
+do
+    base=`basename "$file"`
+    name=`echo "$base" | sed 's/[^A-Za-z0-9]/_/g'`
+    echo "    { \"$base\", embedded_$name, sizeof(embedded_$name) - 1 },"
+done
+echo "};"
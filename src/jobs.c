@@ -0,0 +1,225 @@
+/*
+ *  Name: jobs.c
+ *  Description: Background jobs for the GUI
+ *
+ *  Copyright (C) 2012  Jason Hall
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Jobs run on a GThreadPool. Workers hand progress and completion back
+ * to the main loop through a lock free stack of events: pushing is one
+ * compare and swap, and the main loop takes the whole stack at once, so
+ * neither side ever waits for the other. Whoever pushes onto an empty
+ * stack adds an idle source to drain it.
+ *
+ * Each job embeds its two events, so posting never allocates. A progress
+ * event stays posted until the main loop has seen it, a worker reporting
+ * faster than that only updates the fraction.
+ */
+
+#include <stdlib.h>
+
+/* sysconf() */
+#include <unistd.h>
+
+#include "jobs.h"
+
+/* fractions are passed between threads in these units */
+#define JOB_PROGRESS_SCALE	10000
+
+typedef enum {
+    JOB_EVENT_PROGRESS,
+    JOB_EVENT_DONE
+} job_event_type_t;
+
+typedef struct job_event {
+    struct job_event *next;
+    job_event_type_t type;
+    job_t *job;
+} job_event_t;
+
+struct job {
+    job_run_func_t run;
+    job_progress_func_t progress;
+    job_done_func_t done;
+    gpointer data;
+
+    volatile gint cancelled;
+    volatile gint fraction;		// JOB_PROGRESS_SCALE units
+    volatile gint progress_posted;
+
+    job_event_t progress_event;
+    job_event_t done_event;
+};
+
+static GThreadPool *job_pool;
+static int job_threads;
+static GSList *job_list;		// submitted and not done, main loop only
+
+// posted events, newest first
+static gpointer volatile job_events;
+
+static gboolean
+jobs_drain(gpointer data)
+{
+    job_event_t *list, *ev, *next, *fifo = NULL;
+    job_t *job;
+
+    do {
+	list = g_atomic_pointer_get(&job_events);
+    } while (!g_atomic_pointer_compare_and_exchange(&job_events, list, NULL));
+
+    // back into the order they were posted in
+    for (ev = list; ev != NULL; ev = next) {
+	next = ev->next;
+	ev->next = fifo;
+	fifo = ev;
+    }
+
+    for (ev = fifo; ev != NULL; ev = next) {
+	next = ev->next;
+	job = ev->job;
+
+	switch (ev->type) {
+	case JOB_EVENT_PROGRESS:
+	    // from here on a new fraction posts again
+	    g_atomic_int_set(&job->progress_posted, 0);
+	    if (job->progress != NULL)
+		job->progress(job,
+			(double) g_atomic_int_get(&job->fraction) / JOB_PROGRESS_SCALE,
+			job->data);
+	    break;
+	case JOB_EVENT_DONE:
+	    // a job posts its last progress before it is done, so nothing
+	    // later in the list refers to it
+	    job_list = g_slist_remove(job_list, job);
+	    if (job->done != NULL)
+		job->done(job, g_atomic_int_get(&job->cancelled), job->data);
+	    g_free(job);
+	    break;
+	}
+    }
+
+    return FALSE;
+}
+
+static void
+job_post(job_event_t *ev)
+{
+    gpointer head;
+
+    do {
+	head = g_atomic_pointer_get(&job_events);
+	ev->next = head;
+    } while (!g_atomic_pointer_compare_and_exchange(&job_events, head, ev));
+
+    if (head == NULL)
+	g_idle_add(jobs_drain, NULL);
+}
+
+static void
+job_worker(gpointer data, gpointer user_data)
+{
+    job_t *job = data;
+
+    if (!g_atomic_int_get(&job->cancelled))
+	job->run(job, job->data);
+
+    job_post(&job->done_event);
+}
+
+void
+jobs_set_threads(int threads)
+{
+    job_threads = threads;
+}
+
+/* jobs submitted and not done yet */
+int
+jobs_running(void)
+{
+    return g_slist_length(job_list);
+}
+
+/* called from the main loop */
+job_t *
+job_submit(job_run_func_t run, job_progress_func_t progress,
+	job_done_func_t done, gpointer data)
+{
+    job_t *job;
+
+    if (job_pool == NULL) {
+	if (job_threads <= 0)
+	    job_threads = sysconf(_SC_NPROCESSORS_ONLN);
+	if (job_threads <= 0)
+	    job_threads = 1;
+	job_pool = g_thread_pool_new(job_worker, NULL, job_threads, FALSE, NULL);
+    }
+
+    job = g_new0(job_t, 1);
+    job->run = run;
+    job->progress = progress;
+    job->done = done;
+    job->data = data;
+    job->progress_event.type = JOB_EVENT_PROGRESS;
+    job->progress_event.job = job;
+    job->done_event.type = JOB_EVENT_DONE;
+    job->done_event.job = job;
+
+    job_list = g_slist_prepend(job_list, job);
+    g_thread_pool_push(job_pool, job, NULL);
+
+    return job;
+}
+
+/*
+ * Ask the job to stop. One that hasn't started yet never runs, a running
+ * one stops when it next checks job_cancelled(). Either way the done
+ * callback is still called, with cancelled set.
+ */
+void
+job_cancel(job_t *job)
+{
+    g_atomic_int_set(&job->cancelled, 1);
+}
+
+/* cancel every job and run the main loop until their done callbacks have run */
+void
+jobs_cancel_all(void)
+{
+    GSList *item;
+
+    for (item = job_list; item; item = item->next)
+	job_cancel(item->data);
+
+    while (job_list != NULL)
+	g_main_context_iteration(NULL, TRUE);
+}
+
+gboolean
+job_cancelled(job_t *job)
+{
+    return g_atomic_int_get(&job->cancelled);
+}
+
+void
+job_set_progress(job_t *job, double fraction)
+{
+    g_atomic_int_set(&job->fraction, CLAMP(fraction, 0.0, 1.0) * JOB_PROGRESS_SCALE);
+
+    if (g_atomic_int_compare_and_exchange(&job->progress_posted, 0, 1))
+	job_post(&job->progress_event);
+}
@@ -0,0 +1,51 @@
+/*
+ *  Name: jobs.h
+ *  Description: Background jobs for the GUI
+ *
+ *  Copyright (C) 2012  Jason Hall
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef JOBS_H
+#define JOBS_H
+
+#include <glib.h>
+
+/*
+ * A job runs on a worker thread, its progress and done callbacks are
+ * called later from the main loop, so they may touch widgets and the
+ * run function must not. A job is freed after its done callback has
+ * returned, job_cancel() must not be used on it after that.
+ */
+typedef struct job job_t;
+
+typedef void (*job_run_func_t)(job_t *job, gpointer data);
+typedef void (*job_progress_func_t)(job_t *job, double fraction, gpointer data);
+typedef void (*job_done_func_t)(job_t *job, gboolean cancelled, gpointer data);
+
+/* 0 uses one thread per cpu, must be called before the first job */
+void jobs_set_threads(int threads);
+int jobs_running(void);
+
+job_t *job_submit(job_run_func_t run, job_progress_func_t progress,
+	job_done_func_t done, gpointer data);
+void job_cancel(job_t *job);
+void jobs_cancel_all(void);
+
+/* for the run function */
+gboolean job_cancelled(job_t *job);
+void job_set_progress(job_t *job, double fraction);
+
+#endif /* JOBS_H */
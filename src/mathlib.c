@@ -23,30 +23,88 @@
 #include <math.h>
 
 #include "mathlib.h"
+#include "mathlib_simd.h"
+
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
 
 #undef QUAT_ABORT_ON_NAN
 
+/*
+ * reciprocal square root estimate. This is the same instruction the
+ * batched kernels use, so NORM_FAST gives the same results either way.
+ */
+static float
+rsqrt_estimate(float x)
+{
+#ifdef __SSE__
+    return _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(x)));
+#else
+    // bit trick plus a newton step, good to about 2e-3
+    union { float f; uint32_t i; } u;
+    float y;
+
+    u.f = x;
+    u.i = 0x5f3759df - (u.i >> 1);
+    y = u.f;
+    return y * (1.5f - (0.5f * x * y) * y);
+#endif
+}
+
+/* 1/sqrt(x) for NORM_FAST, the estimate refined with one newton step */
+static real
+rsqrt_newton(real x)
+{
+    const real half = 0.5, threehalfs = 1.5;
+    real y = rsqrt_estimate(x);
+
+    return y * (threehalfs - (half * x * y) * y);
+}
+
 /******************************************************************************
  *
  * Quaternion Functions
  *
  *****************************************************************************/
+/* from the arena if there is one, from the heap otherwise */
+static void *
+arena_or_heap_alloc(mathlib_arena_t *arena, size_t size)
+{
+    if (arena != NULL)
+	return mathlib_arena_alloc(arena, size);
+    return g_malloc(size);
+}
+
 quat_t *
 quat_new(real x, real y, real z, real w)
 {
-    quat_t *q;
+    return quat_new_arena(NULL, x, y, z, w);
+}
 
-    q = malloc(sizeof(quat_t));
-    memset(q, 0, sizeof(quat_t));
+/*
+ * a new quaternion from arena, or from the heap if arena is NULL. Only
+ * the heap ones may be passed to quat_destroy().
+ */
+quat_t *
+quat_new_arena(mathlib_arena_t *arena, real x, real y, real z, real w)
+{
+    quat_t *q = arena_or_heap_alloc(arena, sizeof(quat_t));
 
-    *q[X] = x;
-    *q[Y] = y;
-    *q[Z] = z;
-    *q[W] = w;
+    (*q)[X] = x;
+    (*q)[Y] = y;
+    (*q)[Z] = z;
+    (*q)[W] = w;
 
     return q;
 }
 
+void
+quat_destroy(quat_t *q)
+{
+    g_free(q);
+}
+
 void
 quat_id(quat_t q)
 {
@@ -65,6 +123,13 @@ quat_cp(quat_t src, quat_t dst)
     dst[W] = src[W];
 }
 
+/*
+ * rotate by x, then y, then z degrees. Kept as the product of quat_set4()
+ * rotations, skipping zero angles, so what the calculator shows doesn't
+ * change: no rotation is exactly the identity and one around a single
+ * axis is exactly that quat_set4(). quat_set_euler() with EULER_XYZ is
+ * the same rotation to a few ulp and much faster.
+ */
 void
 quat_set3(quat_t q, real x, real y, real z)
 {
@@ -86,6 +151,38 @@ quat_set3(quat_t q, real x, real y, real z)
     }
 }
 
+/*
+ * the rotation by x, y and z degrees around the x, y and z axes, applied
+ * in the given order. This is the product of the three quat_set4()
+ * rotations worked out by hand, so it needs one sincos per angle and a
+ * handful of multiplies instead of three quat_mult() calls.
+ */
+void
+quat_set_euler(quat_t q, real x, real y, real z, euler_order_t order)
+{
+    const real to_half_rad = G_PI / 360.0;
+    const int8_t *axes = euler_axes[order];
+    vec3_t sn, cs;
+    real ccb, scb, csb, ssb;
+    int a = axes[0], b = axes[1], c = axes[2];
+
+    real_sincos(x * to_half_rad, &sn[X], &cs[X]);
+    real_sincos(y * to_half_rad, &sn[Y], &cs[Y]);
+    real_sincos(z * to_half_rad, &sn[Z], &cs[Z]);
+
+    // the terms made of the last two rotations, the sign of the cross
+    // terms depends on the handedness of the order
+    ccb = cs[c] * cs[b];
+    scb = sn[c] * cs[b];
+    csb = cs[c] * sn[b];
+    ssb = sn[c] * sn[b];
+
+    q[W] = ccb * cs[a] + (axes[3] ? ssb : -ssb) * sn[a];
+    q[a] = ccb * sn[a] - (axes[3] ? ssb : -ssb) * cs[a];
+    q[b] = csb * cs[a] + (axes[3] ? scb : -scb) * sn[a];
+    q[c] = scb * cs[a] - (axes[3] ? csb : -csb) * sn[a];
+}
+
 #define quat_set4_optimized  quat_set4
 void
 quat_set4_optimized(quat_t q, real x, real y, real z, real angle)
@@ -183,12 +280,15 @@ quat_norm(quat_t q)
 
 #ifdef QUAT_ABORT_ON_NAN
     g_assert(factor != 0.0);
-    scale = 1.0 / sqrt(factor);
+    scale = sqrt(factor);
+    scale = 1.0 / scale;
 #else
-    if (factor == 0.0)
+    if (factor == 0.0) {
 	scale = NAN;
-    else
-    	scale = 1.0 / sqrt(factor);
+    } else {
+	scale = sqrt(factor);
+	scale = 1.0 / scale;
+    }
 #endif
 
     q[X] *= scale;
@@ -197,6 +297,29 @@ quat_norm(quat_t q)
     q[W] *= scale;
 }
 
+/* normalize q, see norm_mode_t for the modes and their accuracy */
+void
+quat_norm_mode(quat_t q, norm_mode_t mode)
+{
+    const real one = 1.0, eps = NORM_LAZY_EPSILON;
+    real factor, scale;
+
+    if (mode == NORM_EXACT) {
+	quat_norm(q);
+	return;
+    }
+
+    factor = q[W]*q[W] + q[X]*q[X] + q[Y]*q[Y] + q[Z]*q[Z];
+    if (mode == NORM_LAZY && fabs(factor - one) <= eps)
+	return;
+
+    scale = rsqrt_newton(factor);
+    q[X] *= scale;
+    q[Y] *= scale;
+    q[Z] *= scale;
+    q[W] *= scale;
+}
+
 void
 quat_inv(quat_t q)
 {
@@ -324,7 +447,14 @@ quat_to_vecs(quat_t q, vec3_t dir, vec3_t up, vec3_t right)
 vec3_t *
 vec3_new(real x, real y, real z)
 {
-    vec3_t *v = g_malloc(sizeof(vec3_t));
+    return vec3_new_arena(NULL, x, y, z);
+}
+
+/* see quat_new_arena() */
+vec3_t *
+vec3_new_arena(mathlib_arena_t *arena, real x, real y, real z)
+{
+    vec3_t *v = arena_or_heap_alloc(arena, sizeof(vec3_t));
 
     vec3_set(*v, x, y, z);
 
@@ -354,6 +484,26 @@ vec3_norm(vec3_t v)
     vec3_div(v, mag);
 }
 
+/* normalize v, see norm_mode_t for the modes and their accuracy */
+void
+vec3_norm_mode(vec3_t v, norm_mode_t mode)
+{
+    const real one = 1.0, eps = NORM_LAZY_EPSILON;
+    real len2, scale;
+
+    if (mode == NORM_EXACT) {
+	vec3_norm(v);
+	return;
+    }
+
+    len2 = vec3_dot(v, v);
+    if (mode == NORM_LAZY && fabs(len2 - one) <= eps)
+	return;
+
+    scale = rsqrt_newton(len2);
+    vec3_scale(v, scale);
+}
+
 /* transform vectors by a matrix */
 void
 vec3_transform(vec3_t *v, int n, mat4x4_t m)
@@ -446,13 +596,25 @@ project(vec3_t obj, mat4x4_t model, mat4x4_t proj, int32_t viewport[4],
 mat4x4_t *
 mat4x4_new(void)
 {
-    mat4x4_t *m;
-    m = malloc(sizeof(mat4x4_t));
-    memset(m, 0, sizeof(mat4x4_t));
+    return mat4x4_new_arena(NULL);
+}
+
+/* a new identity matrix, see quat_new_arena() */
+mat4x4_t *
+mat4x4_new_arena(mathlib_arena_t *arena)
+{
+    mat4x4_t *m = arena_or_heap_alloc(arena, sizeof(mat4x4_t));
+
     mat4x4_id(*m);
     return m;
 }
 
+void
+mat4x4_destroy(mat4x4_t *m)
+{
+    g_free(m);
+}
+
 void
 mat4x4_zero(mat4x4_t m)
 {
@@ -517,3 +679,352 @@ mat4x4_copy(mat4x4_t src, mat4x4_t dest)
     for (i = 0; i < 16; i++)
 	dest[i] = src[i];
 }
+
+
+/*
+ * general inverse, built from the 2x2 determinants of the top two rows
+ * (s0-s5) and of the bottom two rows (c0-c5). Returns FALSE and leaves
+ * dest alone if m is singular, or so close to it that the inverse would
+ * be mostly rounding error (see MAT4X4_SINGULAR_EPSILON). dest may be m.
+ */
+#define D(row,col)  tmp[(col<<2)+row]
+gboolean
+mat4x4_inv(mat4x4_t m, mat4x4_t dest)
+{
+    real s0, s1, s2, s3, s4, s5;
+    real c0, c1, c2, c3, c4, c5;
+    real det, inv, bound;
+    mat4x4_t tmp;
+
+    s0 = M(0, 0) * M(1, 1) - M(1, 0) * M(0, 1);
+    s1 = M(0, 0) * M(1, 2) - M(1, 0) * M(0, 2);
+    s2 = M(0, 0) * M(1, 3) - M(1, 0) * M(0, 3);
+    s3 = M(0, 1) * M(1, 2) - M(1, 1) * M(0, 2);
+    s4 = M(0, 1) * M(1, 3) - M(1, 1) * M(0, 3);
+    s5 = M(0, 2) * M(1, 3) - M(1, 2) * M(0, 3);
+
+    c5 = M(2, 2) * M(3, 3) - M(3, 2) * M(2, 3);
+    c4 = M(2, 1) * M(3, 3) - M(3, 1) * M(2, 3);
+    c3 = M(2, 1) * M(3, 2) - M(3, 1) * M(2, 2);
+    c2 = M(2, 0) * M(3, 3) - M(3, 0) * M(2, 3);
+    c1 = M(2, 0) * M(3, 2) - M(3, 0) * M(2, 2);
+    c0 = M(2, 0) * M(3, 1) - M(3, 0) * M(2, 1);
+
+    det = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+
+    // zero to within rounding, see MAT4X4_SINGULAR_EPSILON
+    bound = (fabs(M(0, 0)) + fabs(M(0, 1)) + fabs(M(0, 2)) + fabs(M(0, 3))) *
+	    (fabs(M(1, 0)) + fabs(M(1, 1)) + fabs(M(1, 2)) + fabs(M(1, 3)));
+    bound *= (fabs(M(2, 0)) + fabs(M(2, 1)) + fabs(M(2, 2)) + fabs(M(2, 3))) *
+	     (fabs(M(3, 0)) + fabs(M(3, 1)) + fabs(M(3, 2)) + fabs(M(3, 3)));
+    if (!(fabs(det) > bound * MAT4X4_SINGULAR_EPSILON))
+	return FALSE;
+
+    inv = 1.0 / det;
+
+    D(0, 0) =  (M(1, 1) * c5 - M(1, 2) * c4 + M(1, 3) * c3) * inv;
+    D(0, 1) = -(M(0, 1) * c5 - M(0, 2) * c4 + M(0, 3) * c3) * inv;
+    D(0, 2) =  (M(3, 1) * s5 - M(3, 2) * s4 + M(3, 3) * s3) * inv;
+    D(0, 3) = -(M(2, 1) * s5 - M(2, 2) * s4 + M(2, 3) * s3) * inv;
+
+    D(1, 0) = -(M(1, 0) * c5 - M(1, 2) * c2 + M(1, 3) * c1) * inv;
+    D(1, 1) =  (M(0, 0) * c5 - M(0, 2) * c2 + M(0, 3) * c1) * inv;
+    D(1, 2) = -(M(3, 0) * s5 - M(3, 2) * s2 + M(3, 3) * s1) * inv;
+    D(1, 3) =  (M(2, 0) * s5 - M(2, 2) * s2 + M(2, 3) * s1) * inv;
+
+    D(2, 0) =  (M(1, 0) * c4 - M(1, 1) * c2 + M(1, 3) * c0) * inv;
+    D(2, 1) = -(M(0, 0) * c4 - M(0, 1) * c2 + M(0, 3) * c0) * inv;
+    D(2, 2) =  (M(3, 0) * s4 - M(3, 1) * s2 + M(3, 3) * s0) * inv;
+    D(2, 3) = -(M(2, 0) * s4 - M(2, 1) * s2 + M(2, 3) * s0) * inv;
+
+    D(3, 0) = -(M(1, 0) * c3 - M(1, 1) * c1 + M(1, 2) * c0) * inv;
+    D(3, 1) =  (M(0, 0) * c3 - M(0, 1) * c1 + M(0, 2) * c0) * inv;
+    D(3, 2) = -(M(3, 0) * s3 - M(3, 1) * s1 + M(3, 2) * s0) * inv;
+    D(3, 3) =  (M(2, 0) * s3 - M(2, 1) * s1 + M(2, 2) * s0) * inv;
+
+    mat4x4_copy(tmp, dest);
+
+    return TRUE;
+}
+
+/*
+ * inverse of a matrix that only rotates and translates, much cheaper
+ * than mat4x4_inv(): the rotation is transposed and the translation is
+ * rotated back and negated. Any scale or shear in m gives a wrong
+ * result, use mat4x4_inv() for those. dest may be m.
+ */
+void
+mat4x4_inv_affine(mat4x4_t m, mat4x4_t dest)
+{
+    mat4x4_t tmp;
+
+    D(0, 0) = M(0, 0); D(0, 1) = M(1, 0); D(0, 2) = M(2, 0);
+    D(1, 0) = M(0, 1); D(1, 1) = M(1, 1); D(1, 2) = M(2, 1);
+    D(2, 0) = M(0, 2); D(2, 1) = M(1, 2); D(2, 2) = M(2, 2);
+
+    D(0, 3) = -(D(0, 0) * M(0, 3) + D(0, 1) * M(1, 3) + D(0, 2) * M(2, 3));
+    D(1, 3) = -(D(1, 0) * M(0, 3) + D(1, 1) * M(1, 3) + D(1, 2) * M(2, 3));
+    D(2, 3) = -(D(2, 0) * M(0, 3) + D(2, 1) * M(1, 3) + D(2, 2) * M(2, 3));
+
+    D(3, 0) = 0.0; D(3, 1) = 0.0; D(3, 2) = 0.0; D(3, 3) = 1.0;
+
+    mat4x4_copy(tmp, dest);
+}
+#undef D
+
+/*
+ * the inverse of quat_to_mat(), the upper 3x3 of m must be a pure
+ * rotation. The quaternion is built around its largest component
+ * (Shepperd's method) so the divisor never gets close to zero, and
+ * w is made positive so the same rotation always gives the same
+ * quaternion.
+ */
+void
+mat4x4_to_quat(mat4x4_t m, quat_t q)
+{
+    const real one = 1.0, half = 0.5;
+    real tw, tx, ty, tz, r, s;
+
+    tw = one + M(0, 0) + M(1, 1) + M(2, 2);	// 4w^2
+    tx = one + M(0, 0) - M(1, 1) - M(2, 2);	// 4x^2
+    ty = one - M(0, 0) + M(1, 1) - M(2, 2);	// 4y^2
+    tz = one - M(0, 0) - M(1, 1) + M(2, 2);	// 4z^2
+
+    if (tw >= tx && tw >= ty && tw >= tz) {
+	r = sqrt(tw);
+	s = half / r;
+	q[X] = (M(2, 1) - M(1, 2)) * s;
+	q[Y] = (M(0, 2) - M(2, 0)) * s;
+	q[Z] = (M(1, 0) - M(0, 1)) * s;
+	q[W] = tw * s;
+    } else if (tx >= ty && tx >= tz) {
+	r = sqrt(tx);
+	s = half / r;
+	q[X] = tx * s;
+	q[Y] = (M(1, 0) + M(0, 1)) * s;
+	q[Z] = (M(0, 2) + M(2, 0)) * s;
+	q[W] = (M(2, 1) - M(1, 2)) * s;
+    } else if (ty >= tz) {
+	r = sqrt(ty);
+	s = half / r;
+	q[X] = (M(1, 0) + M(0, 1)) * s;
+	q[Y] = ty * s;
+	q[Z] = (M(2, 1) + M(1, 2)) * s;
+	q[W] = (M(0, 2) - M(2, 0)) * s;
+    } else {
+	r = sqrt(tz);
+	s = half / r;
+	q[X] = (M(0, 2) + M(2, 0)) * s;
+	q[Y] = (M(2, 1) + M(1, 2)) * s;
+	q[Z] = tz * s;
+	q[W] = (M(1, 0) - M(0, 1)) * s;
+    }
+
+    if (signbit(q[W])) {
+	q[X] = -q[X];
+	q[Y] = -q[Y];
+	q[Z] = -q[Z];
+	q[W] = -q[W];
+    }
+}
+
+#ifndef MATHLIB_FLOAT
+/******************************************************************************
+ *
+ * Precision Conversion
+ *
+ *****************************************************************************/
+void
+vec3_to_vec3f(vec3_t src, vec3f_t dest)
+{
+    dest[X] = src[X];
+    dest[Y] = src[Y];
+    dest[Z] = src[Z];
+}
+
+void
+vec3f_to_vec3(vec3f_t src, vec3_t dest)
+{
+    dest[X] = src[X];
+    dest[Y] = src[Y];
+    dest[Z] = src[Z];
+}
+
+void
+quat_to_quatf(quat_t src, quatf_t dest)
+{
+    dest[X] = src[X];
+    dest[Y] = src[Y];
+    dest[Z] = src[Z];
+    dest[W] = src[W];
+}
+
+void
+quatf_to_quat(quatf_t src, quat_t dest)
+{
+    dest[X] = src[X];
+    dest[Y] = src[Y];
+    dest[Z] = src[Z];
+    dest[W] = src[W];
+}
+
+void
+mat4x4_to_mat4x4f(mat4x4_t src, mat4x4f_t dest)
+{
+    int i;
+
+    for (i = 0; i < 16; i++)
+	dest[i] = src[i];
+}
+
+void
+mat4x4f_to_mat4x4(mat4x4f_t src, mat4x4_t dest)
+{
+    int i;
+
+    for (i = 0; i < 16; i++)
+	dest[i] = src[i];
+}
+
+void
+vec3_to_vec3f_n(vec3_t *src, vec3f_t *dest, int32_t n)
+{
+    int32_t i;
+
+    for (i = 0; i < n; i++)
+	vec3_to_vec3f(src[i], dest[i]);
+}
+
+void
+vec3f_to_vec3_n(vec3f_t *src, vec3_t *dest, int32_t n)
+{
+    int32_t i;
+
+    for (i = 0; i < n; i++)
+	vec3f_to_vec3(src[i], dest[i]);
+}
+/******************************************************************************
+ *
+ * Memory Arenas
+ *
+ * An arena hands out memory from big blocks by bumping a pointer, and
+ * gets it all back at once in mathlib_arena_reset(), which keeps the
+ * blocks around for the next round. That makes it cheap to create lots
+ * of temporaries in a loop without fragmenting the heap. Arenas are not
+ * thread safe, use one per thread.
+ *
+ *****************************************************************************/
+#define ARENA_BLOCK_SIZE	(64 * 1024)
+#define ARENA_ALIGN		32	// enough for the AVX2 loads
+
+typedef struct arena_block_s {
+    struct arena_block_s *next;
+    size_t size;
+    size_t used;
+    char *data;
+} arena_block_t;
+
+struct mathlib_arena_s {
+    arena_block_t *first;
+    arena_block_t *current;
+    size_t block_size;
+};
+
+static arena_block_t *
+arena_block_new(size_t size)
+{
+    arena_block_t *b;
+    uintptr_t p;
+
+    b = g_malloc(sizeof(arena_block_t) + size + ARENA_ALIGN);
+    p = (uintptr_t) (b + 1);
+    p = (p + ARENA_ALIGN - 1) & ~(uintptr_t) (ARENA_ALIGN - 1);
+
+    b->next = NULL;
+    b->size = size;
+    b->used = 0;
+    b->data = (char *) p;
+
+    return b;
+}
+
+/* a new arena which grows block_size bytes at a time, 0 for the default */
+mathlib_arena_t *
+mathlib_arena_new(size_t block_size)
+{
+    mathlib_arena_t *arena;
+
+    if (block_size == 0)
+	block_size = ARENA_BLOCK_SIZE;
+
+    arena = g_malloc(sizeof(mathlib_arena_t));
+    arena->block_size = block_size;
+    arena->first      = arena_block_new(block_size);
+    arena->current    = arena->first;
+
+    return arena;
+}
+
+/* size bytes aligned to 32, valid until the arena is reset or destroyed */
+void *
+mathlib_arena_alloc(mathlib_arena_t *arena, size_t size)
+{
+    arena_block_t *b;
+    void *p;
+
+    size = (size + ARENA_ALIGN - 1) & ~(size_t) (ARENA_ALIGN - 1);
+
+    // move on to the next block, or add one, when this one is full.
+    // After a reset the next blocks are the old ones, emptied.
+    for (b = arena->current; b->used + size > b->size; b = b->next) {
+	if (b->next == NULL)
+	    b->next = arena_block_new(MAX(size, arena->block_size));
+    }
+    arena->current = b;
+
+    p = b->data + b->used;
+    b->used += size;
+
+    return p;
+}
+
+/* free everything allocated from the arena, but keep its memory */
+void
+mathlib_arena_reset(mathlib_arena_t *arena)
+{
+    arena_block_t *b;
+
+    for (b = arena->first; b; b = b->next)
+	b->used = 0;
+    arena->current = arena->first;
+}
+
+void
+mathlib_arena_destroy(mathlib_arena_t *arena)
+{
+    arena_block_t *b, *next;
+
+    if (arena == NULL)
+	return;
+
+    for (b = arena->first; b; b = next) {
+	next = b->next;
+	g_free(b);
+    }
+    g_free(arena);
+}
+
+/* the number of bytes handed out since the last reset */
+size_t
+mathlib_arena_size(mathlib_arena_t *arena)
+{
+    arena_block_t *b;
+    size_t size = 0;
+
+    for (b = arena->first; b; b = b->next)
+	size += b->used;
+
+    return size;
+}
+
+#endif /* MATHLIB_FLOAT */
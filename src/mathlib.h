@@ -26,6 +26,8 @@
 
 #include <glib.h>
 
+G_BEGIN_DECLS
+
 #define X	0
 #define Y	1
 #define Z	2
@@ -55,6 +57,15 @@
 
 #define M(x, y)  m[x + y * 4]
 
+/* clip flags set by project_n() */
+#define CLIP_LEFT	0x01
+#define CLIP_RIGHT	0x02
+#define CLIP_BOTTOM	0x04
+#define CLIP_TOP	0x08
+#define CLIP_NEAR	0x10
+#define CLIP_FAR	0x20
+#define CLIP_W		0x40	/* on or behind the eye, win is not valid */
+
 
 #define DEG2RAD (M_PI/180.0)
 #define RAD2DEG (180.0/M_PI)
@@ -104,19 +115,24 @@
 #define vec2_cp(a,b) { (b)[X]=(a)[X]; (b)[Y]=(a)[Y]; }
 #define vec4_cp(a,b) do { (b)[X]=(a)[X]; (b)[Y]=(a)[Y]; (b)[Z]=(a)[Z]; (b)[W]=(a)[W]; } while (0)
 
-#define MATH64
-
-#ifdef MATH64
+/*
+ * Every function comes in a double and a float version. The double ones
+ * use the plain names (real, vec3_t, quat_mult, ...), the float ones put
+ * an f after the type prefix (realf, vec3f_t, quatf_mult, ...), or at
+ * the end for names without one (projectf).
+ */
 typedef double real;	/* 64 bit */
-#else
-typedef float real;	/* 32 bit */
-#endif
+typedef float realf;	/* 32 bit */
 
 /* all kinds of vector defs */
 typedef real	vec2_t[2];
 typedef real	vec3_t[3];
 typedef real	vec4_t[4];
 
+typedef realf	vec2f_t[2];
+typedef realf	vec3f_t[3];
+typedef realf	vec4f_t[4];
+
 typedef int32_t int32_vec2_t[2];
 typedef int32_t int32_vec3_t[3];
 typedef int32_t int32_vec4_t[4];
@@ -142,42 +158,105 @@ typedef uint8_t uint8_vec3_t[3];
 typedef uint8_t uint8_vec4_t[4];
 
 typedef vec4_t quat_t;
+typedef vec4f_t quatf_t;
 
 typedef real mat4x4_t[16];
 typedef real mat3x3_t[9];
 
-quat_t *quat_new(real x, real y, real z, real w);
-void quat_add(quat_t q1, quat_t q2, quat_t dest);
-void quat_id(quat_t q);
-void quat_to_mat(quat_t q, mat4x4_t m);
-void quat_to_mat_inv(quat_t q, mat4x4_t m);
-void quat_to_mat_transpose(quat_t q, mat4x4_t m);
-void quat_cp(quat_t src, quat_t dst);
-void quat_set3(quat_t q, real x, real y, real z);
-void quat_set4(quat_t q, real x, real y, real z, real angle);
-void quat_mult(quat_t q1, quat_t q2);
-void quat_to_vecs(quat_t q, vec3_t dir, vec3_t up, vec3_t right);
-void quat_print(quat_t q);
-void quat_norm(quat_t q);
-void quat_inv(quat_t q);
-
-vec3_t *vec3_new(real, real, real);
-void vec3_destroy(vec3_t *v);
-gboolean vec3_angle(vec3_t a, vec3_t b, real *angle);
-void vec3_cross(vec3_t v1, vec3_t v2, vec3_t res);
-void vec3_norm(vec3_t v);
-void vec3_print(vec3_t v);
-void vec3_transform(vec3_t *v, int32_t n, mat4x4_t m);
-void transform_point(real out[4], real m[16], real in[4]);
-
-/* matrix api */
-mat4x4_t *mat4x4_new(void);
-void mat4x4_zero(mat4x4_t m);
-void mat4x4_scale(mat4x4_t m, real s);
-void mat4x4_translate(mat4x4_t m, real x, real y, real z);
-void mat4x4_id(mat4x4_t m);
-void mat4x4_mult(mat4x4_t m1, mat4x4_t m2, mat4x4_t dest);
-void mat4x4_copy(mat4x4_t src, mat4x4_t dest);
+typedef realf mat4x4f_t[16];
+typedef realf mat3x3f_t[9];
+
+/* structure of arrays storage used by the batched api, one array per
+ * component so the kernels can load several quaternions at once */
+typedef struct {
+    real *x;
+    real *y;
+    real *z;
+    real *w;
+} quat_soa_t;
+
+typedef struct {
+    realf *x;
+    realf *y;
+    realf *z;
+    realf *w;
+} quatf_soa_t;
 
+/*
+ * how vec3_norm_mode(), quat_norm_mode() and the batched versions
+ * normalize. The error is the worst |length - 1| of the result, for
+ * inputs whose squared length fits in a float:
+ *
+ *   NORM_EXACT  sqrt and divide, same as vec3_norm() and quat_norm().
+ *               A few ulp: ~4e-16 for double, ~2e-7 for float.
+ *
+ *   NORM_FAST   the cpu's reciprocal square root estimate (12 bits)
+ *               plus one Newton step. ~4e-7 for both precisions, ~5e-6
+ *               on cpus without SSE.
+ *
+ *   NORM_LAZY   leaves the vector alone when |length^2 - 1| is at most
+ *               NORM_LAZY_EPSILON (so |length - 1| <= ~5e-6), otherwise
+ *               does the same as NORM_FAST. Meant for renormalizing
+ *               values that drift a little every frame.
+ */
+typedef enum {
+    NORM_EXACT,
+    NORM_FAST,
+    NORM_LAZY
+} norm_mode_t;
+
+#define NORM_LAZY_EPSILON 1e-5
+
+/*
+ * order in which quat_set_euler() applies the x, y and z rotations,
+ * first letter first. EULER_XYZ is what quat_set3() does.
+ */
+typedef enum {
+    EULER_XYZ,
+    EULER_XZY,
+    EULER_YXZ,
+    EULER_YZX,
+    EULER_ZXY,
+    EULER_ZYX
+} euler_order_t;
+
+/*
+ * a memory arena for vec3_t, quat_t and mat4x4_t objects (and anything
+ * else), see mathlib_arena_new(). The *_new_arena() constructors take
+ * one, the objects they return are freed all at once by resetting or
+ * destroying the arena instead of one at a time.
+ */
+typedef struct mathlib_arena_s mathlib_arena_t;
+
+/* double precision */
+#include "mathlib_api.h"
+
+/* single precision */
+#include "mathlib_float.h"
+#include "mathlib_api.h"
+#include "mathlib_float.h"
+
+/* precision conversion */
+void vec3_to_vec3f(vec3_t src, vec3f_t dest);
+void vec3f_to_vec3(vec3f_t src, vec3_t dest);
+void quat_to_quatf(quat_t src, quatf_t dest);
+void quatf_to_quat(quatf_t src, quat_t dest);
+void mat4x4_to_mat4x4f(mat4x4_t src, mat4x4f_t dest);
+void mat4x4f_to_mat4x4(mat4x4f_t src, mat4x4_t dest);
+void vec3_to_vec3f_n(vec3_t *src, vec3f_t *dest, int32_t n);
+void vec3f_to_vec3_n(vec3f_t *src, vec3_t *dest, int32_t n);
+
+/* batched api settings, shared by both precisions */
+void mathlib_simd_enable(gboolean enable);
+void mathlib_set_threads(int threads);
+
+/* memory arenas, shared by both precisions */
+mathlib_arena_t *mathlib_arena_new(size_t block_size);
+void *mathlib_arena_alloc(mathlib_arena_t *arena, size_t size);
+void mathlib_arena_reset(mathlib_arena_t *arena);
+void mathlib_arena_destroy(mathlib_arena_t *arena);
+size_t mathlib_arena_size(mathlib_arena_t *arena);
+
+G_END_DECLS
 
 #endif
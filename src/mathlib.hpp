@@ -0,0 +1,659 @@
+/*
+ *  Name: mathlib.hpp
+ *  Description: C++ wrapper with expression templates for mathlib
+ *
+ *  Copyright (C) 2012  Jason Hall
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Header only, needs C++14.
+ *
+ * Vec3<T>, Quat<T> and Mat4<T> have exactly the layout of vec3_t,
+ * quat_t and mat4x4_t (T is real or realf), so a pointer to one can be
+ * used as a pointer to the other, see from() and c(). Vec3View<T> wraps
+ * an existing vec3_t array without copying it.
+ *
+ * Arithmetic on vectors doesn't compute anything by itself, it builds an
+ * expression which is worked out one element at a time when it is
+ * assigned. So with an array view
+ *
+ *	Vec3View<real> out(v, n), in(v, n);
+ *	out = m1 * m2 * in + t;
+ *
+ * m1 * m2 is multiplied once (matrix products are done right away), and
+ * then a single loop transforms each point, adds t and stores it, with
+ * no temporary arrays in between. Plain Vec3 values act like an array of
+ * any length holding the same value, so they mix freely with views.
+ *
+ * Points are transformed like vec3_transform() does, as (x, y, z, 1)
+ * without the divide by w. Expressions keep copies of what they are made
+ * of, so they can be stored with auto and evaluated later, as long as
+ * the arrays behind the views are still around.
+ *
+ * Matrix and quaternion products, Quat::matrix() and the builders at
+ * the end (identity, scale, translation, rotations) are constexpr, so a
+ * transform made only of constants is worked out by the compiler:
+ *
+ *	constexpr Mat4<real> m = mat4_translation<real>(0, 0, -5) *
+ *				 mat4_rotation_y<real>(30);
+ *
+ * becomes a table of 16 numbers, without any trig at run time. They use
+ * their own sin and cos, good to about an ulp.
+ */
+
+#ifndef _MATHLIB_HPP
+#define _MATHLIB_HPP
+
+#include <cstddef>
+#include <cassert>
+#include <type_traits>
+
+#include "mathlib.h"
+
+namespace mathlib {
+
+/******************************************************************************
+ *
+ * C types and functions of each precision
+ *
+ *****************************************************************************/
+template <typename T> struct ctypes;
+
+template <>
+struct ctypes<real> {
+    typedef vec3_t vec3;
+    typedef quat_t quat;
+    typedef mat4x4_t mat4;
+
+    static void mat4_mult(mat4 a, mat4 b, mat4 dest) { mat4x4_mult(a, b, dest); }
+    static gboolean mat4_inv(mat4 m, mat4 dest) { return mat4x4_inv(m, dest); }
+    static void quat_mult(quat q1, quat q2) { ::quat_mult(q1, q2); }
+    static void quat_to_mat(quat q, mat4 m) { ::quat_to_mat(q, m); }
+    static void quat_norm(quat q) { ::quat_norm(q); }
+    static void mat4_to_quat(mat4 m, quat q) { mat4x4_to_quat(m, q); }
+};
+
+template <>
+struct ctypes<realf> {
+    typedef vec3f_t vec3;
+    typedef quatf_t quat;
+    typedef mat4x4f_t mat4;
+
+    static void mat4_mult(mat4 a, mat4 b, mat4 dest) { mat4x4f_mult(a, b, dest); }
+    static gboolean mat4_inv(mat4 m, mat4 dest) { return mat4x4f_inv(m, dest); }
+    static void quat_mult(quat q1, quat q2) { quatf_mult(q1, q2); }
+    static void quat_to_mat(quat q, mat4 m) { quatf_to_mat(q, m); }
+    static void quat_norm(quat q) { quatf_norm(q); }
+    static void mat4_to_quat(mat4 m, quat q) { mat4x4f_to_quat(m, q); }
+};
+
+template <typename T> struct Vec3;
+template <typename T> struct Mat4;
+
+/******************************************************************************
+ *
+ * Vector Expressions
+ *
+ * Every expression E has at(i), the value of element i, and size(), the
+ * number of elements or 0 if it is the same for all of them.
+ *
+ *****************************************************************************/
+template <typename E, typename T>
+struct VecExpr {
+    typedef T scalar_type;
+
+    const E &self() const { return static_cast<const E &>(*this); }
+    Vec3<T> at(std::size_t i) const { return self().at(i); }
+    std::size_t size() const { return self().size(); }
+};
+
+/* the size of an expression made of two others */
+inline std::size_t
+expr_size(std::size_t a, std::size_t b)
+{
+    assert(a == 0 || b == 0 || a == b);
+    return a ? a : b;
+}
+
+/* vectors, same layout as vec3_t */
+template <typename T>
+struct Vec3 : VecExpr<Vec3<T>, T> {
+    typedef typename ctypes<T>::vec3 c_type;
+
+    T v[3];
+
+    Vec3() {}
+    constexpr Vec3(T x, T y, T z) : v{x, y, z} {}
+    Vec3(const c_type &c) { v[X] = c[X]; v[Y] = c[Y]; v[Z] = c[Z]; }
+
+    template <typename E>
+    Vec3(const VecExpr<E, T> &e) { *this = e; }
+
+    template <typename E>
+    Vec3 &
+    operator=(const VecExpr<E, T> &e)
+    {
+	assert(e.size() == 0);
+	Vec3 r = e.at(0);
+
+	v[X] = r.v[X];
+	v[Y] = r.v[Y];
+	v[Z] = r.v[Z];
+	return *this;
+    }
+
+    Vec3 at(std::size_t) const { return *this; }
+    std::size_t size() const { return 0; }
+
+    T &operator[](int i) { return v[i]; }
+    T operator[](int i) const { return v[i]; }
+
+    c_type &c() { return reinterpret_cast<c_type &>(v); }
+    const c_type &c() const { return reinterpret_cast<const c_type &>(v); }
+    static Vec3 &from(c_type &c) { return reinterpret_cast<Vec3 &>(c); }
+    static const Vec3 &from(const c_type &c) { return reinterpret_cast<const Vec3 &>(c); }
+};
+
+/* n vectors of an existing vec3_t array */
+template <typename T>
+struct Vec3View : VecExpr<Vec3View<T>, T> {
+    typedef typename ctypes<T>::vec3 c_type;
+
+    c_type *p;
+    std::size_t n;
+
+    Vec3View(c_type *p, std::size_t n) : p(p), n(n) {}
+
+    // assigning evaluates the expression, one element at a time. The
+    // expression may read this same array.
+    template <typename E>
+    Vec3View &
+    operator=(const VecExpr<E, T> &e)
+    {
+	assert(e.size() == 0 || e.size() == n);
+	for (std::size_t i = 0; i < n; i++) {
+	    Vec3<T> r = e.at(i);
+
+	    p[i][X] = r.v[X];
+	    p[i][Y] = r.v[Y];
+	    p[i][Z] = r.v[Z];
+	}
+	return *this;
+    }
+
+    // copies the elements, not the view
+    Vec3View(const Vec3View &) = default;
+    Vec3View &operator=(const Vec3View &o) { return *this = static_cast<const VecExpr<Vec3View, T> &>(o); }
+
+    Vec3<T> at(std::size_t i) const { return Vec3<T>(p[i][X], p[i][Y], p[i][Z]); }
+    std::size_t size() const { return n; }
+
+    Vec3<T> &operator[](std::size_t i) { return Vec3<T>::from(p[i]); }
+};
+
+template <typename Lhs, typename Rhs, typename T>
+struct VecAdd : VecExpr<VecAdd<Lhs, Rhs, T>, T> {
+    Lhs l;
+    Rhs r;
+
+    VecAdd(const Lhs &l, const Rhs &r) : l(l), r(r) {}
+
+    Vec3<T>
+    at(std::size_t i) const
+    {
+	Vec3<T> a = l.at(i), b = r.at(i);
+	return Vec3<T>(a.v[X] + b.v[X], a.v[Y] + b.v[Y], a.v[Z] + b.v[Z]);
+    }
+    std::size_t size() const { return expr_size(l.size(), r.size()); }
+};
+
+template <typename Lhs, typename Rhs, typename T>
+struct VecSub : VecExpr<VecSub<Lhs, Rhs, T>, T> {
+    Lhs l;
+    Rhs r;
+
+    VecSub(const Lhs &l, const Rhs &r) : l(l), r(r) {}
+
+    Vec3<T>
+    at(std::size_t i) const
+    {
+	Vec3<T> a = l.at(i), b = r.at(i);
+	return Vec3<T>(a.v[X] - b.v[X], a.v[Y] - b.v[Y], a.v[Z] - b.v[Z]);
+    }
+    std::size_t size() const { return expr_size(l.size(), r.size()); }
+};
+
+template <typename Lhs, typename Rhs, typename T>
+struct VecCross : VecExpr<VecCross<Lhs, Rhs, T>, T> {
+    Lhs l;
+    Rhs r;
+
+    VecCross(const Lhs &l, const Rhs &r) : l(l), r(r) {}
+
+    // same as vec3_cross()
+    Vec3<T>
+    at(std::size_t i) const
+    {
+	Vec3<T> a = l.at(i), b = r.at(i);
+	return Vec3<T>(a.v[Y]*b.v[Z] - a.v[Z]*b.v[Y],
+		       a.v[Z]*b.v[X] - a.v[X]*b.v[Z],
+		       a.v[X]*b.v[Y] - a.v[Y]*b.v[X]);
+    }
+    std::size_t size() const { return expr_size(l.size(), r.size()); }
+};
+
+template <typename E, typename T>
+struct VecScale : VecExpr<VecScale<E, T>, T> {
+    E e;
+    T s;
+
+    VecScale(const E &e, T s) : e(e), s(s) {}
+
+    Vec3<T>
+    at(std::size_t i) const
+    {
+	Vec3<T> a = e.at(i);
+	return Vec3<T>(a.v[X] * s, a.v[Y] * s, a.v[Z] * s);
+    }
+    std::size_t size() const { return e.size(); }
+};
+
+template <typename E, typename T>
+struct VecDiv : VecExpr<VecDiv<E, T>, T> {
+    E e;
+    T s;
+
+    VecDiv(const E &e, T s) : e(e), s(s) {}
+
+    Vec3<T>
+    at(std::size_t i) const
+    {
+	Vec3<T> a = e.at(i);
+	return Vec3<T>(a.v[X] / s, a.v[Y] / s, a.v[Z] / s);
+    }
+    std::size_t size() const { return e.size(); }
+};
+
+/* m * e, e taken as a point like vec3_transform() does */
+template <typename E, typename T>
+struct VecTransform : VecExpr<VecTransform<E, T>, T> {
+    Mat4<T> m;
+    E e;
+
+    VecTransform(const Mat4<T> &m, const E &e) : m(m), e(e) {}
+
+    Vec3<T>
+    at(std::size_t i) const
+    {
+	Vec3<T> a = e.at(i);
+	return Vec3<T>(
+	    a.v[X] * m(0, 0) + a.v[Y] * m(0, 1) + a.v[Z] * m(0, 2) + m(0, 3),
+	    a.v[X] * m(1, 0) + a.v[Y] * m(1, 1) + a.v[Z] * m(1, 2) + m(1, 3),
+	    a.v[X] * m(2, 0) + a.v[Y] * m(2, 1) + a.v[Z] * m(2, 2) + m(2, 3));
+    }
+    std::size_t size() const { return e.size(); }
+};
+
+template <typename Lhs, typename Rhs, typename T>
+inline VecAdd<Lhs, Rhs, T>
+operator+(const VecExpr<Lhs, T> &l, const VecExpr<Rhs, T> &r)
+{
+    return VecAdd<Lhs, Rhs, T>(l.self(), r.self());
+}
+
+template <typename Lhs, typename Rhs, typename T>
+inline VecSub<Lhs, Rhs, T>
+operator-(const VecExpr<Lhs, T> &l, const VecExpr<Rhs, T> &r)
+{
+    return VecSub<Lhs, Rhs, T>(l.self(), r.self());
+}
+
+template <typename E, typename T>
+inline VecScale<E, T>
+operator-(const VecExpr<E, T> &e)
+{
+    return VecScale<E, T>(e.self(), T(-1));
+}
+
+template <typename E, typename T>
+inline VecScale<E, T>
+operator*(const VecExpr<E, T> &e, typename std::common_type<T>::type s)
+{
+    return VecScale<E, T>(e.self(), s);
+}
+
+template <typename E, typename T>
+inline VecScale<E, T>
+operator*(typename std::common_type<T>::type s, const VecExpr<E, T> &e)
+{
+    return VecScale<E, T>(e.self(), s);
+}
+
+template <typename E, typename T>
+inline VecDiv<E, T>
+operator/(const VecExpr<E, T> &e, typename std::common_type<T>::type s)
+{
+    return VecDiv<E, T>(e.self(), s);
+}
+
+template <typename Lhs, typename Rhs, typename T>
+inline VecCross<Lhs, Rhs, T>
+cross(const VecExpr<Lhs, T> &l, const VecExpr<Rhs, T> &r)
+{
+    return VecCross<Lhs, Rhs, T>(l.self(), r.self());
+}
+
+template <typename T>
+inline T
+dot(const Vec3<T> &a, const Vec3<T> &b)
+{
+    return vec3_dot(a.v, b.v);
+}
+
+template <typename T>
+inline T
+length(const Vec3<T> &a)
+{
+    return vec3_len(a.v);
+}
+
+/******************************************************************************
+ *
+ * Matrices
+ *
+ *****************************************************************************/
+/* 4x4 column major matrices, same layout as mat4x4_t */
+template <typename T>
+struct Mat4 {
+    typedef typename ctypes<T>::mat4 c_type;
+
+    T m[16];
+
+    Mat4() {}
+    Mat4(const c_type &c) { for (int i = 0; i < 16; i++) m[i] = c[i]; }
+
+    // d on the diagonal, 0 elsewhere
+    constexpr explicit Mat4(T d)
+	: m{d, 0, 0, 0,  0, d, 0, 0,  0, 0, d, 0,  0, 0, 0, d} {}
+
+    static constexpr Mat4 identity() { return Mat4(1); }
+
+    constexpr T &operator()(int row, int col) { return m[row + col*4]; }
+    constexpr T operator()(int row, int col) const { return m[row + col*4]; }
+
+    // the inverse, or false if the matrix is singular, see mat4x4_inv()
+    bool inverse(Mat4 &dest) const { return ctypes<T>::mat4_inv(const_cast<T *>(m), dest.m); }
+
+    c_type &c() { return reinterpret_cast<c_type &>(m); }
+    const c_type &c() const { return reinterpret_cast<const c_type &>(m); }
+    static Mat4 &from(c_type &c) { return reinterpret_cast<Mat4 &>(c); }
+    static const Mat4 &from(const c_type &c) { return reinterpret_cast<const Mat4 &>(c); }
+};
+
+/* a * b, worked out right away. Same math as mat4x4_mult(). */
+template <typename T>
+constexpr Mat4<T>
+operator*(const Mat4<T> &a, const Mat4<T> &b)
+{
+    Mat4<T> r(0);
+
+    for (int i = 0; i < 4; i++) {
+	const T ai0 = a(i, 0), ai1 = a(i, 1), ai2 = a(i, 2), ai3 = a(i, 3);
+
+	for (int j = 0; j < 4; j++)
+	    r(i, j) = ai0 * b(0, j) + ai1 * b(1, j) + ai2 * b(2, j) + ai3 * b(3, j);
+    }
+    return r;
+}
+
+template <typename E, typename T>
+inline VecTransform<E, T>
+operator*(const Mat4<T> &m, const VecExpr<E, T> &e)
+{
+    return VecTransform<E, T>(m, e.self());
+}
+
+/******************************************************************************
+ *
+ * Quaternions
+ *
+ *****************************************************************************/
+/* same layout as quat_t */
+template <typename T>
+struct Quat {
+    typedef typename ctypes<T>::quat c_type;
+
+    T q[4];
+
+    Quat() {}
+    constexpr Quat(T x, T y, T z, T w) : q{x, y, z, w} {}
+    Quat(const c_type &c) { for (int i = 0; i < 4; i++) q[i] = c[i]; }
+
+    static constexpr Quat identity() { return Quat(0, 0, 0, 1); }
+
+    // the rotation matrix, same math as quat_to_mat()
+    constexpr Mat4<T>
+    matrix() const
+    {
+	const T x = q[X], y = q[Y], z = q[Z], w = q[W];
+	Mat4<T> r(1);
+
+	r(0, 0) = 1.0 - 2.0 * (y*y + z*z);
+	r(1, 0) = 2.0       * (x*y + z*w);
+	r(2, 0) = 2.0       * (x*z - y*w);
+
+	r(0, 1) = 2.0       * (y*x - z*w);
+	r(1, 1) = 1.0 - 2.0 * (x*x + z*z);
+	r(2, 1) = 2.0       * (y*z + x*w);
+
+	r(0, 2) = 2.0       * (z*x + y*w);
+	r(1, 2) = 2.0       * (z*y - x*w);
+	r(2, 2) = 1.0 - 2.0 * (x*x + y*y);
+	return r;
+    }
+
+    Quat
+    normalized() const
+    {
+	Quat r = *this;
+	ctypes<T>::quat_norm(r.q);
+	return r;
+    }
+
+    constexpr T &operator[](int i) { return q[i]; }
+    constexpr T operator[](int i) const { return q[i]; }
+
+    c_type &c() { return reinterpret_cast<c_type &>(q); }
+    const c_type &c() const { return reinterpret_cast<const c_type &>(q); }
+    static Quat &from(c_type &c) { return reinterpret_cast<Quat &>(c); }
+    static const Quat &from(const c_type &c) { return reinterpret_cast<const Quat &>(c); }
+};
+
+/* a * b, the rotation b followed by a. Same math as quat_mult(b, a). */
+template <typename T>
+constexpr Quat<T>
+operator*(const Quat<T> &a, const Quat<T> &b)
+{
+    return Quat<T>(a[W] * b[X] + a[X] * b[W] + a[Y] * b[Z] - a[Z] * b[Y],
+		   a[W] * b[Y] - a[X] * b[Z] + a[Y] * b[W] + a[Z] * b[X],
+		   a[W] * b[Z] + a[X] * b[Y] - a[Y] * b[X] + a[Z] * b[W],
+		   a[W] * b[W] - a[X] * b[X] - a[Y] * b[Y] - a[Z] * b[Z]);
+}
+
+/* rotate every vector of e by q */
+template <typename E, typename T>
+inline VecTransform<E, T>
+operator*(const Quat<T> &q, const VecExpr<E, T> &e)
+{
+    return VecTransform<E, T>(q.matrix(), e.self());
+}
+
+/******************************************************************************
+ *
+ * Transform Builders
+ *
+ * Angles are in degrees like quat_set4() and quat_set_euler().
+ *
+ *****************************************************************************/
+namespace detail {
+
+struct sincos_t {
+    long double s, c;
+};
+
+/* sin and cos of a degrees, in long double so the results round well */
+constexpr sincos_t
+sincos_deg(long double a)
+{
+    const long double pio2 = 1.570796326794896619231321691639751442L;
+
+    // reduce to [-45, 45] degrees, quadrant q
+    const long long n = (a < 0) ? -(long long) (0.5L - a / 90.0L)
+				: (long long) (a / 90.0L + 0.5L);
+    const long double r = (a - n * 90.0L) * (pio2 / 90.0L);
+    const long double r2 = r * r;
+    const long long q = n & 3;
+
+    // taylor series, 12 terms are plenty for |r| <= pi/4
+    long double s = r, c = 1, ts = r, tc = 1;
+
+    for (int k = 1; k <= 12; k++) {
+	ts *= -r2 / ((2*k) * (2*k + 1));
+	tc *= -r2 / ((2*k - 1) * (2*k));
+	s += ts;
+	c += tc;
+    }
+
+    switch (q) {
+    case 0: return sincos_t{ s,  c};
+    case 1: return sincos_t{ c, -s};
+    case 2: return sincos_t{-s, -c};
+    default: return sincos_t{-c,  s};
+    }
+}
+
+} // namespace detail
+
+template <typename T>
+constexpr Mat4<T>
+mat4_scale(T x, T y, T z)
+{
+    Mat4<T> r(1);
+
+    r(0, 0) = x;
+    r(1, 1) = y;
+    r(2, 2) = z;
+    return r;
+}
+
+template <typename T>
+constexpr Mat4<T>
+mat4_translation(T x, T y, T z)
+{
+    Mat4<T> r(1);
+
+    r(0, 3) = x;
+    r(1, 3) = y;
+    r(2, 3) = z;
+    return r;
+}
+
+/* the rotation by angle degrees around the x axis */
+template <typename T>
+constexpr Mat4<T>
+mat4_rotation_x(long double angle)
+{
+    const detail::sincos_t t = detail::sincos_deg(angle);
+    Mat4<T> r(1);
+
+    r(1, 1) = t.c;
+    r(1, 2) = -t.s;
+    r(2, 1) = t.s;
+    r(2, 2) = t.c;
+    return r;
+}
+
+template <typename T>
+constexpr Mat4<T>
+mat4_rotation_y(long double angle)
+{
+    const detail::sincos_t t = detail::sincos_deg(angle);
+    Mat4<T> r(1);
+
+    r(0, 0) = t.c;
+    r(0, 2) = t.s;
+    r(2, 0) = -t.s;
+    r(2, 2) = t.c;
+    return r;
+}
+
+template <typename T>
+constexpr Mat4<T>
+mat4_rotation_z(long double angle)
+{
+    const detail::sincos_t t = detail::sincos_deg(angle);
+    Mat4<T> r(1);
+
+    r(0, 0) = t.c;
+    r(0, 1) = -t.s;
+    r(1, 0) = t.s;
+    r(1, 1) = t.c;
+    return r;
+}
+
+/* the rotation by angle degrees around the unit axis x, y, z, like quat_set4() */
+template <typename T>
+constexpr Quat<T>
+quat_rotation(T x, T y, T z, long double angle)
+{
+    const detail::sincos_t t = detail::sincos_deg(angle / 2);
+
+    return Quat<T>(x * T(t.s), y * T(t.s), z * T(t.s), T(t.c));
+}
+
+/* like quat_set_euler() */
+template <typename T>
+constexpr Quat<T>
+quat_euler(long double x, long double y, long double z, euler_order_t order)
+{
+    const Quat<T> qx = quat_rotation<T>(1, 0, 0, x);
+    const Quat<T> qy = quat_rotation<T>(0, 1, 0, y);
+    const Quat<T> qz = quat_rotation<T>(0, 0, 1, z);
+
+    switch (order) {
+    case EULER_XYZ: return qz * qy * qx;
+    case EULER_XZY: return qy * qz * qx;
+    case EULER_YXZ: return qz * qx * qy;
+    case EULER_YZX: return qx * qz * qy;
+    case EULER_ZXY: return qy * qx * qz;
+    default:        return qx * qy * qz;
+    }
+}
+
+#define MATHLIB_HPP_LAYOUT(cpp, c) \
+    static_assert(sizeof(cpp) == sizeof(c) && std::is_standard_layout<cpp>::value, \
+		  #cpp " must have the layout of " #c)
+MATHLIB_HPP_LAYOUT(Vec3<real>, vec3_t);
+MATHLIB_HPP_LAYOUT(Vec3<realf>, vec3f_t);
+MATHLIB_HPP_LAYOUT(Quat<real>, quat_t);
+MATHLIB_HPP_LAYOUT(Quat<realf>, quatf_t);
+MATHLIB_HPP_LAYOUT(Mat4<real>, mat4x4_t);
+MATHLIB_HPP_LAYOUT(Mat4<realf>, mat4x4f_t);
+#undef MATHLIB_HPP_LAYOUT
+
+} // namespace mathlib
+
+#endif
@@ -0,0 +1,88 @@
+/*
+ *  Name: mathlib_api.h
+ *  Description: Vector, matrix and quaternion function prototypes
+ *
+ *  Copyright (C) 2012  Jason Hall
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Do not include this file directly, use mathlib.h.
+ *
+ * There is no include guard on purpose: mathlib.h includes it once as is
+ * for the double precision functions and once more with mathlib_float.h
+ * in effect for the float ones.
+ */
+
+quat_t *quat_new(real x, real y, real z, real w);
+quat_t *quat_new_arena(mathlib_arena_t *arena, real x, real y, real z, real w);
+void quat_destroy(quat_t *q);
+void quat_add(quat_t q1, quat_t q2, quat_t dest);
+void quat_id(quat_t q);
+void quat_to_mat(quat_t q, mat4x4_t m);
+void quat_to_mat_inv(quat_t q, mat4x4_t m);
+void quat_to_mat_transpose(quat_t q, mat4x4_t m);
+void quat_cp(quat_t src, quat_t dst);
+void quat_set3(quat_t q, real x, real y, real z);
+void quat_set4(quat_t q, real x, real y, real z, real angle);
+void quat_set_euler(quat_t q, real x, real y, real z, euler_order_t order);
+void quat_mult(quat_t q1, quat_t q2);
+void quat_to_vecs(quat_t q, vec3_t dir, vec3_t up, vec3_t right);
+void quat_print(quat_t q);
+void quat_norm(quat_t q);
+void quat_norm_mode(quat_t q, norm_mode_t mode);
+void quat_inv(quat_t q);
+
+vec3_t *vec3_new(real, real, real);
+vec3_t *vec3_new_arena(mathlib_arena_t *arena, real x, real y, real z);
+void vec3_destroy(vec3_t *v);
+gboolean vec3_angle(vec3_t a, vec3_t b, real *angle);
+void vec3_cross(vec3_t v1, vec3_t v2, vec3_t res);
+void vec3_norm(vec3_t v);
+void vec3_norm_mode(vec3_t v, norm_mode_t mode);
+void vec3_print(vec3_t v);
+void vec3_transform(vec3_t *v, int32_t n, mat4x4_t m);
+void transform_point(real out[4], real m[16], real in[4]);
+gboolean project(vec3_t obj, mat4x4_t model, mat4x4_t proj,
+	int32_t viewport[4], vec3_t win);
+
+/* matrix api */
+mat4x4_t *mat4x4_new(void);
+mat4x4_t *mat4x4_new_arena(mathlib_arena_t *arena);
+void mat4x4_destroy(mat4x4_t *m);
+void mat4x4_zero(mat4x4_t m);
+void mat4x4_scale(mat4x4_t m, real s);
+void mat4x4_translate(mat4x4_t m, real x, real y, real z);
+void mat4x4_id(mat4x4_t m);
+void mat4x4_mult(mat4x4_t m1, mat4x4_t m2, mat4x4_t dest);
+void mat4x4_copy(mat4x4_t src, mat4x4_t dest);
+gboolean mat4x4_inv(mat4x4_t m, mat4x4_t dest);
+void mat4x4_inv_affine(mat4x4_t m, mat4x4_t dest);
+void mat4x4_to_quat(mat4x4_t m, quat_t q);
+
+/* batched api (mathlib_batch.c) */
+void quat_mult_n(quat_soa_t *q1, quat_soa_t *q2, quat_soa_t *dest, int32_t n);
+void quat_norm_n(quat_soa_t *q, int32_t n, norm_mode_t mode);
+void quat_set_euler_n(vec3_t *angles, quat_soa_t *q, int32_t n,
+	euler_order_t order);
+void vec3_norm_n(vec3_t *v, int32_t n, norm_mode_t mode);
+void vec3_transform_n(vec3_t *in, vec3_t *out, int32_t n, mat4x4_t m);
+int32_t project_n(vec3_t *obj, int32_t n, mat4x4_t model, mat4x4_t proj,
+	int32_t viewport[4], vec3_t *win, uint8_t *clip);
+void mat4x4_mult_n(mat4x4_t *m1, mat4x4_t *m2, mat4x4_t *dest, int32_t n);
+void mat4x4_mult_indexed(mat4x4_t *m1, int32_t *index, mat4x4_t *m2,
+	mat4x4_t *dest, int32_t n);
+int32_t mat4x4_inv_n(mat4x4_t *m, mat4x4_t *dest, int32_t n);
+void mat4x4_to_quat_n(mat4x4_t *m, quat_soa_t *q, int32_t n);
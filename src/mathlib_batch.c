@@ -0,0 +1,1251 @@
+/*
+ *  Name: mathlib_batch.c
+ *  Description: Batched vector, matrix and quaternion math kernels
+ *
+ *  Copyright (C) 2012  Jason Hall
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Every batched function has a scalar version which produces the same
+ * results as the single item function in mathlib.c, and an AVX2 version
+ * which is used when the cpu supports it. The scalar version also
+ * handles whatever is left over after the last full vector.
+ *
+ * Build with --enable-strict-math (MATHLIB_STRICT) to have the AVX2
+ * kernels skip FMA contraction so they match the scalar code bit for bit.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+/* sysconf() */
+#include <unistd.h>
+
+#include "mathlib.h"
+#include "mathlib_simd.h"
+
+/*
+ * mathlib_batchf.c builds this file a second time for float, the simd
+ * switch and the worker pool are only compiled into the double build and
+ * shared by both.
+ */
+#ifndef MATHLIB_FLOAT
+static gboolean simd_enabled = TRUE;
+
+void
+mathlib_simd_enable(gboolean enable)
+{
+    simd_enabled = enable;
+}
+
+gboolean
+simd_avx2(void)
+{
+#ifdef MATHLIB_AVX2
+    static int supported = -1;
+
+    if (supported < 0) {
+	__builtin_cpu_init();
+	supported = __builtin_cpu_supports("avx2") &&
+		    __builtin_cpu_supports("fma");
+    }
+
+    return simd_enabled && supported;
+#else
+    return FALSE;
+#endif
+}
+
+/******************************************************************************
+ *
+ * Worker Pool
+ *
+ *****************************************************************************/
+
+/* don't bother waking up other threads for less work than this */
+#define BATCH_GRAIN 16384
+
+typedef struct {
+    batch_func_t func;
+    void *data;
+    int32_t start;
+    int32_t end;
+    GAsyncQueue *done;
+} batch_task_t;
+
+static GThreadPool *batch_pool;
+static int batch_threads;
+
+static void
+batch_worker(gpointer data, gpointer user_data)
+{
+    batch_task_t *task = data;
+
+    task->func(task->data, task->start, task->end);
+    g_async_queue_push(task->done, task);
+}
+
+static gpointer
+batch_pool_init(gpointer data)
+{
+    if (batch_threads <= 0)
+	batch_threads = sysconf(_SC_NPROCESSORS_ONLN);
+    if (batch_threads <= 0)
+	batch_threads = 1;
+
+    if (batch_threads > 1) {
+#if !GLIB_CHECK_VERSION(2,32,0)
+	if (!g_thread_supported())
+	    g_thread_init(NULL);
+#endif
+	// the calling thread runs one of the chunks itself
+	batch_pool = g_thread_pool_new(batch_worker, NULL, batch_threads - 1,
+		FALSE, NULL);
+    }
+
+    return NULL;
+}
+
+/* 0 uses one thread per cpu, must be called before the first batch */
+void
+mathlib_set_threads(int threads)
+{
+    batch_threads = threads;
+}
+
+void
+batch_run(batch_func_t func, void *data, int32_t n)
+{
+    static GOnce once = G_ONCE_INIT;
+    batch_task_t *tasks;
+    GAsyncQueue *done;
+    int32_t chunk;
+    int i, chunks;
+
+    g_once(&once, batch_pool_init, NULL);
+
+    chunks = MIN(batch_threads, n / BATCH_GRAIN);
+    if (batch_pool == NULL || chunks <= 1) {
+	func(data, 0, n);
+	return;
+    }
+
+    // keep the chunks a multiple of the vector width so only the
+    // last one has a scalar tail
+    chunk = ((n + chunks - 1) / chunks + 7) & ~7;
+
+    done = g_async_queue_new();
+    tasks = g_new0(batch_task_t, chunks);
+    for (i = 0; i < chunks; i++) {
+	tasks[i].func  = func;
+	tasks[i].data  = data;
+	tasks[i].start = MIN(i * chunk, n);
+	tasks[i].end   = MIN(tasks[i].start + chunk, n);
+	tasks[i].done  = done;
+    }
+
+    for (i = 1; i < chunks; i++)
+	g_thread_pool_push(batch_pool, &tasks[i], NULL);
+
+    func(data, tasks[0].start, tasks[0].end);
+
+    for (i = 1; i < chunks; i++)
+	g_async_queue_pop(done);
+
+    g_async_queue_unref(done);
+    g_free(tasks);
+}
+#endif /* MATHLIB_FLOAT */
+
+#ifdef MATHLIB_AVX2
+#pragma GCC push_options
+#pragma GCC target("avx2,fma")
+
+/*
+ * the scale that normalizes a vector with squared length len2, for
+ * NORM_FAST and NORM_LAZY. Same math as rsqrt_newton() in mathlib.c.
+ */
+static inline vreal
+norm_scale_avx2(vreal len2, norm_mode_t mode)
+{
+    const vreal half = vreal_set1(0.5), threehalfs = vreal_set1(1.5);
+    const vreal one = vreal_set1(1.0), sign = vreal_signmask();
+    vreal y, t;
+
+    y = vreal_rsqrt(len2);
+    t = vreal_mul(vreal_mul(half, len2), y);
+    y = vreal_mul(y, vreal_nmadd(t, y, threehalfs));
+
+    // leave the ones that are close enough alone
+    if (mode == NORM_LAZY) {
+	t = vreal_andnot(sign, vreal_sub(len2, one));
+	y = vreal_blend(y, one,
+		vreal_cmple(t, vreal_set1(NORM_LAZY_EPSILON)));
+    }
+
+    return y;
+}
+
+#pragma GCC pop_options
+#endif
+
+/******************************************************************************
+ *
+ * Quaternion Functions
+ *
+ *****************************************************************************/
+
+/* same math as quat_mult(): dest = q2 * q1 */
+static void
+quat_mult_n_scalar(quat_soa_t *q1, quat_soa_t *q2, quat_soa_t *dest,
+	int32_t start, int32_t n)
+{
+    int32_t i;
+
+    for (i = start; i < n; i++) {
+	real x1 = q1->x[i], y1 = q1->y[i], z1 = q1->z[i], w1 = q1->w[i];
+	real x2 = q2->x[i], y2 = q2->y[i], z2 = q2->z[i], w2 = q2->w[i];
+
+	dest->w[i] = w2 * w1 - x2 * x1 - y2 * y1 - z2 * z1;
+	dest->x[i] = w2 * x1 + x2 * w1 + y2 * z1 - z2 * y1;
+	dest->y[i] = w2 * y1 - x2 * z1 + y2 * w1 + z2 * x1;
+	dest->z[i] = w2 * z1 + x2 * y1 - y2 * x1 + z2 * w1;
+    }
+}
+
+#ifdef MATHLIB_AVX2
+#pragma GCC push_options
+#pragma GCC target("avx2,fma")
+
+static int32_t
+quat_mult_n_avx2(quat_soa_t *q1, quat_soa_t *q2, quat_soa_t *dest, int32_t n)
+{
+    int32_t i;
+
+    for (i = 0; i + VREAL_WIDTH <= n; i += VREAL_WIDTH) {
+	vreal x1 = vreal_load(&q1->x[i]), y1 = vreal_load(&q1->y[i]);
+	vreal z1 = vreal_load(&q1->z[i]), w1 = vreal_load(&q1->w[i]);
+	vreal x2 = vreal_load(&q2->x[i]), y2 = vreal_load(&q2->y[i]);
+	vreal z2 = vreal_load(&q2->z[i]), w2 = vreal_load(&q2->w[i]);
+	vreal rx, ry, rz, rw;
+
+	// the terms are accumulated in the same order as quat_mult()
+	rw = vreal_mul(w2, w1);
+	rw = vreal_nmadd(x2, x1, rw);
+	rw = vreal_nmadd(y2, y1, rw);
+	rw = vreal_nmadd(z2, z1, rw);
+
+	rx = vreal_mul(w2, x1);
+	rx = vreal_madd(x2, w1, rx);
+	rx = vreal_madd(y2, z1, rx);
+	rx = vreal_nmadd(z2, y1, rx);
+
+	ry = vreal_mul(w2, y1);
+	ry = vreal_nmadd(x2, z1, ry);
+	ry = vreal_madd(y2, w1, ry);
+	ry = vreal_madd(z2, x1, ry);
+
+	rz = vreal_mul(w2, z1);
+	rz = vreal_madd(x2, y1, rz);
+	rz = vreal_nmadd(y2, x1, rz);
+	rz = vreal_madd(z2, w1, rz);
+
+	vreal_store(&dest->x[i], rx);
+	vreal_store(&dest->y[i], ry);
+	vreal_store(&dest->z[i], rz);
+	vreal_store(&dest->w[i], rw);
+    }
+
+    return i;
+}
+
+#pragma GCC pop_options
+#endif
+
+/* dest may be the same as q1 or q2 */
+void
+quat_mult_n(quat_soa_t *q1, quat_soa_t *q2, quat_soa_t *dest, int32_t n)
+{
+    int32_t i = 0;
+
+#ifdef MATHLIB_AVX2
+    if (simd_avx2())
+	i = quat_mult_n_avx2(q1, q2, dest, n);
+#endif
+    quat_mult_n_scalar(q1, q2, dest, i, n);
+}
+
+#ifdef MATHLIB_AVX2
+#pragma GCC push_options
+#pragma GCC target("avx2,fma")
+
+static int32_t
+quat_norm_n_avx2(quat_soa_t *q, int32_t start, int32_t n, norm_mode_t mode)
+{
+    const vreal zero = vreal_setzero(), one = vreal_set1(1.0);
+    const vreal nan = vreal_set1(NAN);
+    int32_t i;
+
+    for (i = start; i + VREAL_WIDTH <= n; i += VREAL_WIDTH) {
+	vreal x = vreal_load(&q->x[i]);
+	vreal y = vreal_load(&q->y[i]);
+	vreal z = vreal_load(&q->z[i]);
+	vreal w = vreal_load(&q->w[i]);
+	vreal f, s;
+
+	f = vreal_mul(w, w);
+	f = vreal_madd(x, x, f);
+	f = vreal_madd(y, y, f);
+	f = vreal_madd(z, z, f);
+
+	if (mode == NORM_EXACT) {
+	    // quat_norm() uses a NAN scale for zero quaternions
+	    s = vreal_div(one, vreal_sqrt(f));
+	    s = vreal_blend(nan, s, vreal_cmpneq(f, zero));
+	} else {
+	    s = norm_scale_avx2(f, mode);
+	}
+
+	vreal_store(&q->x[i], vreal_mul(x, s));
+	vreal_store(&q->y[i], vreal_mul(y, s));
+	vreal_store(&q->z[i], vreal_mul(z, s));
+	vreal_store(&q->w[i], vreal_mul(w, s));
+    }
+
+    return i;
+}
+
+#pragma GCC pop_options
+#endif
+
+typedef struct {
+    quat_soa_t *q;
+    norm_mode_t mode;
+} quat_norm_job_t;
+
+static void
+quat_norm_n_chunk(void *data, int32_t start, int32_t end)
+{
+    quat_norm_job_t *job = data;
+    quat_soa_t *q = job->q;
+    int32_t i = start;
+
+#ifdef MATHLIB_AVX2
+    if (simd_avx2())
+	i = quat_norm_n_avx2(q, start, end, job->mode);
+#endif
+    for (; i < end; i++) {
+	quat_t tmp;
+
+	vec4_set(tmp, q->x[i], q->y[i], q->z[i], q->w[i]);
+	quat_norm_mode(tmp, job->mode);
+	q->x[i] = tmp[X];
+	q->y[i] = tmp[Y];
+	q->z[i] = tmp[Z];
+	q->w[i] = tmp[W];
+    }
+}
+
+/* normalize n quaternions in place, see norm_mode_t */
+void
+quat_norm_n(quat_soa_t *q, int32_t n, norm_mode_t mode)
+{
+    quat_norm_job_t job;
+
+    job.q    = q;
+    job.mode = mode;
+
+    batch_run(quat_norm_n_chunk, &job, n);
+}
+
+#ifdef MATHLIB_AVX2
+#pragma GCC push_options
+#pragma GCC target("avx2,fma")
+
+/* same math as quat_set_euler(), see there */
+static int32_t
+quat_set_euler_n_avx2(vec3_t *angles, quat_soa_t *q, int32_t start,
+	int32_t n, euler_order_t order)
+{
+    const vreal to_half_rad = vreal_set1(G_PI / 360.0);
+    const int8_t *axes = euler_axes[order];
+    // not a choice between vreal_setzero() and vreal_signmask() to xor
+    // in: with no signed zeros (-ffast-math) gcc takes both for 0.0 and
+    // merges the two, so the handedness is multiplied in instead
+    const vreal hand = vreal_set1(axes[3] ? 1.0 : -1.0);
+    real *out[3] = { q->x, q->y, q->z };
+    int a = axes[0], b = axes[1], c = axes[2];
+    int32_t i;
+
+    for (i = start; i + VREAL_WIDTH <= n; i += VREAL_WIDTH) {
+	vreal ang[3], sn[3], cs[3];
+	vreal ccb, scb, csb, ssb;
+
+	vreal_load3(&angles[i][0], &ang[X], &ang[Y], &ang[Z]);
+	vreal_sincos(vreal_mul(ang[X], to_half_rad), &sn[X], &cs[X]);
+	vreal_sincos(vreal_mul(ang[Y], to_half_rad), &sn[Y], &cs[Y]);
+	vreal_sincos(vreal_mul(ang[Z], to_half_rad), &sn[Z], &cs[Z]);
+
+	ccb = vreal_mul(cs[c], cs[b]);
+	scb = vreal_mul(sn[c], cs[b]);
+	csb = vreal_mul(cs[c], sn[b]);
+	ssb = vreal_mul(sn[c], sn[b]);
+
+	vreal_store(&q->w[i], vreal_madd(vreal_mul(ssb, hand), sn[a],
+					 vreal_mul(ccb, cs[a])));
+	vreal_store(&out[a][i], vreal_nmadd(vreal_mul(ssb, hand), cs[a],
+					    vreal_mul(ccb, sn[a])));
+	vreal_store(&out[b][i], vreal_madd(vreal_mul(scb, hand), sn[a],
+					   vreal_mul(csb, cs[a])));
+	vreal_store(&out[c][i], vreal_nmadd(vreal_mul(csb, hand), sn[a],
+					    vreal_mul(scb, cs[a])));
+    }
+
+    return i;
+}
+
+#pragma GCC pop_options
+#endif
+
+typedef struct {
+    vec3_t *angles;
+    quat_soa_t *q;
+    euler_order_t order;
+} quat_set_euler_job_t;
+
+static void
+quat_set_euler_n_chunk(void *data, int32_t start, int32_t end)
+{
+    quat_set_euler_job_t *job = data;
+    quat_soa_t *q = job->q;
+    int32_t i = start;
+
+#ifdef MATHLIB_AVX2
+    if (simd_avx2())
+	i = quat_set_euler_n_avx2(job->angles, q, start, end, job->order);
+#endif
+    for (; i < end; i++) {
+	quat_t tmp;
+
+	quat_set_euler(tmp, job->angles[i][X], job->angles[i][Y],
+		       job->angles[i][Z], job->order);
+	q->x[i] = tmp[X];
+	q->y[i] = tmp[Y];
+	q->z[i] = tmp[Z];
+	q->w[i] = tmp[W];
+    }
+}
+
+/*
+ * build n quaternions from euler angles in degrees, one x, y, z triple
+ * per quaternion, see quat_set_euler()
+ */
+void
+quat_set_euler_n(vec3_t *angles, quat_soa_t *q, int32_t n,
+	euler_order_t order)
+{
+    quat_set_euler_job_t job;
+
+    job.angles = angles;
+    job.q      = q;
+    job.order  = order;
+
+    batch_run(quat_set_euler_n_chunk, &job, n);
+}
+
+/******************************************************************************
+ *
+ * Vector Functions
+ *
+ *****************************************************************************/
+
+#ifdef MATHLIB_AVX2
+#pragma GCC push_options
+#pragma GCC target("avx2,fma")
+
+static int32_t
+vec3_norm_n_avx2(vec3_t *v, int32_t start, int32_t n, norm_mode_t mode)
+{
+    int32_t i;
+
+    for (i = start; i + VREAL_WIDTH <= n; i += VREAL_WIDTH) {
+	vreal x, y, z, len2, s;
+
+	vreal_load3(v[i], &x, &y, &z);
+
+	len2 = vreal_mul(x, x);
+	len2 = vreal_madd(y, y, len2);
+	len2 = vreal_madd(z, z, len2);
+
+	if (mode == NORM_EXACT) {
+	    // vec3_norm() divides by the length
+	    s = vreal_sqrt(len2);
+	    x = vreal_div(x, s);
+	    y = vreal_div(y, s);
+	    z = vreal_div(z, s);
+	} else {
+	    s = norm_scale_avx2(len2, mode);
+	    x = vreal_mul(x, s);
+	    y = vreal_mul(y, s);
+	    z = vreal_mul(z, s);
+	}
+
+	vreal_store3(v[i], x, y, z);
+    }
+
+    return i;
+}
+
+#pragma GCC pop_options
+#endif
+
+typedef struct {
+    vec3_t *v;
+    norm_mode_t mode;
+} vec3_norm_job_t;
+
+static void
+vec3_norm_n_chunk(void *data, int32_t start, int32_t end)
+{
+    vec3_norm_job_t *job = data;
+    int32_t i = start;
+
+#ifdef MATHLIB_AVX2
+    if (simd_avx2())
+	i = vec3_norm_n_avx2(job->v, start, end, job->mode);
+#endif
+    for (; i < end; i++)
+	vec3_norm_mode(job->v[i], job->mode);
+}
+
+/* normalize n vectors in place, see norm_mode_t */
+void
+vec3_norm_n(vec3_t *v, int32_t n, norm_mode_t mode)
+{
+    vec3_norm_job_t job;
+
+    job.v    = v;
+    job.mode = mode;
+
+    batch_run(vec3_norm_n_chunk, &job, n);
+}
+
+typedef struct {
+    vec3_t *in;
+    vec3_t *out;
+    real *m;
+} vec3_transform_job_t;
+
+/* same math as vec3_transform() */
+static void
+vec3_transform_n_scalar(vec3_t *in, vec3_t *out, real *m,
+	int32_t start, int32_t n)
+{
+    int32_t i;
+
+    for (i = start; i < n; i++) {
+	real vx = in[i][X];
+	real vy = in[i][Y];
+	real vz = in[i][Z];
+
+	out[i][X] = vx * M(0, 0) + vy * M(0, 1) + vz * M(0, 2) + M(0, 3);
+	out[i][Y] = vx * M(1, 0) + vy * M(1, 1) + vz * M(1, 2) + M(1, 3);
+	out[i][Z] = vx * M(2, 0) + vy * M(2, 1) + vz * M(2, 2) + M(2, 3);
+    }
+}
+
+#ifdef MATHLIB_AVX2
+#pragma GCC push_options
+#pragma GCC target("avx2,fma")
+
+static int32_t
+vec3_transform_n_avx2(vec3_t *in, vec3_t *out, real *m,
+	int32_t start, int32_t n)
+{
+    vreal m00 = vreal_set1(M(0, 0)), m01 = vreal_set1(M(0, 1));
+    vreal m02 = vreal_set1(M(0, 2)), m03 = vreal_set1(M(0, 3));
+    vreal m10 = vreal_set1(M(1, 0)), m11 = vreal_set1(M(1, 1));
+    vreal m12 = vreal_set1(M(1, 2)), m13 = vreal_set1(M(1, 3));
+    vreal m20 = vreal_set1(M(2, 0)), m21 = vreal_set1(M(2, 1));
+    vreal m22 = vreal_set1(M(2, 2)), m23 = vreal_set1(M(2, 3));
+    int32_t i;
+
+    for (i = start; i + VREAL_WIDTH <= n; i += VREAL_WIDTH) {
+	vreal vx, vy, vz, rx, ry, rz;
+
+	vreal_load3(in[i], &vx, &vy, &vz);
+
+	rx = vreal_mul(vx, m00);
+	rx = vreal_madd(vy, m01, rx);
+	rx = vreal_madd(vz, m02, rx);
+	rx = vreal_add(rx, m03);
+
+	ry = vreal_mul(vx, m10);
+	ry = vreal_madd(vy, m11, ry);
+	ry = vreal_madd(vz, m12, ry);
+	ry = vreal_add(ry, m13);
+
+	rz = vreal_mul(vx, m20);
+	rz = vreal_madd(vy, m21, rz);
+	rz = vreal_madd(vz, m22, rz);
+	rz = vreal_add(rz, m23);
+
+	vreal_store3(out[i], rx, ry, rz);
+    }
+
+    return i;
+}
+
+#pragma GCC pop_options
+#endif
+
+static void
+vec3_transform_n_chunk(void *data, int32_t start, int32_t end)
+{
+    vec3_transform_job_t *job = data;
+    int32_t i = start;
+
+#ifdef MATHLIB_AVX2
+    if (simd_avx2())
+	i = vec3_transform_n_avx2(job->in, job->out, job->m, start, end);
+#endif
+    vec3_transform_n_scalar(job->in, job->out, job->m, i, end);
+}
+
+/*
+ * transform n vectors by a matrix, writing the results to out. in is
+ * only read, so out may either be the same array or a separate one
+ * (but not a partially overlapping one). Large arrays are split
+ * between the worker threads.
+ */
+void
+vec3_transform_n(vec3_t *in, vec3_t *out, int32_t n, mat4x4_t m)
+{
+    vec3_transform_job_t job;
+
+    job.in  = in;
+    job.out = out;
+    job.m   = m;
+
+    batch_run(vec3_transform_n_chunk, &job, n);
+}
+
+typedef struct {
+    vec3_t *obj;
+    vec3_t *win;
+    uint8_t *clip;
+    real *m;
+    int32_t *viewport;
+    volatile gint visible;
+} project_job_t;
+
+/* same math as project(), but with model & proj already multiplied */
+static int32_t
+project_n_scalar(project_job_t *job, int32_t start, int32_t n)
+{
+    real *m = job->m;
+    int32_t *viewport = job->viewport;
+    int32_t i, visible = 0;
+
+    for (i = start; i < n; i++) {
+	real vx = job->obj[i][X];
+	real vy = job->obj[i][Y];
+	real vz = job->obj[i][Z];
+	real cx, cy, cz, cw;
+	uint8_t clip = 0;
+
+	cx = vx * M(0, 0) + vy * M(0, 1) + vz * M(0, 2) + M(0, 3);
+	cy = vx * M(1, 0) + vy * M(1, 1) + vz * M(1, 2) + M(1, 3);
+	cz = vx * M(2, 0) + vy * M(2, 1) + vz * M(2, 2) + M(2, 3);
+	cw = vx * M(3, 0) + vy * M(3, 1) + vz * M(3, 2) + M(3, 3);
+
+	if (cx < -cw) clip |= CLIP_LEFT;
+	if (cx >  cw) clip |= CLIP_RIGHT;
+	if (cy < -cw) clip |= CLIP_BOTTOM;
+	if (cy >  cw) clip |= CLIP_TOP;
+	if (cz < -cw) clip |= CLIP_NEAR;
+	if (cz >  cw) clip |= CLIP_FAR;
+	if (cw <= 0)  clip |= CLIP_W;
+
+	cx /= cw;
+	cy /= cw;
+	cz /= cw;
+
+	job->win[i][X] = viewport[0] + (1 + cx) * viewport[2] / 2;
+	job->win[i][Y] = viewport[1] + (1 + cy) * viewport[3] / 2;
+	job->win[i][Z] = (1 + cz) / 2;
+
+	if (job->clip != NULL)
+	    job->clip[i] = clip;
+	if (clip == 0)
+	    visible++;
+    }
+
+    return visible;
+}
+
+#ifdef MATHLIB_AVX2
+#pragma GCC push_options
+#pragma GCC target("avx2,fma")
+
+/*
+ * turn the low 8 bits of mask into 8 bytes of 0 or 1, so the clip flags
+ * of every point can be built with a few shifts instead of a loop
+ */
+static inline uint64_t
+clip_spread(int mask)
+{
+    uint64_t t = (uint64_t)(mask & 0xff) * 0x0101010101010101ULL;
+
+    t &= 0x8040201008040201ULL;
+    return ((t + 0x7f7f7f7f7f7f7f7fULL) >> 7) & 0x0101010101010101ULL;
+}
+
+static int32_t
+project_n_avx2(project_job_t *job, int32_t *start, int32_t n)
+{
+    real *m = job->m;
+    int32_t *viewport = job->viewport;
+    vreal m00 = vreal_set1(M(0, 0)), m01 = vreal_set1(M(0, 1));
+    vreal m02 = vreal_set1(M(0, 2)), m03 = vreal_set1(M(0, 3));
+    vreal m10 = vreal_set1(M(1, 0)), m11 = vreal_set1(M(1, 1));
+    vreal m12 = vreal_set1(M(1, 2)), m13 = vreal_set1(M(1, 3));
+    vreal m20 = vreal_set1(M(2, 0)), m21 = vreal_set1(M(2, 1));
+    vreal m22 = vreal_set1(M(2, 2)), m23 = vreal_set1(M(2, 3));
+    vreal m30 = vreal_set1(M(3, 0)), m31 = vreal_set1(M(3, 1));
+    vreal m32 = vreal_set1(M(3, 2)), m33 = vreal_set1(M(3, 3));
+    vreal vp0 = vreal_set1(viewport[0]), vp1 = vreal_set1(viewport[1]);
+    vreal vp2 = vreal_set1(viewport[2]), vp3 = vreal_set1(viewport[3]);
+    const vreal zero = vreal_setzero(), one = vreal_set1(1.0);
+    const vreal half = vreal_set1(0.5), sign = vreal_signmask();
+    int32_t i, visible = 0;
+
+    for (i = *start; i + VREAL_WIDTH <= n; i += VREAL_WIDTH) {
+	vreal vx, vy, vz, cx, cy, cz, cw, ncw;
+	uint64_t flags;
+
+	vreal_load3(job->obj[i], &vx, &vy, &vz);
+
+	cx = vreal_mul(vx, m00);
+	cx = vreal_madd(vy, m01, cx);
+	cx = vreal_madd(vz, m02, cx);
+	cx = vreal_add(cx, m03);
+
+	cy = vreal_mul(vx, m10);
+	cy = vreal_madd(vy, m11, cy);
+	cy = vreal_madd(vz, m12, cy);
+	cy = vreal_add(cy, m13);
+
+	cz = vreal_mul(vx, m20);
+	cz = vreal_madd(vy, m21, cz);
+	cz = vreal_madd(vz, m22, cz);
+	cz = vreal_add(cz, m23);
+
+	cw = vreal_mul(vx, m30);
+	cw = vreal_madd(vy, m31, cw);
+	cw = vreal_madd(vz, m32, cw);
+	cw = vreal_add(cw, m33);
+
+	ncw = vreal_xor(cw, sign);
+	flags  = clip_spread(vreal_movemask(vreal_cmplt(cx, ncw))) * CLIP_LEFT;
+	flags |= clip_spread(vreal_movemask(vreal_cmpgt(cx, cw)))  * CLIP_RIGHT;
+	flags |= clip_spread(vreal_movemask(vreal_cmplt(cy, ncw))) * CLIP_BOTTOM;
+	flags |= clip_spread(vreal_movemask(vreal_cmpgt(cy, cw)))  * CLIP_TOP;
+	flags |= clip_spread(vreal_movemask(vreal_cmplt(cz, ncw))) * CLIP_NEAR;
+	flags |= clip_spread(vreal_movemask(vreal_cmpgt(cz, cw)))  * CLIP_FAR;
+	flags |= clip_spread(vreal_movemask(vreal_cmple(cw, zero))) * CLIP_W;
+
+	if (job->clip != NULL)
+	    memcpy(&job->clip[i], &flags, VREAL_WIDTH);
+
+	// count the zero bytes
+	flags |= flags >> 4;
+	flags |= flags >> 2;
+	flags |= flags >> 1;
+	flags &= 0x0101010101010101ULL >> (64 - VREAL_WIDTH * 8);
+	visible += VREAL_WIDTH - __builtin_popcountll(flags);
+
+	cx = vreal_div(cx, cw);
+	cy = vreal_div(cy, cw);
+	cz = vreal_div(cz, cw);
+
+	cx = vreal_add(vp0, vreal_mul(vreal_mul(vreal_add(one, cx), vp2), half));
+	cy = vreal_add(vp1, vreal_mul(vreal_mul(vreal_add(one, cy), vp3), half));
+	cz = vreal_mul(vreal_add(one, cz), half);
+
+	vreal_store3(job->win[i], cx, cy, cz);
+    }
+
+    *start = i;
+    return visible;
+}
+
+#pragma GCC pop_options
+#endif
+
+static void
+project_n_chunk(void *data, int32_t start, int32_t end)
+{
+    project_job_t *job = data;
+    int32_t i = start, visible = 0;
+
+#ifdef MATHLIB_AVX2
+    if (simd_avx2())
+	visible = project_n_avx2(job, &i, end);
+#endif
+    visible += project_n_scalar(job, i, end);
+
+    g_atomic_int_add(&job->visible, visible);
+}
+
+/*
+ * project n points to window coordinates like project() does, but with
+ * proj * model worked out once up front. The window coordinates go to
+ * win, which may be the same array as obj.
+ *
+ * If clip is not NULL it gets the CLIP_* flags of every point, a point
+ * is on screen when its flags are 0. Returns the number of on screen
+ * points.
+ */
+int32_t
+project_n(vec3_t *obj, int32_t n, mat4x4_t model, mat4x4_t proj,
+	int32_t viewport[4], vec3_t *win, uint8_t *clip)
+{
+    project_job_t job;
+    mat4x4_t m;
+
+    mat4x4_mult(proj, model, m);
+
+    job.obj      = obj;
+    job.win      = win;
+    job.clip     = clip;
+    job.m        = m;
+    job.viewport = viewport;
+    job.visible  = 0;
+
+    batch_run(project_n_chunk, &job, n);
+
+    return job.visible;
+}
+
+/******************************************************************************
+ *
+ * Matrix Functions
+ *
+ *****************************************************************************/
+
+/* same math as mat4x4_mult(), but dest may also be m2 */
+static void
+mat4x4_mult_scalar(real *m1, real *m2, real *dest)
+{
+    mat4x4_t tmp;
+
+    mat4x4_mult(m1, m2, tmp);
+    mat4x4_copy(tmp, dest);
+}
+
+#ifdef MATHLIB_AVX2
+#pragma GCC push_options
+#pragma GCC target("avx2,fma")
+
+/*
+ * column j of dest is the columns of m1 scaled by the elements of
+ * column j of m2, so each element of m2 is broadcast across a vector.
+ * All of m1 is loaded first, so dest may be either of the inputs.
+ */
+static inline void
+mat4x4_mult_avx2(real *m1, real *m2, real *dest)
+{
+    v4real c0 = v4real_load(&m1[0]);
+    v4real c1 = v4real_load(&m1[4]);
+    v4real c2 = v4real_load(&m1[8]);
+    v4real c3 = v4real_load(&m1[12]);
+    int j;
+
+    for (j = 0; j < 16; j += 4) {
+	v4real r;
+
+	r = v4real_mul(c0, v4real_set1(m2[j + 0]));
+	r = v4real_madd(c1, v4real_set1(m2[j + 1]), r);
+	r = v4real_madd(c2, v4real_set1(m2[j + 2]), r);
+	r = v4real_madd(c3, v4real_set1(m2[j + 3]), r);
+	v4real_store(&dest[j], r);
+    }
+}
+
+static void
+mat4x4_mult_n_avx2(mat4x4_t *m1, mat4x4_t *m2, mat4x4_t *dest,
+	int32_t start, int32_t end)
+{
+    int32_t i;
+
+    for (i = start; i < end; i++)
+	mat4x4_mult_avx2(m1[i], m2[i], dest[i]);
+}
+
+static void
+mat4x4_mult_indexed_avx2(mat4x4_t *m1, int32_t *index, mat4x4_t *m2,
+	mat4x4_t *dest, int32_t n)
+{
+    int32_t i;
+
+    for (i = 0; i < n; i++) {
+	if (index[i] < 0)
+	    mat4x4_copy(m2[i], dest[i]);
+	else
+	    mat4x4_mult_avx2(m1[index[i]], m2[i], dest[i]);
+    }
+}
+
+#pragma GCC pop_options
+#endif
+
+typedef struct {
+    mat4x4_t *m1;
+    mat4x4_t *m2;
+    mat4x4_t *dest;
+} mat4x4_mult_job_t;
+
+static void
+mat4x4_mult_n_chunk(void *data, int32_t start, int32_t end)
+{
+    mat4x4_mult_job_t *job = data;
+    int32_t i;
+
+#ifdef MATHLIB_AVX2
+    if (simd_avx2()) {
+	mat4x4_mult_n_avx2(job->m1, job->m2, job->dest, start, end);
+	return;
+    }
+#endif
+    for (i = start; i < end; i++)
+	mat4x4_mult_scalar(job->m1[i], job->m2[i], job->dest[i]);
+}
+
+/* dest[i] = m1[i] * m2[i], dest may be the same array as m1 or m2 */
+void
+mat4x4_mult_n(mat4x4_t *m1, mat4x4_t *m2, mat4x4_t *dest, int32_t n)
+{
+    mat4x4_mult_job_t job;
+
+    job.m1   = m1;
+    job.m2   = m2;
+    job.dest = dest;
+
+    batch_run(mat4x4_mult_n_chunk, &job, n);
+}
+
+/*
+ * dest[i] = m1[index[i]] * m2[i], or a copy of m2[i] if index[i] < 0.
+ *
+ * The matrices are done in order, so passing dest as m1 resolves a
+ * flattened hierarchy in a single pass as long as every parent is
+ * stored before its children:
+ *
+ *     mat4x4_mult_indexed(world, parent, local, world, n);
+ */
+void
+mat4x4_mult_indexed(mat4x4_t *m1, int32_t *index, mat4x4_t *m2,
+	mat4x4_t *dest, int32_t n)
+{
+    int32_t i;
+
+#ifdef MATHLIB_AVX2
+    if (simd_avx2()) {
+	mat4x4_mult_indexed_avx2(m1, index, m2, dest, n);
+	return;
+    }
+#endif
+    for (i = 0; i < n; i++) {
+	if (index[i] < 0)
+	    mat4x4_copy(m2[i], dest[i]);
+	else
+	    mat4x4_mult_scalar(m1[index[i]], m2[i], dest[i]);
+    }
+}
+
+#ifdef MATHLIB_AVX2
+#pragma GCC push_options
+#pragma GCC target("avx2,fma")
+
+/*
+ * same math as mat4x4_to_quat(), but all four cases are computed and
+ * the one for the largest component is picked with blends instead of
+ * branches. Every case only uses the diagonal sums and the off diagonal
+ * sums & differences below, so there is little extra work.
+ */
+static int32_t
+mat4x4_to_quat_n_avx2(mat4x4_t *m, quat_soa_t *q, int32_t start, int32_t n)
+{
+    const vreal one = vreal_set1(1.0), half = vreal_set1(0.5);
+    const vreal sign = vreal_signmask();
+    int32_t i;
+
+    for (i = start; i + VREAL_WIDTH <= n; i += VREAL_WIDTH) {
+	vreal m00, m10, m20, m01, m11, m21, m02, m12, m22, unused;
+	vreal tw, tx, ty, tz, a, b, c, d, e, f;
+	vreal cw, cx, cy, t, s, x, y, z, w;
+
+	// columns 0-2 of every matrix, one row per vector
+	vreal_load4t(&m[i][0], 16, &m00, &m10, &m20, &unused);
+	vreal_load4t(&m[i][4], 16, &m01, &m11, &m21, &unused);
+	vreal_load4t(&m[i][8], 16, &m02, &m12, &m22, &unused);
+
+	tw = vreal_add(vreal_add(vreal_add(one, m00), m11), m22);
+	tx = vreal_sub(vreal_sub(vreal_add(one, m00), m11), m22);
+	ty = vreal_sub(vreal_add(vreal_sub(one, m00), m11), m22);
+	tz = vreal_add(vreal_sub(vreal_sub(one, m00), m11), m22);
+
+	a = vreal_sub(m21, m12);	// 4xw
+	b = vreal_sub(m02, m20);	// 4yw
+	c = vreal_sub(m10, m01);	// 4zw
+	d = vreal_add(m10, m01);	// 4xy
+	e = vreal_add(m02, m20);	// 4xz
+	f = vreal_add(m21, m12);	// 4yz
+
+	// same order of tests as the scalar code
+	cy = vreal_cmpge(ty, tz);
+	cx = vreal_and(vreal_cmpge(tx, ty), vreal_cmpge(tx, tz));
+	cw = vreal_and(vreal_and(vreal_cmpge(tw, tx), vreal_cmpge(tw, ty)),
+		       vreal_cmpge(tw, tz));
+
+#define PICK(vz, vy, vx, vw) \
+	vreal_blend(vreal_blend(vreal_blend((vz), (vy), cy), (vx), cx), (vw), cw)
+	t = PICK(tz, ty, tx, tw);
+	x = PICK(e,  d,  tx, a);
+	y = PICK(f,  ty, d,  b);
+	z = PICK(tz, f,  e,  c);
+	w = PICK(c,  b,  a,  tw);
+#undef PICK
+
+	s = vreal_div(half, vreal_sqrt(t));
+
+	// flip the signs of all four where w is negative
+	w = vreal_mul(w, s);
+	t = vreal_and(w, sign);
+	vreal_store(&q->x[i], vreal_xor(vreal_mul(x, s), t));
+	vreal_store(&q->y[i], vreal_xor(vreal_mul(y, s), t));
+	vreal_store(&q->z[i], vreal_xor(vreal_mul(z, s), t));
+	vreal_store(&q->w[i], vreal_xor(w, t));
+    }
+
+    return i;
+}
+
+#pragma GCC pop_options
+#endif
+
+typedef struct {
+    mat4x4_t *m;
+    quat_soa_t *q;
+} mat4x4_to_quat_job_t;
+
+static void
+mat4x4_to_quat_n_chunk(void *data, int32_t start, int32_t end)
+{
+    mat4x4_to_quat_job_t *job = data;
+    quat_soa_t *q = job->q;
+    int32_t i = start;
+
+#ifdef MATHLIB_AVX2
+    if (simd_avx2())
+	i = mat4x4_to_quat_n_avx2(job->m, q, start, end);
+#endif
+    for (; i < end; i++) {
+	quat_t tmp;
+
+	mat4x4_to_quat(job->m[i], tmp);
+	q->x[i] = tmp[X];
+	q->y[i] = tmp[Y];
+	q->z[i] = tmp[Z];
+	q->w[i] = tmp[W];
+    }
+}
+
+/* convert n rotation matrices to quaternions, see mat4x4_to_quat() */
+void
+mat4x4_to_quat_n(mat4x4_t *m, quat_soa_t *q, int32_t n)
+{
+    mat4x4_to_quat_job_t job;
+
+    job.m = m;
+    job.q = q;
+
+    batch_run(mat4x4_to_quat_n_chunk, &job, n);
+}
+
+#ifdef MATHLIB_AVX2
+#pragma GCC push_options
+#pragma GCC target("avx2,fma")
+
+/* a*b - c*d */
+#define vreal_det2(a,b,c,d)	vreal_nmadd((c), (d), vreal_mul((a), (b)))
+
+/* a*b - c*d + e*f */
+#define vreal_det3(a,b,c,d,e,f) \
+	vreal_madd((e), (f), vreal_nmadd((c), (d), vreal_mul((a), (b))))
+
+/* |a| + |b| + |c| + |d|, sign has just the sign bits set */
+#define vreal_abssum4(sign,a,b,c,d) \
+	vreal_add(vreal_add(vreal_add(vreal_andnot((sign), (a)), \
+				      vreal_andnot((sign), (b))), \
+			    vreal_andnot((sign), (c))), vreal_andnot((sign), (d)))
+
+#define vreal_store4t_masked(p,a,b,c,d,mask) \
+	vreal_store4t((p), 16, vreal_and((a), (mask)), vreal_and((b), (mask)), \
+		      vreal_and((c), (mask)), vreal_and((d), (mask)))
+
+/*
+ * same math as mat4x4_inv(), on VREAL_WIDTH matrices at a time with
+ * each element of the matrix in its own vector. Singular matrices are
+ * zeroed, returns how many there were.
+ */
+static int32_t
+mat4x4_inv_n_avx2(mat4x4_t *m, mat4x4_t *dest, int32_t *start, int32_t n)
+{
+    const vreal one = vreal_set1(1.0), sign = vreal_signmask();
+    const vreal eps = vreal_set1(MAT4X4_SINGULAR_EPSILON);
+    int32_t i, singular = 0;
+
+    for (i = *start; i + VREAL_WIDTH <= n; i += VREAL_WIDTH) {
+	vreal a00, a01, a02, a03, a10, a11, a12, a13;
+	vreal a20, a21, a22, a23, a30, a31, a32, a33;
+	vreal s0, s1, s2, s3, s4, s5, c0, c1, c2, c3, c4, c5;
+	vreal det, bound, ok, inv, ninv, r0, r1, r2, r3;
+
+	vreal_load4t(&m[i][0],  16, &a00, &a10, &a20, &a30);
+	vreal_load4t(&m[i][4],  16, &a01, &a11, &a21, &a31);
+	vreal_load4t(&m[i][8],  16, &a02, &a12, &a22, &a32);
+	vreal_load4t(&m[i][12], 16, &a03, &a13, &a23, &a33);
+
+	s0 = vreal_det2(a00, a11, a10, a01);
+	s1 = vreal_det2(a00, a12, a10, a02);
+	s2 = vreal_det2(a00, a13, a10, a03);
+	s3 = vreal_det2(a01, a12, a11, a02);
+	s4 = vreal_det2(a01, a13, a11, a03);
+	s5 = vreal_det2(a02, a13, a12, a03);
+
+	c5 = vreal_det2(a22, a33, a32, a23);
+	c4 = vreal_det2(a21, a33, a31, a23);
+	c3 = vreal_det2(a21, a32, a31, a22);
+	c2 = vreal_det2(a20, a33, a30, a23);
+	c1 = vreal_det2(a20, a32, a30, a22);
+	c0 = vreal_det2(a20, a31, a30, a21);
+
+	det = vreal_mul(s0, c5);
+	det = vreal_nmadd(s1, c4, det);
+	det = vreal_madd(s2, c3, det);
+	det = vreal_madd(s3, c2, det);
+	det = vreal_nmadd(s4, c1, det);
+	det = vreal_madd(s5, c0, det);
+
+	// the same test as mat4x4_inv()
+	bound = vreal_mul(vreal_abssum4(sign, a00, a01, a02, a03),
+			  vreal_abssum4(sign, a10, a11, a12, a13));
+	bound = vreal_mul(bound, vreal_mul(vreal_abssum4(sign, a20, a21, a22, a23),
+					   vreal_abssum4(sign, a30, a31, a32, a33)));
+	ok = vreal_cmpgt(vreal_andnot(sign, det), vreal_mul(bound, eps));
+	singular += __builtin_popcount(~vreal_movemask(ok) &
+				       ((1 << VREAL_WIDTH) - 1));
+
+	// the singular ones are masked to zero after the divide
+	inv = vreal_div(one, det);
+	ninv = vreal_xor(inv, sign);
+
+	// one column of the result at a time
+	r0 = vreal_mul(vreal_det3(a11, c5, a12, c4, a13, c3), inv);
+	r1 = vreal_mul(vreal_det3(a10, c5, a12, c2, a13, c1), ninv);
+	r2 = vreal_mul(vreal_det3(a10, c4, a11, c2, a13, c0), inv);
+	r3 = vreal_mul(vreal_det3(a10, c3, a11, c1, a12, c0), ninv);
+	vreal_store4t_masked(&dest[i][0], r0, r1, r2, r3, ok);
+
+	r0 = vreal_mul(vreal_det3(a01, c5, a02, c4, a03, c3), ninv);
+	r1 = vreal_mul(vreal_det3(a00, c5, a02, c2, a03, c1), inv);
+	r2 = vreal_mul(vreal_det3(a00, c4, a01, c2, a03, c0), ninv);
+	r3 = vreal_mul(vreal_det3(a00, c3, a01, c1, a02, c0), inv);
+	vreal_store4t_masked(&dest[i][4], r0, r1, r2, r3, ok);
+
+	r0 = vreal_mul(vreal_det3(a31, s5, a32, s4, a33, s3), inv);
+	r1 = vreal_mul(vreal_det3(a30, s5, a32, s2, a33, s1), ninv);
+	r2 = vreal_mul(vreal_det3(a30, s4, a31, s2, a33, s0), inv);
+	r3 = vreal_mul(vreal_det3(a30, s3, a31, s1, a32, s0), ninv);
+	vreal_store4t_masked(&dest[i][8], r0, r1, r2, r3, ok);
+
+	r0 = vreal_mul(vreal_det3(a21, s5, a22, s4, a23, s3), ninv);
+	r1 = vreal_mul(vreal_det3(a20, s5, a22, s2, a23, s1), inv);
+	r2 = vreal_mul(vreal_det3(a20, s4, a21, s2, a23, s0), ninv);
+	r3 = vreal_mul(vreal_det3(a20, s3, a21, s1, a22, s0), inv);
+	vreal_store4t_masked(&dest[i][12], r0, r1, r2, r3, ok);
+    }
+
+    *start = i;
+    return singular;
+}
+
+#undef vreal_det2
+#undef vreal_det3
+#undef vreal_abssum4
+#undef vreal_store4t_masked
+
+#pragma GCC pop_options
+#endif
+
+typedef struct {
+    mat4x4_t *m;
+    mat4x4_t *dest;
+    volatile gint singular;
+} mat4x4_inv_job_t;
+
+static void
+mat4x4_inv_n_chunk(void *data, int32_t start, int32_t end)
+{
+    mat4x4_inv_job_t *job = data;
+    int32_t i = start, singular = 0;
+
+#ifdef MATHLIB_AVX2
+    if (simd_avx2())
+	singular = mat4x4_inv_n_avx2(job->m, job->dest, &i, end);
+#endif
+    for (; i < end; i++) {
+	if (!mat4x4_inv(job->m[i], job->dest[i])) {
+	    mat4x4_zero(job->dest[i]);
+	    singular++;
+	}
+    }
+
+    if (singular)
+	g_atomic_int_add(&job->singular, singular);
+}
+
+/*
+ * invert n matrices with mat4x4_inv(), dest may be the same array as m.
+ * Singular matrices have no inverse and are set to all zeros in dest,
+ * returns how many there were.
+ */
+int32_t
+mat4x4_inv_n(mat4x4_t *m, mat4x4_t *dest, int32_t n)
+{
+    mat4x4_inv_job_t job;
+
+    job.m = m;
+    job.dest = dest;
+    job.singular = 0;
+
+    batch_run(mat4x4_inv_n_chunk, &job, n);
+
+    return job.singular;
+}
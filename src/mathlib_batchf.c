@@ -0,0 +1,31 @@
+/*
+ *  Name: mathlib_batchf.c
+ *  Description: Single precision build of mathlib_batch.c
+ *
+ *  Copyright (C) 2012  Jason Hall
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Compiles mathlib_batch.c again with real defined as float and every function
+ * renamed to its float spelling (see mathlib_float.h).
+ */
+
+#define MATHLIB_FLOAT
+
+#include "mathlib.h"
+#include "mathlib_float.h"
+
+#include "mathlib_batch.c"
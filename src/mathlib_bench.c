@@ -0,0 +1,676 @@
+/*
+ *  Name: mathlib_bench.c
+ *  Description: Microbenchmarks for the math library (make bench)
+ *
+ *  Copyright (C) 2012  Jason Hall
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Every benchmark runs over arrays sized to fit in L1, L2 and L3 cache
+ * and to spill into memory, and is timed over several samples. For each
+ * one the median, minimum and standard deviation of the time per
+ * operation are reported along with the throughput, as a table on
+ * stdout and optionally as JSON for comparing runs:
+ *
+ *	mathlib_bench [--json FILE] [--quick] [--threads N] [--no-simd]
+ *		[--filter NAME]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* sysconf() */
+#include <unistd.h>
+
+#include "mathlib.h"
+#include "mathlib_simd.h"
+
+#define SAMPLES		9
+#define QUICK_SAMPLES	3
+#define MIN_SAMPLE_NS	2000000.0	// 2 ms
+#define QUICK_SAMPLE_NS	500000.0
+
+typedef struct {
+    int32_t n;
+
+    vec3_t *v1, *v2;
+    vec3f_t *vf1, *vf2;
+    quat_t *q1, *q2;
+    quat_soa_t qs1, qs2, qs3;
+    quatf_soa_t qfs1, qfs2, qfs3;
+    mat4x4_t *m1, *m2, *m3;
+    mat4x4f_t *mf1, *mf2, *mf3;
+    uint8_t *clip;
+
+    mat4x4_t rot, model, proj;
+    mat4x4f_t rotf;
+    int32_t viewport[4];
+} bench_data_t;
+
+/* the arrays of bench_data_t a benchmark needs */
+#define USE_VEC		0x01	// v1, v2
+#define USE_VECF	0x02	// vf1, vf2
+#define USE_QUAT	0x04	// q1, q2
+#define USE_QUAT_SOA	0x08	// qs1, qs2, qs3
+#define USE_QUATF_SOA	0x10	// qfs1, qfs2, qfs3
+#define USE_MAT		0x20	// m1, m2, m3
+#define USE_MATF	0x40	// mf1, mf2, mf3
+#define USE_CLIP	0x80
+
+typedef struct {
+    const char *name;
+    void (*run)(bench_data_t *d);
+    size_t footprint;	// bytes of the arrays per operation
+    size_t traffic;	// bytes read and written per operation
+    int uses;
+} bench_t;
+
+typedef struct {
+    const char *level;
+    size_t bytes;
+} bench_size_t;
+
+/* keeps the compiler from optimizing the benchmarks away */
+static volatile real bench_sink;
+
+/******************************************************************************
+ *
+ * Benchmarks
+ *
+ *****************************************************************************/
+static void
+bench_quat_mult(bench_data_t *d)
+{
+    int32_t i;
+
+    for (i = 0; i < d->n; i++)
+	quat_mult(d->q1[i], d->q2[i]);
+    bench_sink = d->q1[0][W];
+}
+
+static void
+bench_quat_to_mat(bench_data_t *d)
+{
+    int32_t i;
+
+    for (i = 0; i < d->n; i++)
+	quat_to_mat(d->q1[i], d->m1[i]);
+    bench_sink = d->m1[0][0];
+}
+
+static void
+bench_quat_set3(bench_data_t *d)
+{
+    int32_t i;
+
+    for (i = 0; i < d->n; i++)
+	quat_set3(d->q1[i], d->v1[i][X], d->v1[i][Y], d->v1[i][Z]);
+    bench_sink = d->q1[0][W];
+}
+
+static void
+bench_mat4x4_mult(bench_data_t *d)
+{
+    int32_t i;
+
+    for (i = 0; i < d->n; i++)
+	mat4x4_mult(d->m1[i], d->m2[i], d->m3[i]);
+    bench_sink = d->m3[0][0];
+}
+
+static void
+bench_vec3_transform(bench_data_t *d)
+{
+    vec3_transform(d->v1, d->n, d->rot);
+    bench_sink = d->v1[0][X];
+}
+
+static void
+bench_vec3_norm(bench_data_t *d)
+{
+    int32_t i;
+
+    for (i = 0; i < d->n; i++)
+	vec3_norm(d->v1[i]);
+    bench_sink = d->v1[0][X];
+}
+
+static void
+bench_quat_mult_n(bench_data_t *d)
+{
+    quat_mult_n(&d->qs1, &d->qs2, &d->qs3, d->n);
+    bench_sink = d->qs3.w[0];
+}
+
+static void
+bench_quatf_mult_n(bench_data_t *d)
+{
+    quatf_mult_n(&d->qfs1, &d->qfs2, &d->qfs3, d->n);
+    bench_sink = d->qfs3.w[0];
+}
+
+static void
+bench_quat_norm_n(bench_data_t *d)
+{
+    quat_norm_n(&d->qs1, d->n, NORM_EXACT);
+    bench_sink = d->qs1.w[0];
+}
+
+static void
+bench_quat_set_euler_n(bench_data_t *d)
+{
+    quat_set_euler_n(d->v1, &d->qs1, d->n, EULER_XYZ);
+    bench_sink = d->qs1.w[0];
+}
+
+static void
+bench_vec3_transform_n(bench_data_t *d)
+{
+    vec3_transform_n(d->v1, d->v2, d->n, d->rot);
+    bench_sink = d->v2[0][X];
+}
+
+static void
+bench_vec3f_transform_n(bench_data_t *d)
+{
+    vec3f_transform_n(d->vf1, d->vf2, d->n, d->rotf);
+    bench_sink = d->vf2[0][X];
+}
+
+static void
+bench_vec3_norm_n(bench_data_t *d)
+{
+    vec3_norm_n(d->v1, d->n, NORM_EXACT);
+    bench_sink = d->v1[0][X];
+}
+
+static void
+bench_vec3_norm_n_fast(bench_data_t *d)
+{
+    vec3_norm_n(d->v1, d->n, NORM_FAST);
+    bench_sink = d->v1[0][X];
+}
+
+static void
+bench_project_n(bench_data_t *d)
+{
+    bench_sink = project_n(d->v1, d->n, d->model, d->proj, d->viewport,
+			   d->v2, d->clip);
+}
+
+static void
+bench_mat4x4_mult_n(bench_data_t *d)
+{
+    mat4x4_mult_n(d->m1, d->m2, d->m3, d->n);
+    bench_sink = d->m3[0][0];
+}
+
+static void
+bench_mat4x4f_mult_n(bench_data_t *d)
+{
+    mat4x4f_mult_n(d->mf1, d->mf2, d->mf3, d->n);
+    bench_sink = d->mf3[0][0];
+}
+
+static void
+bench_mat4x4_inv_n(bench_data_t *d)
+{
+    bench_sink = mat4x4_inv_n(d->m1, d->m3, d->n);
+}
+
+static void
+bench_mat4x4_to_quat_n(bench_data_t *d)
+{
+    mat4x4_to_quat_n(d->m1, &d->qs1, d->n);
+    bench_sink = d->qs1.w[0];
+}
+
+#define QUAT	sizeof(quat_t)
+#define VEC	sizeof(vec3_t)
+#define MAT	sizeof(mat4x4_t)
+#define QUATF	sizeof(quatf_t)
+#define VECF	sizeof(vec3f_t)
+#define MATF	sizeof(mat4x4f_t)
+
+static const bench_t benchmarks[] = {
+    { "quat_mult", bench_quat_mult, 2*QUAT, 3*QUAT, USE_QUAT },
+    { "quat_to_mat", bench_quat_to_mat, QUAT + MAT, QUAT + MAT, USE_QUAT | USE_MAT },
+    { "quat_set3", bench_quat_set3, VEC + QUAT, VEC + QUAT, USE_VEC | USE_QUAT },
+    { "mat4x4_mult", bench_mat4x4_mult, 3*MAT, 3*MAT, USE_MAT },
+    { "vec3_transform", bench_vec3_transform, VEC, 2*VEC, USE_VEC },
+    { "vec3_norm", bench_vec3_norm, VEC, 2*VEC, USE_VEC },
+    { "quat_mult_n", bench_quat_mult_n, 3*QUAT, 3*QUAT, USE_QUAT_SOA },
+    { "quatf_mult_n", bench_quatf_mult_n, 3*QUATF, 3*QUATF, USE_QUATF_SOA },
+    { "quat_norm_n", bench_quat_norm_n, QUAT, 2*QUAT, USE_QUAT_SOA },
+    { "quat_set_euler_n", bench_quat_set_euler_n, VEC + QUAT, VEC + QUAT, USE_VEC | USE_QUAT_SOA },
+    { "vec3_transform_n", bench_vec3_transform_n, 2*VEC, 2*VEC, USE_VEC },
+    { "vec3f_transform_n", bench_vec3f_transform_n, 2*VECF, 2*VECF, USE_VECF },
+    { "vec3_norm_n", bench_vec3_norm_n, VEC, 2*VEC, USE_VEC },
+    { "vec3_norm_n_fast", bench_vec3_norm_n_fast, VEC, 2*VEC, USE_VEC },
+    { "project_n", bench_project_n, 2*VEC + 1, 2*VEC + 1, USE_VEC | USE_CLIP },
+    { "mat4x4_mult_n", bench_mat4x4_mult_n, 3*MAT, 3*MAT, USE_MAT },
+    { "mat4x4f_mult_n", bench_mat4x4f_mult_n, 3*MATF, 3*MATF, USE_MATF },
+    { "mat4x4_inv_n", bench_mat4x4_inv_n, 2*MAT, 2*MAT, USE_MAT },
+    { "mat4x4_to_quat_n", bench_mat4x4_to_quat_n, MAT + QUAT, MAT + QUAT, USE_MAT | USE_QUAT_SOA },
+};
+
+/******************************************************************************
+ *
+ * Test Data
+ *
+ *****************************************************************************/
+static real
+random_real(real lo, real hi)
+{
+    return lo + (hi - lo) * (rand() / (real) RAND_MAX);
+}
+
+static void
+random_quat(quat_t q)
+{
+    quat_set3(q, random_real(-180, 180), random_real(-180, 180),
+	      random_real(-180, 180));
+}
+
+/* a rotation plus a translation, so repeated transforms stay in range */
+static void
+random_rotation(mat4x4_t m)
+{
+    quat_t q;
+
+    random_quat(q);
+    quat_to_mat(q, m);
+    m[12] = random_real(-1, 1);
+    m[13] = random_real(-1, 1);
+    m[14] = random_real(-1, 1);
+}
+
+static void
+bench_data_init(bench_data_t *d, int32_t n, int uses)
+{
+    mat4x4_t tmp;
+    int32_t i;
+
+    memset(d, 0, sizeof(bench_data_t));
+    d->n = n;
+
+    if (uses & USE_VEC) {
+	d->v1 = g_new(vec3_t, n);
+	d->v2 = g_new(vec3_t, n);
+    }
+    if (uses & USE_VECF) {
+	d->vf1 = g_new(vec3f_t, n);
+	d->vf2 = g_new(vec3f_t, n);
+    }
+    if (uses & USE_QUAT) {
+	d->q1 = g_new(quat_t, n);
+	d->q2 = g_new(quat_t, n);
+    }
+    if (uses & USE_MAT) {
+	d->m1 = g_new(mat4x4_t, n);
+	d->m2 = g_new(mat4x4_t, n);
+	d->m3 = g_new(mat4x4_t, n);
+    }
+    if (uses & USE_MATF) {
+	d->mf1 = g_new(mat4x4f_t, n);
+	d->mf2 = g_new(mat4x4f_t, n);
+	d->mf3 = g_new(mat4x4f_t, n);
+    }
+    if (uses & USE_CLIP)
+	d->clip = g_new(uint8_t, n);
+
+#define SOA_NEW(soa, type) do { \
+	(soa).x = g_new(type, n); (soa).y = g_new(type, n); \
+	(soa).z = g_new(type, n); (soa).w = g_new(type, n); } while (0)
+    if (uses & USE_QUAT_SOA) {
+	SOA_NEW(d->qs1, real);
+	SOA_NEW(d->qs2, real);
+	SOA_NEW(d->qs3, real);
+    }
+    if (uses & USE_QUATF_SOA) {
+	SOA_NEW(d->qfs1, realf);
+	SOA_NEW(d->qfs2, realf);
+	SOA_NEW(d->qfs3, realf);
+    }
+#undef SOA_NEW
+
+    for (i = 0; i < n; i++) {
+	vec3_t v;
+	quat_t q1, q2;
+	mat4x4_t m1, m2;
+
+	vec3_set(v, random_real(-10, 10), random_real(-10, 10),
+		 random_real(-10, 10));
+	random_quat(q1);
+	random_quat(q2);
+	random_rotation(m1);
+	random_rotation(m2);
+
+	if (uses & USE_VEC)
+	    vec3_cp(v, d->v1[i]);
+	if (uses & USE_VECF)
+	    vec3_to_vec3f(v, d->vf1[i]);
+	if (uses & USE_QUAT) {
+	    quat_cp(q1, d->q1[i]);
+	    quat_cp(q2, d->q2[i]);
+	}
+	if (uses & USE_MAT) {
+	    mat4x4_copy(m1, d->m1[i]);
+	    mat4x4_copy(m2, d->m2[i]);
+	}
+	if (uses & USE_MATF) {
+	    mat4x4_to_mat4x4f(m1, d->mf1[i]);
+	    mat4x4_to_mat4x4f(m2, d->mf2[i]);
+	}
+	if (uses & USE_QUAT_SOA) {
+	    d->qs1.x[i] = q1[X];
+	    d->qs1.y[i] = q1[Y];
+	    d->qs1.z[i] = q1[Z];
+	    d->qs1.w[i] = q1[W];
+	    d->qs2.x[i] = q2[X];
+	    d->qs2.y[i] = q2[Y];
+	    d->qs2.z[i] = q2[Z];
+	    d->qs2.w[i] = q2[W];
+	}
+	if (uses & USE_QUATF_SOA) {
+	    d->qfs1.x[i] = q1[X];
+	    d->qfs1.y[i] = q1[Y];
+	    d->qfs1.z[i] = q1[Z];
+	    d->qfs1.w[i] = q1[W];
+	    d->qfs2.x[i] = q2[X];
+	    d->qfs2.y[i] = q2[Y];
+	    d->qfs2.z[i] = q2[Z];
+	    d->qfs2.w[i] = q2[W];
+	}
+    }
+
+    random_rotation(d->rot);
+    mat4x4_to_mat4x4f(d->rot, d->rotf);
+
+    // a 60 degree perspective, with the points placed in front of it
+    mat4x4_zero(d->proj);
+    d->proj[0]  = 1.732;
+    d->proj[5]  = 1.732;
+    d->proj[10] = -1.02;
+    d->proj[11] = -1.0;
+    d->proj[14] = -2.02;
+    mat4x4_id(tmp);
+    mat4x4_translate(tmp, 0, 0, -30);
+    mat4x4_mult(tmp, d->rot, d->model);
+    vec4_set(d->viewport, 0, 0, 1280, 1024);
+}
+
+static void
+bench_data_free(bench_data_t *d)
+{
+    g_free(d->v1);
+    g_free(d->v2);
+    g_free(d->vf1);
+    g_free(d->vf2);
+    g_free(d->q1);
+    g_free(d->q2);
+    g_free(d->m1);
+    g_free(d->m2);
+    g_free(d->m3);
+    g_free(d->mf1);
+    g_free(d->mf2);
+    g_free(d->mf3);
+    g_free(d->clip);
+
+#define SOA_FREE(soa) do { \
+	g_free((soa).x); g_free((soa).y); g_free((soa).z); g_free((soa).w); \
+    } while (0)
+    SOA_FREE(d->qs1);
+    SOA_FREE(d->qs2);
+    SOA_FREE(d->qs3);
+    SOA_FREE(d->qfs1);
+    SOA_FREE(d->qfs2);
+    SOA_FREE(d->qfs3);
+#undef SOA_FREE
+}
+
+/******************************************************************************
+ *
+ * Timing
+ *
+ *****************************************************************************/
+static double
+now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static int
+compare_double(const void *a, const void *b)
+{
+    double x = *(const double *) a, y = *(const double *) b;
+
+    return (x > y) - (x < y);
+}
+
+typedef struct {
+    int32_t n;
+    int reps;
+    int samples;
+    double median;	// ns per operation
+    double min;
+    double mean;
+    double stddev;
+} bench_result_t;
+
+/*
+ * time one benchmark. The number of passes per sample is doubled until a
+ * sample takes at least min_ns, after a warm up pass.
+ */
+static void
+bench_time(const bench_t *b, bench_data_t *d, int samples, double min_ns,
+	bench_result_t *res)
+{
+    double t[SAMPLES], start, sum = 0, sum2 = 0;
+    int i, r, reps = 1;
+
+    b->run(d);
+
+    for (;;) {
+	start = now_ns();
+	for (r = 0; r < reps; r++)
+	    b->run(d);
+	if (now_ns() - start >= min_ns || reps >= (1 << 24))
+	    break;
+	reps *= 2;
+    }
+
+    for (i = 0; i < samples; i++) {
+	start = now_ns();
+	for (r = 0; r < reps; r++)
+	    b->run(d);
+	t[i] = (now_ns() - start) / ((double) reps * d->n);
+	sum  += t[i];
+	sum2 += t[i] * t[i];
+    }
+    qsort(t, samples, sizeof(double), compare_double);
+
+    res->n       = d->n;
+    res->reps    = reps;
+    res->samples = samples;
+    res->median  = t[samples / 2];
+    res->min     = t[0];
+    res->mean    = sum / samples;
+    res->stddev  = sqrt(MAX(0.0, sum2 / samples - res->mean * res->mean));
+}
+
+/******************************************************************************
+ *
+ * Sizes
+ *
+ *****************************************************************************/
+static size_t
+cache_size(int level, size_t fallback)
+{
+    long size = -1;
+
+#ifdef _SC_LEVEL1_DCACHE_SIZE
+    switch (level) {
+    case 1: size = sysconf(_SC_LEVEL1_DCACHE_SIZE); break;
+    case 2: size = sysconf(_SC_LEVEL2_CACHE_SIZE); break;
+    case 3: size = sysconf(_SC_LEVEL3_CACHE_SIZE); break;
+    }
+#endif
+    return (size > 0) ? (size_t) size : fallback;
+}
+
+/*
+ * half of each cache level, so the data stays put, and well past the L3.
+ * Server parts report the L3 shared by all cores, one core only gets a
+ * slice of it, so it is capped.
+ */
+static void
+bench_sizes(bench_size_t sizes[4])
+{
+    size_t l1 = cache_size(1, 32 << 10);
+    size_t l2 = cache_size(2, 256 << 10);
+    size_t l3 = MIN(cache_size(3, 8 << 20), (size_t) 32 << 20);
+
+    sizes[0].level = "L1";
+    sizes[0].bytes = l1 / 2;
+    sizes[1].level = "L2";
+    sizes[1].bytes = l2 / 2;
+    sizes[2].level = "L3";
+    sizes[2].bytes = l3 / 2;
+    sizes[3].level = "DRAM";
+    sizes[3].bytes = MAX(l3 * 4, (size_t) 64 << 20);
+}
+
+/******************************************************************************
+ *
+ * Main
+ *
+ *****************************************************************************/
+static void
+usage(void)
+{
+    fprintf(stderr, "usage: mathlib_bench [--json FILE] [--quick] "
+	    "[--threads N] [--no-simd] [--filter NAME]\n");
+    exit(1);
+}
+
+int
+main(int argc, char **argv)
+{
+    const char *json_file = NULL, *filter = NULL;
+    int samples = SAMPLES, threads = 1;
+    double min_ns = MIN_SAMPLE_NS;
+    gboolean simd = TRUE, first = TRUE;
+    bench_size_t sizes[4];
+    FILE *json = NULL;
+    int i, j;
+
+    for (i = 1; i < argc; i++) {
+	if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+	    json_file = argv[++i];
+	} else if (strcmp(argv[i], "--quick") == 0) {
+	    samples = QUICK_SAMPLES;
+	    min_ns  = QUICK_SAMPLE_NS;
+	} else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+	    threads = atoi(argv[++i]);
+	} else if (strcmp(argv[i], "--no-simd") == 0) {
+	    simd = FALSE;
+	} else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+	    filter = argv[++i];
+	} else {
+	    usage();
+	}
+    }
+
+#if !GLIB_CHECK_VERSION(2,32,0)
+    g_thread_init(NULL);
+#endif
+    mathlib_set_threads(threads);
+    mathlib_simd_enable(simd);
+    bench_sizes(sizes);
+    srand(1);
+
+    if (json_file != NULL) {
+	if ((json = fopen(json_file, "w")) == NULL) {
+	    perror(json_file);
+	    return 1;
+	}
+	fprintf(json, "{\n  \"avx2\": %s,\n  \"threads\": %d,\n",
+		simd_avx2() ? "true" : "false", threads);
+	fprintf(json, "  \"sizes\": {");
+	for (j = 0; j < 4; j++)
+	    fprintf(json, "%s\"%s\": %lu", j ? ", " : "", sizes[j].level,
+		    (unsigned long) sizes[j].bytes);
+	fprintf(json, "},\n  \"results\": [");
+    }
+
+    printf("avx2 %s, %d thread%s\n\n", simd_avx2() ? "on" : "off",
+	   threads, threads == 1 ? "" : "s");
+    printf("%-20s %-5s %9s %10s %10s %8s %10s %9s\n", "benchmark", "size",
+	   "n", "ns/op", "min", "stddev", "Mops/s", "GB/s");
+
+    for (i = 0; i < (int) G_N_ELEMENTS(benchmarks); i++) {
+	const bench_t *b = &benchmarks[i];
+
+	if (filter != NULL && strstr(b->name, filter) == NULL)
+	    continue;
+
+	for (j = 0; j < 4; j++) {
+	    bench_data_t d;
+	    bench_result_t res;
+	    int32_t n = MAX(64, sizes[j].bytes / b->footprint);
+	    double mops, gbps;
+
+	    bench_data_init(&d, n, b->uses);
+	    bench_time(b, &d, samples, min_ns, &res);
+	    bench_data_free(&d);
+
+	    mops = 1e3 / res.median;
+	    gbps = b->traffic / res.median;
+
+	    printf("%-20s %-5s %9d %10.3f %10.3f %7.1f%% %10.1f %9.2f\n",
+		   b->name, sizes[j].level, n, res.median, res.min,
+		   100.0 * res.stddev / res.mean, mops, gbps);
+	    fflush(stdout);
+
+	    if (json != NULL) {
+		fprintf(json, "%s\n    {\"name\": \"%s\", \"size\": \"%s\", "
+			"\"n\": %d, \"bytes\": %lu, \"reps\": %d, "
+			"\"samples\": %d, \"ns_per_op\": %.4f, "
+			"\"ns_min\": %.4f, \"ns_mean\": %.4f, "
+			"\"ns_stddev\": %.4f, \"mops_per_s\": %.3f, "
+			"\"gb_per_s\": %.3f}",
+			first ? "" : ",", b->name, sizes[j].level, n,
+			(unsigned long) (n * b->footprint), res.reps,
+			res.samples, res.median, res.min, res.mean,
+			res.stddev, mops, gbps);
+		first = FALSE;
+	    }
+	}
+    }
+
+    if (json != NULL) {
+	fprintf(json, "\n  ]\n}\n");
+	fclose(json);
+    }
+
+    return 0;
+}
@@ -0,0 +1,214 @@
+/*
+ *  Name: mathlib_check.c
+ *  Description: Checks for the math library (make check)
+ *
+ *  Copyright (C) 2012  Jason Hall
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Checks that quat_set_euler(), its batched version and quat_set3()
+ * build the same rotation as chaining one quat_set4() per axis in the
+ * order named, over a sweep of angles, that quat_set3() stays exact for
+ * zero and single axis rotations, that the matrix inverses are right
+ * and that mat4x4_inv() and mat4x4_inv_n() agree on them and on which
+ * matrices are singular, that the batched kernels give what their
+ * scalar functions do for short, odd and long lengths and that every
+ * norm mode gets as close to unit length as it should, in double and
+ * in float:
+ *
+ *	mathlib_check
+ *
+ * Prints the largest difference or the count found for each and exits
+ * with 1 if any is wrong.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "mathlib.h"
+
+/* -360 to 360 degrees in 22.5 degree steps */
+#define EULER_FIRST	-360.0
+#define EULER_STEP	22.5
+#define EULER_STEPS	33
+
+/* a few ulps of a unit quaternion component */
+#define EULER_TOLERANCE		1e-14
+#define EULERF_TOLERANCE	2e-6
+
+/* matrices to invert, a multiple of every vector width */
+#define INV_COUNT	64
+
+/* random ones, not a multiple, so the scalar tail runs too */
+#define INV_RANDOM	67
+
+/* m * inv(m) from the identity, for well conditioned matrices */
+#define INV_TOLERANCE		1e-13
+#define INVF_TOLERANCE		2e-5
+
+/*
+ * worst |length - 1| after normalizing, see norm_mode_t. The fast one
+ * is for cpus without SSE too, and NORM_LAZY leaves up to about 5e-6.
+ */
+#define NORM_TOLERANCE		1e-15
+#define NORMF_TOLERANCE		5e-7
+#define NORM_FAST_TOLERANCE	1e-5
+
+/*
+ * lengths to run the batched kernels for: none, less than a vector, a
+ * scalar tail on either side of a whole vector and one long enough to
+ * be split between the worker threads
+ */
+#define BATCH_LONG	32777
+
+static const int32_t batch_lengths[] = { 0, 1, 7, 9, BATCH_LONG };
+
+/* what goes just past the end, no kernel makes it */
+#define BATCH_UNTOUCHED	12345.0
+
+/*
+ * batched kernels against the scalar functions: bit for bit in strict
+ * mode, otherwise fused multiply-adds and the like round differently
+ */
+#ifdef MATHLIB_STRICT
+#define BATCH_TOLERANCE		0
+#define BATCHF_TOLERANCE	0
+#else
+#define BATCH_TOLERANCE		1e-13
+#define BATCHF_TOLERANCE	1e-5
+#endif
+
+static const char *euler_names[] = {
+    "xyz", "xzy", "yxz", "yzx", "zxy", "zyx"
+};
+
+static const int euler_letters[][3] = {
+    { X, Y, Z }, { X, Z, Y }, { Y, X, Z }, { Y, Z, X }, { Z, X, Y }, { Z, Y, X }
+};
+
+static int failures;
+
+/* rand() is never seeded, so every run checks the same numbers */
+static double
+check_random(double lo, double hi)
+{
+    return lo + (hi - lo) * (rand() / (double) RAND_MAX);
+}
+
+static void
+check(gboolean ok, const char *what, double diff)
+{
+    printf("%-40s %10.3g %s\n", what, diff, ok ? "ok" : "FAILED");
+    if (!ok)
+	failures++;
+}
+
+#include "mathlib_check_euler.h"
+#include "mathlib_check_inv.h"
+#include "mathlib_check_batch.h"
+
+#include "mathlib_float.h"
+#define euler_reference	eulerf_reference
+#define quat_max_diff	quatf_max_diff
+#define set3_exact_misses	set3f_exact_misses
+#define check_euler	check_eulerf
+#define inv_matrix	invf_matrix
+#define inv_random	invf_random
+#define inv_random_affine	invf_random_affine
+#define inv_id_diff	invf_id_diff
+#define check_inv_values	check_invf_values
+#define check_inv	check_invf
+#define batch_soa_new	batchf_soa_new
+#define batch_soa_free	batchf_soa_free
+#define batch_soa_get	batchf_soa_get
+#define batch_vec3_new	batchf_vec3_new
+#define vec3_max_diff	vec3f_max_diff
+#define check_quat_mult_n	check_quatf_mult_n
+#define check_vec3_transform_n	check_vec3f_transform_n
+#define mat4x4_max_diff	mat4x4f_max_diff
+#define check_mat4x4_mult_n	check_mat4x4f_mult_n
+#define check_mat4x4_to_quat_n	check_mat4x4f_to_quat_n
+#define project_clip	projectf_clip
+#define check_project_n	check_projectf_n
+#define norm_input	normf_input
+#define norm_len_diff	normf_len_diff
+#define check_norm_n	check_normf_n
+#include "mathlib_check_euler.h"
+#include "mathlib_check_inv.h"
+#include "mathlib_check_batch.h"
+#undef euler_reference
+#undef quat_max_diff
+#undef set3_exact_misses
+#undef check_euler
+#undef inv_matrix
+#undef inv_random
+#undef inv_random_affine
+#undef inv_id_diff
+#undef check_inv_values
+#undef check_inv
+#undef batch_soa_new
+#undef batch_soa_free
+#undef batch_soa_get
+#undef batch_vec3_new
+#undef vec3_max_diff
+#undef check_quat_mult_n
+#undef check_vec3_transform_n
+#undef mat4x4_max_diff
+#undef check_mat4x4_mult_n
+#undef check_mat4x4_to_quat_n
+#undef project_clip
+#undef check_project_n
+#undef norm_input
+#undef norm_len_diff
+#undef check_norm_n
+#include "mathlib_float.h"
+
+int
+main(int argc, char **argv)
+{
+#if !GLIB_CHECK_VERSION(2,32,0)
+    g_thread_init(NULL);
+#endif
+
+    check_euler("double", EULER_TOLERANCE);
+    check_eulerf("float", EULERF_TOLERANCE);
+    check_inv("double");
+    check_invf("float");
+    check_inv_values("double", INV_TOLERANCE, BATCH_TOLERANCE);
+    check_invf_values("float", INVF_TOLERANCE, BATCHF_TOLERANCE);
+    check_quat_mult_n("double", BATCH_TOLERANCE);
+    check_quatf_mult_n("float", BATCHF_TOLERANCE);
+    check_vec3_transform_n("double", BATCH_TOLERANCE);
+    check_vec3f_transform_n("float", BATCHF_TOLERANCE);
+    check_mat4x4_mult_n("double", BATCH_TOLERANCE);
+    check_mat4x4f_mult_n("float", BATCHF_TOLERANCE);
+    check_mat4x4_to_quat_n("double", BATCH_TOLERANCE);
+    check_mat4x4f_to_quat_n("float", BATCHF_TOLERANCE);
+    check_project_n("double", BATCH_TOLERANCE);
+    check_projectf_n("float", BATCHF_TOLERANCE);
+    check_norm_n("double", BATCH_TOLERANCE, NORM_TOLERANCE,
+	    NORM_FAST_TOLERANCE);
+    check_normf_n("float", BATCHF_TOLERANCE, NORMF_TOLERANCE,
+	    NORM_FAST_TOLERANCE);
+
+    if (failures > 0) {
+	printf("%d checks FAILED\n", failures);
+	return 1;
+    }
+    return 0;
+}
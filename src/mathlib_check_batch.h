@@ -0,0 +1,524 @@
+/*
+ *  Name: mathlib_check_batch.h
+ *  Description: The batched kernel checks, for both precisions
+ *
+ *  Copyright (C) 2012  Jason Hall
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Included twice by mathlib_check.c, the same way as
+ * mathlib_check_euler.h. Every kernel is run for each of batch_lengths
+ * and compared with its scalar function item by item. The item just
+ * past the end is set to BATCH_UNTOUCHED first and must still be that
+ * afterwards.
+ */
+
+/* n random quaternions plus one more for BATCH_UNTOUCHED */
+static void
+batch_soa_new(quat_soa_t *q, int32_t n)
+{
+    int32_t i;
+
+    q->x = g_new(real, n + 1);
+    q->y = g_new(real, n + 1);
+    q->z = g_new(real, n + 1);
+    q->w = g_new(real, n + 1);
+    for (i = 0; i <= n; i++) {
+	q->x[i] = check_random(-1, 1);
+	q->y[i] = check_random(-1, 1);
+	q->z[i] = check_random(-1, 1);
+	q->w[i] = check_random(-1, 1);
+    }
+}
+
+static void
+batch_soa_free(quat_soa_t *q)
+{
+    g_free(q->x);
+    g_free(q->y);
+    g_free(q->z);
+    g_free(q->w);
+}
+
+static void
+batch_soa_get(quat_soa_t *q, int32_t i, quat_t dest)
+{
+    vec4_set(dest, q->x[i], q->y[i], q->z[i], q->w[i]);
+}
+
+/* n random vectors within lo to hi plus one more for BATCH_UNTOUCHED */
+static vec3_t *
+batch_vec3_new(int32_t n, real lo, real hi)
+{
+    vec3_t *v = g_new(vec3_t, n + 1);
+    int32_t i;
+
+    for (i = 0; i <= n; i++)
+	vec3_set(v[i], check_random(lo, hi), check_random(lo, hi),
+		check_random(lo, hi));
+    return v;
+}
+
+static double
+vec3_max_diff(vec3_t a, vec3_t b)
+{
+    double d = 0;
+    int i;
+
+    for (i = 0; i < 3; i++)
+	d = MAX(d, fabs((double) a[i] - (double) b[i]));
+    return d;
+}
+
+/* relative to b where it is over 1, products of products grow */
+static double
+mat4x4_max_diff(mat4x4_t a, mat4x4_t b)
+{
+    double d = 0;
+    int i;
+
+    for (i = 0; i < 16; i++)
+	d = MAX(d, fabs((double) a[i] - (double) b[i]) / MAX(1, fabs((double) b[i])));
+    return d;
+}
+
+static void
+check_quat_mult_n(const char *precision, double tolerance)
+{
+    char what[64];
+    quat_soa_t q1, q2, dest;
+    quat_t a, b;
+    double worst = 0;
+    gboolean untouched = TRUE;
+    int32_t i, n;
+    int k;
+
+    batch_soa_new(&q1, BATCH_LONG);
+    batch_soa_new(&q2, BATCH_LONG);
+    batch_soa_new(&dest, BATCH_LONG);
+
+    for (k = 0; k < G_N_ELEMENTS(batch_lengths); k++) {
+	n = batch_lengths[k];
+	dest.w[n] = BATCH_UNTOUCHED;
+	quat_mult_n(&q1, &q2, &dest, n);
+	untouched &= dest.w[n] == BATCH_UNTOUCHED;
+
+	for (i = 0; i < n; i++) {
+	    batch_soa_get(&q1, i, a);
+	    batch_soa_get(&q2, i, b);
+	    quat_mult(a, b);
+	    batch_soa_get(&dest, i, b);
+	    worst = MAX(worst, quat_max_diff(a, b));
+	}
+    }
+
+    snprintf(what, sizeof(what), "%s quat_mult_n", precision);
+    check(worst <= tolerance && untouched, what, worst);
+
+    batch_soa_free(&q1);
+    batch_soa_free(&q2);
+    batch_soa_free(&dest);
+}
+
+/* into a separate array for every length, then in place */
+static void
+check_vec3_transform_n(const char *precision, double tolerance)
+{
+    char what[64];
+    vec3_t *in, *out, *ref;
+    mat4x4_t m;
+    double worst = 0;
+    gboolean untouched = TRUE;
+    int32_t i, n;
+    int k;
+
+    in = batch_vec3_new(BATCH_LONG, -1, 1);
+    out = batch_vec3_new(BATCH_LONG, -1, 1);
+    ref = g_new(vec3_t, BATCH_LONG);
+    inv_random(m);
+
+    for (k = 0; k < G_N_ELEMENTS(batch_lengths); k++) {
+	n = batch_lengths[k];
+	out[n][X] = BATCH_UNTOUCHED;
+	vec3_transform_n(in, out, n, m);
+	untouched &= out[n][X] == BATCH_UNTOUCHED;
+
+	memcpy(ref, in, n * sizeof(vec3_t));
+	vec3_transform(ref, n, m);
+	for (i = 0; i < n; i++)
+	    worst = MAX(worst, vec3_max_diff(out[i], ref[i]));
+    }
+
+    in[BATCH_LONG][X] = BATCH_UNTOUCHED;
+    vec3_transform_n(in, in, BATCH_LONG, m);
+    untouched &= in[BATCH_LONG][X] == BATCH_UNTOUCHED;
+    for (i = 0; i < BATCH_LONG; i++)
+	worst = MAX(worst, vec3_max_diff(in[i], ref[i]));
+
+    snprintf(what, sizeof(what), "%s vec3_transform_n", precision);
+    check(worst <= tolerance && untouched, what, worst);
+
+    g_free(in);
+    g_free(out);
+    g_free(ref);
+}
+
+/*
+ * mat4x4_mult_n() into a separate array and in place, then
+ * mat4x4_mult_indexed() resolving a hierarchy into itself: groups of
+ * four with a root each and every other one's parent somewhere before
+ * it in the group
+ */
+static void
+check_mat4x4_mult_n(const char *precision, double tolerance)
+{
+    char what[64];
+    mat4x4_t *m1, *m2, *dest, *ref;
+    int32_t *index;
+    double worst = 0, worst_indexed = 0;
+    gboolean untouched = TRUE, untouched_indexed = TRUE;
+    int32_t i, n;
+    int k;
+
+    m1 = g_new(mat4x4_t, BATCH_LONG + 1);
+    m2 = g_new(mat4x4_t, BATCH_LONG + 1);
+    dest = g_new(mat4x4_t, BATCH_LONG + 1);
+    ref = g_new(mat4x4_t, BATCH_LONG);
+    index = g_new(int32_t, BATCH_LONG);
+    for (i = 0; i < BATCH_LONG; i++) {
+	inv_random(m1[i]);
+	inv_random(m2[i]);
+	index[i] = (i % 4 == 0) ? -1 : (i & ~3) + rand() % (i & 3);
+    }
+
+    for (k = 0; k < G_N_ELEMENTS(batch_lengths); k++) {
+	n = batch_lengths[k];
+	dest[n][0] = BATCH_UNTOUCHED;
+	mat4x4_mult_n(m1, m2, dest, n);
+	untouched &= dest[n][0] == BATCH_UNTOUCHED;
+
+	for (i = 0; i < n; i++) {
+	    mat4x4_mult(m1[i], m2[i], ref[i]);
+	    worst = MAX(worst, mat4x4_max_diff(dest[i], ref[i]));
+	}
+    }
+
+    m2[BATCH_LONG][0] = BATCH_UNTOUCHED;
+    mat4x4_mult_n(m1, m2, m2, BATCH_LONG);
+    untouched &= m2[BATCH_LONG][0] == BATCH_UNTOUCHED;
+    for (i = 0; i < BATCH_LONG; i++)
+	worst = MAX(worst, mat4x4_max_diff(m2[i], ref[i]));
+
+    // m1 are the locals now, dest the world matrices
+    for (i = 0; i < BATCH_LONG; i++)
+	inv_random_affine(m1[i]);
+    for (k = 0; k < G_N_ELEMENTS(batch_lengths); k++) {
+	n = batch_lengths[k];
+	dest[n][0] = BATCH_UNTOUCHED;
+	mat4x4_mult_indexed(dest, index, m1, dest, n);
+	untouched_indexed &= dest[n][0] == BATCH_UNTOUCHED;
+
+	for (i = 0; i < n; i++) {
+	    if (index[i] < 0)
+		mat4x4_copy(m1[i], ref[i]);
+	    else
+		mat4x4_mult(ref[index[i]], m1[i], ref[i]);
+	    worst_indexed = MAX(worst_indexed, mat4x4_max_diff(dest[i], ref[i]));
+	}
+    }
+
+    snprintf(what, sizeof(what), "%s mat4x4_mult_n", precision);
+    check(worst <= tolerance && untouched, what, worst);
+    snprintf(what, sizeof(what), "%s mat4x4_mult_indexed", precision);
+    check(worst_indexed <= tolerance && untouched_indexed, what, worst_indexed);
+
+    g_free(m1);
+    g_free(m2);
+    g_free(dest);
+    g_free(ref);
+    g_free(index);
+}
+
+/* random rotations, so every branch of mat4x4_to_quat() gets its turn */
+static void
+check_mat4x4_to_quat_n(const char *precision, double tolerance)
+{
+    char what[64];
+    mat4x4_t *m;
+    quat_soa_t q;
+    quat_t a, b;
+    double worst = 0;
+    gboolean untouched = TRUE;
+    int32_t i, n;
+    int k;
+
+    m = g_new(mat4x4_t, BATCH_LONG);
+    for (i = 0; i < BATCH_LONG; i++)
+	inv_random_affine(m[i]);
+    batch_soa_new(&q, BATCH_LONG);
+
+    for (k = 0; k < G_N_ELEMENTS(batch_lengths); k++) {
+	n = batch_lengths[k];
+	q.w[n] = BATCH_UNTOUCHED;
+	mat4x4_to_quat_n(m, &q, n);
+	untouched &= q.w[n] == BATCH_UNTOUCHED;
+
+	for (i = 0; i < n; i++) {
+	    mat4x4_to_quat(m[i], a);
+	    batch_soa_get(&q, i, b);
+	    worst = MAX(worst, quat_max_diff(a, b));
+	}
+    }
+
+    snprintf(what, sizeof(what), "%s mat4x4_to_quat_n", precision);
+    check(worst <= tolerance && untouched, what, worst);
+
+    g_free(m);
+    batch_soa_free(&q);
+}
+
+/* the flags project_n() should give for clip coordinates c */
+static uint8_t
+project_clip(real c[4])
+{
+    uint8_t clip = 0;
+
+    if (c[X] < -c[W]) clip |= CLIP_LEFT;
+    if (c[X] >  c[W]) clip |= CLIP_RIGHT;
+    if (c[Y] < -c[W]) clip |= CLIP_BOTTOM;
+    if (c[Y] >  c[W]) clip |= CLIP_TOP;
+    if (c[Z] < -c[W]) clip |= CLIP_NEAR;
+    if (c[Z] >  c[W]) clip |= CLIP_FAR;
+    if (c[W] <= 0)    clip |= CLIP_W;
+    return clip;
+}
+
+/*
+ * Points around a randomly turned model 5 in front of a 90 degree
+ * frustum from 1 to 10, so some are off every side and some behind the
+ * eye. project() given proj * model and the identity does the same math
+ * as project_n(). Points closer than 1 to the eye plane are made again,
+ * their window coordinates blow up any rounding difference. The
+ * differences are measured in normalized device coordinates, size is
+ * what one unit of those is in the window.
+ */
+static void
+check_project_n(const char *precision, double tolerance)
+{
+    char what[64];
+    int32_t viewport[4] = { 10, 20, 640, 480 };
+    double size[3] = { 320, 240, 0.5 };
+    mat4x4_t model, proj, m, id;
+    vec3_t *obj, *win;
+    vec3_t ref;
+    uint8_t *clip, *ref_clip;
+    real in[4], c[4];
+    double worst = 0;
+    gboolean untouched = TRUE;
+    int32_t i, n, visible, ref_visible, wrong = 0;
+    int k, j;
+
+    inv_random_affine(model);
+    vec3_set(&model[12], 0, 0, -5);
+    mat4x4_zero(proj);
+    proj[0] = 1;
+    proj[5] = 1;
+    proj[10] = -11.0 / 9.0;
+    proj[11] = -1;
+    proj[14] = -20.0 / 9.0;
+    mat4x4_mult(proj, model, m);
+    mat4x4_id(id);
+
+    obj = g_new(vec3_t, BATCH_LONG);
+    win = g_new(vec3_t, BATCH_LONG + 1);
+    clip = g_new(uint8_t, BATCH_LONG + 1);
+    ref_clip = g_new(uint8_t, BATCH_LONG);
+    for (i = 0; i < BATCH_LONG; i++) {
+	do {
+	    vec4_set(in, check_random(-4, 4), check_random(-4, 4),
+		    check_random(-4, 4), 1.0);
+	    transform_point(c, m, in);
+	} while (fabs(c[W]) < 1);
+	vec3_cp(in, obj[i]);
+	ref_clip[i] = project_clip(c);
+    }
+
+    for (k = 0; k < G_N_ELEMENTS(batch_lengths); k++) {
+	n = batch_lengths[k];
+	win[n][X] = BATCH_UNTOUCHED;
+	clip[n] = 0xff;
+	visible = project_n(obj, n, model, proj, viewport, win, clip);
+	untouched &= win[n][X] == BATCH_UNTOUCHED && clip[n] == 0xff;
+
+	ref_visible = 0;
+	for (i = 0; i < n; i++) {
+	    ref_visible += ref_clip[i] == 0;
+	    wrong += clip[i] != ref_clip[i];
+	    if (ref_clip[i] & CLIP_W)
+		continue;
+
+	    project(obj[i], m, id, viewport, ref);
+	    for (j = 0; j < 3; j++)
+		worst = MAX(worst, fabs((double) win[i][j] - (double) ref[j]) /
+			size[j]);
+	}
+	wrong += visible != ref_visible;
+    }
+
+    // and without the flags
+    wrong += project_n(obj, BATCH_LONG, model, proj, viewport, win, NULL) !=
+	     ref_visible;
+
+    snprintf(what, sizeof(what), "%s project_n", precision);
+    check(worst <= tolerance && untouched, what, worst);
+    snprintf(what, sizeof(what), "%s project_n clip flags, wrong", precision);
+    check(wrong == 0, what, wrong);
+
+    g_free(obj);
+    g_free(win);
+    g_free(clip);
+    g_free(ref_clip);
+}
+
+/*
+ * random vectors, every other one within NORM_LAZY_EPSILON of unit
+ * length, which NORM_LAZY must leave exactly as it is
+ */
+static void
+norm_input(real *v, int size, int32_t i)
+{
+    double len = 0;
+    real scale;
+    int j;
+
+    for (j = 0; j < size; j++) {
+	v[j] = check_random(-2, 2);
+	len += (double) v[j] * v[j];
+    }
+
+    if (i % 2) {
+	scale = (1 + check_random(-2e-6, 2e-6)) / sqrt(len);
+	for (j = 0; j < size; j++)
+	    v[j] *= scale;
+    }
+}
+
+static double
+norm_len_diff(real *v, int size)
+{
+    double len = 0;
+    int j;
+
+    for (j = 0; j < size; j++)
+	len += (double) v[j] * v[j];
+    return fabs(sqrt(len) - 1);
+}
+
+/*
+ * For each mode vec3_norm_n() and quat_norm_n() against the scalar
+ * versions, the worst |length - 1| against unit_tolerance for NORM_EXACT
+ * and fast_tolerance for the others, and that NORM_LAZY left the near
+ * unit ones alone.
+ */
+static void
+check_norm_n(const char *precision, double tolerance, double unit_tolerance,
+	double fast_tolerance)
+{
+    static const char *mode_names[] = { "exact", "fast", "lazy" };
+    char what[64];
+    vec3_t *in, *v;
+    quat_t *qin;
+    quat_soa_t q;
+    vec3_t ref;
+    quat_t a, b;
+    double worst[2], worst_len[2];
+    gboolean untouched[2];
+    int32_t i, n, moved[2];
+    int k, mode;
+
+    in = g_new(vec3_t, BATCH_LONG);
+    v = g_new(vec3_t, BATCH_LONG + 1);
+    qin = g_new(quat_t, BATCH_LONG);
+    batch_soa_new(&q, BATCH_LONG);
+    for (i = 0; i < BATCH_LONG; i++) {
+	norm_input(in[i], 3, i);
+	norm_input(qin[i], 4, i);
+    }
+
+    for (mode = NORM_EXACT; mode <= NORM_LAZY; mode++) {
+	worst[0] = worst[1] = worst_len[0] = worst_len[1] = 0;
+	untouched[0] = untouched[1] = TRUE;
+	moved[0] = moved[1] = 0;
+
+	for (k = 0; k < G_N_ELEMENTS(batch_lengths); k++) {
+	    n = batch_lengths[k];
+	    memcpy(v, in, n * sizeof(vec3_t));
+	    v[n][X] = BATCH_UNTOUCHED;
+	    vec3_norm_n(v, n, mode);
+	    untouched[0] &= v[n][X] == BATCH_UNTOUCHED;
+
+	    for (i = 0; i < n; i++) {
+		vec3_cp(in[i], ref);
+		vec3_norm_mode(ref, mode);
+		worst[0] = MAX(worst[0], vec3_max_diff(v[i], ref));
+		worst_len[0] = MAX(worst_len[0], norm_len_diff(v[i], 3));
+		if (mode == NORM_LAZY && i % 2)
+		    moved[0] += vec3_max_diff(v[i], in[i]) != 0;
+	    }
+
+	    for (i = 0; i < n; i++) {
+		q.x[i] = qin[i][X];
+		q.y[i] = qin[i][Y];
+		q.z[i] = qin[i][Z];
+		q.w[i] = qin[i][W];
+	    }
+	    q.w[n] = BATCH_UNTOUCHED;
+	    quat_norm_n(&q, n, mode);
+	    untouched[1] &= q.w[n] == BATCH_UNTOUCHED;
+
+	    for (i = 0; i < n; i++) {
+		quat_cp(qin[i], a);
+		quat_norm_mode(a, mode);
+		batch_soa_get(&q, i, b);
+		worst[1] = MAX(worst[1], quat_max_diff(a, b));
+		worst_len[1] = MAX(worst_len[1], norm_len_diff(b, 4));
+		if (mode == NORM_LAZY && i % 2)
+		    moved[1] += quat_max_diff(b, qin[i]) != 0;
+	    }
+	}
+
+	for (k = 0; k < 2; k++) {
+	    const char *name = k ? "quat_norm_n" : "vec3_norm_n";
+
+	    snprintf(what, sizeof(what), "%s %s %s", precision, name,
+		    mode_names[mode]);
+	    check(worst[k] <= tolerance && untouched[k], what, worst[k]);
+	    snprintf(what, sizeof(what), "%s %s %s |length-1|", precision, name,
+		    mode_names[mode]);
+	    check(worst_len[k] <= (mode == NORM_EXACT ? unit_tolerance :
+			fast_tolerance), what, worst_len[k]);
+	    if (mode == NORM_LAZY) {
+		snprintf(what, sizeof(what), "%s %s lazy, moved", precision, name);
+		check(moved[k] == 0, what, moved[k]);
+	    }
+	}
+    }
+
+    g_free(in);
+    g_free(v);
+    g_free(qin);
+    batch_soa_free(&q);
+}
@@ -0,0 +1,165 @@
+/*
+ *  Name: mathlib_check_euler.h
+ *  Description: The euler angle checks, for both precisions
+ *
+ *  Copyright (C) 2012  Jason Hall
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * mathlib_check.c includes this twice like mathlib.h does mathlib_api.h,
+ * the second time after mathlib_float.h and with check_euler defined to
+ * a different name, so the same code checks quat_set_euler() and
+ * quatf_set_euler().
+ */
+
+/*
+ * What quat_set3() used to do, generalized to any order: one quat_set4()
+ * rotation per axis, multiplied on in the order given.
+ */
+static void
+euler_reference(quat_t q, real x, real y, real z, euler_order_t order)
+{
+    real angles[3];
+    quat_t axis;
+    int i, a;
+
+    angles[X] = x;
+    angles[Y] = y;
+    angles[Z] = z;
+
+    quat_id(q);
+    for (i = 0; i < 3; i++) {
+	a = euler_letters[order][i];
+	quat_set4(axis, a == X, a == Y, a == Z, angles[a]);
+	quat_mult(q, axis);
+    }
+}
+
+static double
+quat_max_diff(quat_t a, quat_t b)
+{
+    double d = 0;
+    int i;
+
+    for (i = 0; i < 4; i++)
+	d = MAX(d, fabs((double) a[i] - (double) b[i]));
+    return d;
+}
+
+/*
+ * quat_set3() is what the calculator shows, it must give exactly the
+ * identity for no rotation and exactly quat_set4() around one axis
+ * (compared as numbers, a zero may come out as -0)
+ */
+static int
+set3_exact_misses(void)
+{
+    quat_t q, ref;
+    real angle;
+    int i, axis, misses = 0;
+
+    quat_set3(q, 0, 0, 0);
+    quat_id(ref);
+    misses += quat_max_diff(q, ref) != 0;
+
+    for (i = 0; i < EULER_STEPS; i++) {
+	angle = EULER_FIRST + i * EULER_STEP;
+	if (angle == 0)
+	    continue;
+	for (axis = X; axis <= Z; axis++) {
+	    quat_set3(q, axis == X ? angle : 0, axis == Y ? angle : 0,
+		    axis == Z ? angle : 0);
+	    quat_set4(ref, axis == X, axis == Y, axis == Z, angle);
+	    misses += quat_max_diff(q, ref) != 0;
+	}
+    }
+
+    return misses;
+}
+
+static void
+check_euler(const char *precision, double tolerance)
+{
+    char what[64];
+    vec3_t *angles;
+    quat_soa_t soa;
+    quat_t q, ref;
+    double worst, worst_n, worst_set3;
+    int order, i, j, k, n;
+
+    n = EULER_STEPS * EULER_STEPS * EULER_STEPS;
+    angles = g_new(vec3_t, n);
+    soa.x = g_new(real, n);
+    soa.y = g_new(real, n);
+    soa.z = g_new(real, n);
+    soa.w = g_new(real, n);
+
+    // every combination of the sweep, zeros and full turns included
+    n = 0;
+    for (i = 0; i < EULER_STEPS; i++) {
+	for (j = 0; j < EULER_STEPS; j++) {
+	    for (k = 0; k < EULER_STEPS; k++) {
+		angles[n][X] = EULER_FIRST + i * EULER_STEP;
+		angles[n][Y] = EULER_FIRST + j * EULER_STEP;
+		angles[n][Z] = EULER_FIRST + k * EULER_STEP;
+		n++;
+	    }
+	}
+    }
+
+    for (order = EULER_XYZ; order <= EULER_ZYX; order++) {
+	worst = worst_n = worst_set3 = 0;
+	quat_set_euler_n(angles, &soa, n, order);
+
+	for (i = 0; i < n; i++) {
+	    euler_reference(ref, angles[i][X], angles[i][Y], angles[i][Z], order);
+	    quat_set_euler(q, angles[i][X], angles[i][Y], angles[i][Z], order);
+	    worst = MAX(worst, quat_max_diff(q, ref));
+
+	    q[X] = soa.x[i];
+	    q[Y] = soa.y[i];
+	    q[Z] = soa.z[i];
+	    q[W] = soa.w[i];
+	    worst_n = MAX(worst_n, quat_max_diff(q, ref));
+
+	    if (order == EULER_XYZ) {
+		quat_set3(q, angles[i][X], angles[i][Y], angles[i][Z]);
+		worst_set3 = MAX(worst_set3, quat_max_diff(q, ref));
+	    }
+	}
+
+	snprintf(what, sizeof(what), "%s quat_set_euler %s", precision,
+		euler_names[order]);
+	check(worst <= tolerance, what, worst);
+	snprintf(what, sizeof(what), "%s quat_set_euler_n %s", precision,
+		euler_names[order]);
+	check(worst_n <= tolerance, what, worst_n);
+	if (order == EULER_XYZ) {
+	    snprintf(what, sizeof(what), "%s quat_set3", precision);
+	    check(worst_set3 <= tolerance, what, worst_set3);
+	}
+    }
+
+    i = set3_exact_misses();
+    snprintf(what, sizeof(what), "%s quat_set3 exact, misses", precision);
+    check(i == 0, what, i);
+
+    g_free(angles);
+    g_free(soa.x);
+    g_free(soa.y);
+    g_free(soa.z);
+    g_free(soa.w);
+}
@@ -0,0 +1,177 @@
+/*
+ *  Name: mathlib_check_inv.h
+ *  Description: The matrix inverse checks, for both precisions
+ *
+ *  Copyright (C) 2012  Jason Hall
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Included twice by mathlib_check.c, the same way as
+ * mathlib_check_euler.h.
+ */
+
+/*
+ * matrix k of the set, every other one singular: the odd ones have a
+ * third row that is a mix of the first two, which rounding leaves a
+ * little off, and some are scaled way up or down
+ */
+static void
+inv_matrix(mat4x4_t m, int k)
+{
+    real scale = (k % 8 < 4) ? 1.0 : (k % 8 < 6) ? 1e-3 : 1e3;
+    int row, col;
+
+    for (row = 0; row < 4; row++) {
+	for (col = 0; col < 4; col++)
+	    M(row, col) = (row == col ? 2.0 + k : 0.0) + 0.1 * (row + 1) * (col + k % 3);
+    }
+
+    if (k % 2) {
+	for (col = 0; col < 4; col++)
+	    M(2, col) = 0.1 * M(0, col) + 0.3 * M(1, col);
+    }
+
+    for (row = 0; row < 16; row++)
+	m[row] *= scale;
+}
+
+/* a general matrix kept well conditioned by a heavy diagonal */
+static void
+inv_random(mat4x4_t m)
+{
+    int i;
+
+    for (i = 0; i < 16; i++)
+	m[i] = check_random(-1, 1) + (i % 5 == 0 ? 4.0 : 0.0);
+}
+
+/* a rotation plus a translation, what mat4x4_inv_affine() is for */
+static void
+inv_random_affine(mat4x4_t m)
+{
+    quat_t q;
+
+    quat_set_euler(q, check_random(-180, 180), check_random(-180, 180),
+	    check_random(-180, 180), EULER_XYZ);
+    quat_to_mat(q, m);
+    m[12] = check_random(-10, 10);
+    m[13] = check_random(-10, 10);
+    m[14] = check_random(-10, 10);
+}
+
+/* largest difference of m * inv from the identity */
+static double
+inv_id_diff(mat4x4_t m, mat4x4_t inv)
+{
+    mat4x4_t p, id;
+    double d = 0;
+    int i;
+
+    mat4x4_mult(m, inv, p);
+    mat4x4_id(id);
+    for (i = 0; i < 16; i++)
+	d = MAX(d, fabs((double) p[i] - (double) id[i]));
+    return d;
+}
+
+/*
+ * that the inverses are right: m * inv(m) is the identity for random
+ * general and affine matrices, and mat4x4_inv_n() gives what
+ * mat4x4_inv() does, element by element. INV_RANDOM isn't a multiple of
+ * the vector width, so the scalar tail is covered too.
+ */
+static void
+check_inv_values(const char *precision, double tolerance, double batch_tolerance)
+{
+    char what[64];
+    mat4x4_t *m, *dest;
+    mat4x4_t tmp;
+    double worst, worst_affine, worst_n, worst_same;
+    int k, i, failed;
+
+    m = g_new(mat4x4_t, INV_RANDOM);
+    dest = g_new(mat4x4_t, INV_RANDOM);
+
+    worst = worst_affine = worst_n = worst_same = 0;
+    failed = 0;
+    for (k = 0; k < INV_RANDOM; k++) {
+	inv_random_affine(m[k]);
+	mat4x4_inv_affine(m[k], tmp);
+	worst_affine = MAX(worst_affine, inv_id_diff(m[k], tmp));
+	failed += !mat4x4_inv(m[k], tmp);
+	worst = MAX(worst, inv_id_diff(m[k], tmp));
+
+	inv_random(m[k]);
+	failed += !mat4x4_inv(m[k], tmp);
+	worst = MAX(worst, inv_id_diff(m[k], tmp));
+    }
+
+    failed += mat4x4_inv_n(m, dest, INV_RANDOM);
+    for (k = 0; k < INV_RANDOM; k++) {
+	worst_n = MAX(worst_n, inv_id_diff(m[k], dest[k]));
+	mat4x4_inv(m[k], tmp);
+	for (i = 0; i < 16; i++)
+	    worst_same = MAX(worst_same, fabs((double) dest[k][i] - (double) tmp[i]));
+    }
+
+    snprintf(what, sizeof(what), "%s mat4x4_inv M*inv(M)", precision);
+    check(worst <= tolerance && failed == 0, what, worst);
+    snprintf(what, sizeof(what), "%s mat4x4_inv_affine M*inv(M)", precision);
+    check(worst_affine <= tolerance, what, worst_affine);
+    snprintf(what, sizeof(what), "%s mat4x4_inv_n M*inv(M)", precision);
+    check(worst_n <= tolerance, what, worst_n);
+    snprintf(what, sizeof(what), "%s mat4x4_inv_n vs mat4x4_inv", precision);
+    check(worst_same <= batch_tolerance, what, worst_same);
+
+    g_free(m);
+    g_free(dest);
+}
+
+static void
+check_inv(const char *precision)
+{
+    char what[64];
+    mat4x4_t *m, *dest;
+    mat4x4_t tmp;
+    int k, scalar, batched, agree;
+
+    m = g_new(mat4x4_t, INV_COUNT);
+    dest = g_new(mat4x4_t, INV_COUNT);
+    for (k = 0; k < INV_COUNT; k++)
+	inv_matrix(m[k], k);
+
+    scalar = batched = 0;
+    for (k = 0; k < INV_COUNT; k++)
+	scalar += !mat4x4_inv(m[k], tmp);
+    batched = mat4x4_inv_n(m, dest, INV_COUNT);
+
+    // and the batched one zeroed the same ones
+    agree = 0;
+    for (k = 0; k < INV_COUNT; k++) {
+	gboolean zeroed = dest[k][0] == 0.0 && dest[k][5] == 0.0 &&
+			  dest[k][10] == 0.0 && dest[k][15] == 0.0;
+
+	agree += zeroed == (k % 2);
+    }
+
+    snprintf(what, sizeof(what), "%s mat4x4_inv singular", precision);
+    check(scalar == INV_COUNT / 2, what, scalar);
+    snprintf(what, sizeof(what), "%s mat4x4_inv_n singular", precision);
+    check(batched == INV_COUNT / 2 && agree == INV_COUNT, what, batched);
+
+    g_free(m);
+    g_free(dest);
+}
@@ -0,0 +1,173 @@
+/*
+ *  Name: mathlib_float.h
+ *  Description: Maps the mathlib names onto their float versions
+ *
+ *  Copyright (C) 2012  Jason Hall
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * The float versions of the math functions are built from the same source
+ * as the double ones (see mathlibf.c). Including this file switches the
+ * type and function names over to their float spelling, so that
+ *
+ *	void quat_mult(quat_t q1, quat_t q2);
+ *
+ * is read by the compiler as
+ *
+ *	void quatf_mult(quatf_t q1, quatf_t q2);
+ *
+ * Including it a second time switches them back, which is how mathlib.h
+ * declares both sets from a single list of prototypes. Anything added to
+ * mathlib_api.h that takes a real needs an entry in both lists below.
+ */
+
+#ifndef _MATHLIB_FLOAT_NAMES
+#define _MATHLIB_FLOAT_NAMES
+
+#define real			realf
+#define vec2_t			vec2f_t
+#define vec3_t			vec3f_t
+#define vec4_t			vec4f_t
+#define quat_t			quatf_t
+#define mat4x4_t		mat4x4f_t
+#define mat3x3_t		mat3x3f_t
+#define quat_soa_t		quatf_soa_t
+
+#define quat_new		quatf_new
+#define quat_new_arena		quatf_new_arena
+#define quat_destroy		quatf_destroy
+#define quat_add		quatf_add
+#define quat_id			quatf_id
+#define quat_to_mat		quatf_to_mat
+#define quat_to_mat_inv		quatf_to_mat_inv
+#define quat_to_mat_transpose	quatf_to_mat_transpose
+#define quat_cp			quatf_cp
+#define quat_set3		quatf_set3
+#define quat_set4		quatf_set4
+#define quat_set4_correct	quatf_set4_correct
+#define quat_set_euler		quatf_set_euler
+#define quat_mult		quatf_mult
+#define quat_to_vecs		quatf_to_vecs
+#define quat_print		quatf_print
+#define quat_norm		quatf_norm
+#define quat_norm_mode		quatf_norm_mode
+#define quat_inv		quatf_inv
+
+#define vec3_new		vec3f_new
+#define vec3_new_arena		vec3f_new_arena
+#define vec3_destroy		vec3f_destroy
+#define vec3_angle		vec3f_angle
+#define vec3_cross		vec3f_cross
+#define vec3_norm		vec3f_norm
+#define vec3_norm_mode		vec3f_norm_mode
+#define vec3_print		vec3f_print
+#define vec3_transform		vec3f_transform
+#define transform_point		transform_pointf
+#define project			projectf
+
+#define mat4x4_new		mat4x4f_new
+#define mat4x4_new_arena	mat4x4f_new_arena
+#define mat4x4_destroy		mat4x4f_destroy
+#define mat4x4_zero		mat4x4f_zero
+#define mat4x4_scale		mat4x4f_scale
+#define mat4x4_translate	mat4x4f_translate
+#define mat4x4_id		mat4x4f_id
+#define mat4x4_mult		mat4x4f_mult
+#define mat4x4_copy		mat4x4f_copy
+#define mat4x4_inv		mat4x4f_inv
+#define mat4x4_inv_affine	mat4x4f_inv_affine
+#define mat4x4_to_quat		mat4x4f_to_quat
+
+#define quat_mult_n		quatf_mult_n
+#define quat_norm_n		quatf_norm_n
+#define quat_set_euler_n	quatf_set_euler_n
+#define vec3_transform_n	vec3f_transform_n
+#define vec3_norm_n		vec3f_norm_n
+#define project_n		project_nf
+#define mat4x4_mult_n		mat4x4f_mult_n
+#define mat4x4_mult_indexed	mat4x4f_mult_indexed
+#define mat4x4_inv_n		mat4x4f_inv_n
+#define mat4x4_to_quat_n	mat4x4f_to_quat_n
+
+#else
+#undef _MATHLIB_FLOAT_NAMES
+
+#undef real
+#undef vec2_t
+#undef vec3_t
+#undef vec4_t
+#undef quat_t
+#undef mat4x4_t
+#undef mat3x3_t
+#undef quat_soa_t
+
+#undef quat_new
+#undef quat_new_arena
+#undef quat_destroy
+#undef quat_add
+#undef quat_id
+#undef quat_to_mat
+#undef quat_to_mat_inv
+#undef quat_to_mat_transpose
+#undef quat_cp
+#undef quat_set3
+#undef quat_set4
+#undef quat_set4_correct
+#undef quat_set_euler
+#undef quat_mult
+#undef quat_to_vecs
+#undef quat_print
+#undef quat_norm
+#undef quat_norm_mode
+#undef quat_inv
+
+#undef vec3_new
+#undef vec3_new_arena
+#undef vec3_destroy
+#undef vec3_angle
+#undef vec3_cross
+#undef vec3_norm
+#undef vec3_norm_mode
+#undef vec3_print
+#undef vec3_transform
+#undef transform_point
+#undef project
+
+#undef mat4x4_new
+#undef mat4x4_new_arena
+#undef mat4x4_destroy
+#undef mat4x4_zero
+#undef mat4x4_scale
+#undef mat4x4_translate
+#undef mat4x4_id
+#undef mat4x4_mult
+#undef mat4x4_copy
+#undef mat4x4_inv
+#undef mat4x4_inv_affine
+#undef mat4x4_to_quat
+
+#undef quat_mult_n
+#undef quat_norm_n
+#undef quat_set_euler_n
+#undef vec3_transform_n
+#undef vec3_norm_n
+#undef project_n
+#undef mat4x4_mult_n
+#undef mat4x4_mult_indexed
+#undef mat4x4_inv_n
+#undef mat4x4_to_quat_n
+
+#endif
@@ -0,0 +1,514 @@
+/*
+ *  Name: mathlib_simd.h
+ *  Description: SIMD helpers shared by the batched math kernels
+ *
+ *  Copyright (C) 2012  Jason Hall
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * This header is private to the mathlib sources. It wraps the AVX
+ * intrinsics in a small "vreal" api (a vector of reals) so the kernels
+ * read the same whether real is a float or a double. MATHLIB_FLOAT is
+ * defined by the float build (mathlib_batchf.c).
+ *
+ * The AVX2 kernels are compiled with a target pragma rather than global
+ * -m flags, so the program still runs on older cpus. Only call them
+ * after simd_avx2() has returned TRUE.
+ */
+
+#ifndef _MATHLIB_SIMD_H
+#define _MATHLIB_SIMD_H
+
+#include "mathlib.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && \
+    (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))
+#define MATHLIB_AVX2
+#endif
+
+/*
+ * sin & cos for the euler angle functions. The scalar and the vector
+ * versions do the same operations in the same order, so they give the
+ * same results. The angle is reduced to [-pi/4, pi/4] by subtracting a
+ * multiple of pi/2 split in three parts (Cody & Waite), which holds up
+ * to about 1e6 radians for double and 1e4 for float. The polynomials
+ * are the fdlibm ones for double and the cephes ones for float, good to
+ * an ulp or two.
+ */
+#define SINCOS_2OPI	6.36619772367581382433e-01
+
+#ifndef MATHLIB_FLOAT
+#define SINCOS_PIO2_1	1.57079632673412561417e+00
+#define SINCOS_PIO2_2	6.07710050630396597660e-11
+#define SINCOS_PIO2_3	2.02226624879595063154e-21
+
+#define SINCOS_S1	-1.66666666666666324348e-01
+#define SINCOS_S2	 8.33333333332248946124e-03
+#define SINCOS_S3	-1.98412698298579493134e-04
+#define SINCOS_S4	 2.75573137070700676789e-06
+#define SINCOS_S5	-2.50507602534068634195e-08
+#define SINCOS_S6	 1.58969099521155010221e-10
+
+#define SINCOS_C1	 4.16666666666666019037e-02
+#define SINCOS_C2	-1.38888888888741095749e-03
+#define SINCOS_C3	 2.48015872894767294178e-05
+#define SINCOS_C4	-2.75573143513906633035e-07
+#define SINCOS_C5	 2.08757232129817482790e-09
+#define SINCOS_C6	-1.13596475577881948265e-11
+#else
+#define SINCOS_PIO2_1	1.5703125
+#define SINCOS_PIO2_2	4.837512969970703125e-4
+#define SINCOS_PIO2_3	7.54978995489188216e-8
+
+#define SINCOS_S1	-1.6666654611e-1
+#define SINCOS_S2	 8.3321608736e-3
+#define SINCOS_S3	-1.9515295891e-4
+
+#define SINCOS_C1	 4.166664568298827e-2
+#define SINCOS_C2	-1.388731625493765e-3
+#define SINCOS_C3	 2.443315711809948e-5
+#endif
+
+/*
+ * mat4x4_inv() and mat4x4_inv_n() call a matrix singular when |det| is
+ * at most this times the product of the sums of the absolute values of
+ * its rows. That product bounds |det|, so the test doesn't depend on the
+ * scale of the matrix, and it is well above the rounding of either way
+ * of computing det, fused multiply-adds or not, so the scalar and vector
+ * versions agree on which matrices are singular. Only a matrix within a
+ * rounding error of the threshold could still be counted differently.
+ */
+#ifndef MATHLIB_FLOAT
+#define MAT4X4_SINGULAR_EPSILON	1e-13
+#else
+#define MAT4X4_SINGULAR_EPSILON	1e-5
+#endif
+
+/* is the whole number n odd */
+#define real_odd(n)	((n) * (real)0.5 != floor((n) * (real)0.5))
+
+static inline void
+real_sincos(real a, real *s, real *c)
+{
+    const real one = 1.0, half = 0.5, two_over_pi = SINCOS_2OPI;
+    const real pio2_1 = SINCOS_PIO2_1, pio2_2 = SINCOS_PIO2_2;
+    const real pio2_3 = SINCOS_PIO2_3;
+    real n, r, z, ps, pc, sr, cr, t;
+
+    n = a * two_over_pi;
+    n = rint(n);
+    r = a - n * pio2_1;
+    r = r - n * pio2_2;
+    r = r - n * pio2_3;
+    z = r * r;
+
+#ifndef MATHLIB_FLOAT
+    ps = SINCOS_S6;
+    ps = ps * z + (real)SINCOS_S5;
+    ps = ps * z + (real)SINCOS_S4;
+    ps = ps * z + (real)SINCOS_S3;
+    ps = ps * z + (real)SINCOS_S2;
+    ps = ps * z + (real)SINCOS_S1;
+
+    pc = SINCOS_C6;
+    pc = pc * z + (real)SINCOS_C5;
+    pc = pc * z + (real)SINCOS_C4;
+    pc = pc * z + (real)SINCOS_C3;
+    pc = pc * z + (real)SINCOS_C2;
+    pc = pc * z + (real)SINCOS_C1;
+#else
+    ps = SINCOS_S3;
+    ps = ps * z + (real)SINCOS_S2;
+    ps = ps * z + (real)SINCOS_S1;
+
+    pc = SINCOS_C3;
+    pc = pc * z + (real)SINCOS_C2;
+    pc = pc * z + (real)SINCOS_C1;
+#endif
+
+    sr = r + r * z * ps;
+    cr = (one - half * z) + z * z * pc;
+
+    // n mod 4 is the quadrant: sin, cos / cos, -sin / -sin, -cos / -cos, sin
+    if (real_odd(n)) {
+	t = sr;
+	sr = cr;
+	cr = t;
+    }
+    t = n * half;
+    t = floor(t);
+    if (real_odd(t))
+	sr = -sr;
+    t = (n + one) * half;
+    t = floor(t);
+    if (real_odd(t))
+	cr = -cr;
+
+    *s = sr;
+    *c = cr;
+}
+
+/*
+ * the axes of every euler_order_t, in the order they are applied, and
+ * whether the order is cyclic (xyz, yzx, zxy) or not
+ */
+static const int8_t euler_axes[6][4] = {
+    { X, Y, Z, TRUE },		// EULER_XYZ
+    { X, Z, Y, FALSE },		// EULER_XZY
+    { Y, X, Z, FALSE },		// EULER_YXZ
+    { Y, Z, X, TRUE },		// EULER_YZX
+    { Z, X, Y, TRUE },		// EULER_ZXY
+    { Z, Y, X, FALSE }		// EULER_ZYX
+};
+
+#ifdef MATHLIB_AVX2
+#include <immintrin.h>
+
+/*
+ * vreal holds as many reals as fit in an AVX register, v4real holds
+ * exactly four (one matrix column or one quaternion).
+ *
+ * The vreal_cmp*() macros return a mask with all bits set where the
+ * test is true, vreal_blend() picks b where the mask is set and a
+ * elsewhere.
+ *
+ * vreal_rsqrt() is the cpu's 12 bit reciprocal square root estimate, done
+ * in float for doubles too. vreal_andnot(a,b) is ~a & b.
+ * vreal_movemask() packs the top bit of every element into an int.
+ *
+ * vreal_signmask() has only the sign bits set, for vreal_xor() and
+ * vreal_andnot(). It is made from integer bits rather than written as
+ * -0.0, which reads as a number that -ffast-math may take for 0.0. That
+ * is fine as a bit mask, but don't choose between it and zero, see
+ * quat_set_euler_n_avx2().
+ */
+#ifndef MATHLIB_FLOAT
+typedef __m256d vreal;
+#define VREAL_WIDTH		4
+#define vreal_load(p)		_mm256_loadu_pd(p)
+#define vreal_store(p,a)	_mm256_storeu_pd((p), (a))
+#define vreal_set1(a)		_mm256_set1_pd(a)
+#define vreal_add(a,b)		_mm256_add_pd((a), (b))
+#define vreal_sub(a,b)		_mm256_sub_pd((a), (b))
+#define vreal_mul(a,b)		_mm256_mul_pd((a), (b))
+#define vreal_fmadd(a,b,c)	_mm256_fmadd_pd((a), (b), (c))
+#define vreal_fnmadd(a,b,c)	_mm256_fnmadd_pd((a), (b), (c))
+#define vreal_div(a,b)		_mm256_div_pd((a), (b))
+#define vreal_sqrt(a)		_mm256_sqrt_pd(a)
+#define vreal_round(a)		_mm256_round_pd((a), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)
+#define vreal_floor(a)		_mm256_floor_pd(a)
+#define vreal_rsqrt(a)		_mm256_cvtps_pd(_mm_rsqrt_ps(_mm256_cvtpd_ps(a)))
+#define vreal_and(a,b)		_mm256_and_pd((a), (b))
+#define vreal_andnot(a,b)	_mm256_andnot_pd((a), (b))
+#define vreal_xor(a,b)		_mm256_xor_pd((a), (b))
+#define vreal_cmpge(a,b)	_mm256_cmp_pd((a), (b), _CMP_GE_OQ)
+#define vreal_cmpneq(a,b)	_mm256_cmp_pd((a), (b), _CMP_NEQ_UQ)
+#define vreal_cmplt(a,b)	_mm256_cmp_pd((a), (b), _CMP_LT_OQ)
+#define vreal_cmpgt(a,b)	_mm256_cmp_pd((a), (b), _CMP_GT_OQ)
+#define vreal_cmple(a,b)	_mm256_cmp_pd((a), (b), _CMP_LE_OQ)
+#define vreal_movemask(a)	_mm256_movemask_pd(a)
+#define vreal_setzero()		_mm256_setzero_pd()
+#define vreal_blend(a,b,mask)	_mm256_blendv_pd((a), (b), (mask))
+#define vreal_signmask()	_mm256_castsi256_pd(_mm256_set1_epi64x(INT64_MIN))
+
+typedef __m256d v4real;
+#define v4real_load(p)		_mm256_loadu_pd(p)
+#define v4real_store(p,a)	_mm256_storeu_pd((p), (a))
+#define v4real_set1(a)		_mm256_set1_pd(a)
+#define v4real_add(a,b)		_mm256_add_pd((a), (b))
+#define v4real_mul(a,b)		_mm256_mul_pd((a), (b))
+#define v4real_fmadd(a,b,c)	_mm256_fmadd_pd((a), (b), (c))
+#else
+typedef __m256 vreal;
+#define VREAL_WIDTH		8
+#define vreal_load(p)		_mm256_loadu_ps(p)
+#define vreal_store(p,a)	_mm256_storeu_ps((p), (a))
+#define vreal_set1(a)		_mm256_set1_ps(a)
+#define vreal_add(a,b)		_mm256_add_ps((a), (b))
+#define vreal_sub(a,b)		_mm256_sub_ps((a), (b))
+#define vreal_mul(a,b)		_mm256_mul_ps((a), (b))
+#define vreal_fmadd(a,b,c)	_mm256_fmadd_ps((a), (b), (c))
+#define vreal_fnmadd(a,b,c)	_mm256_fnmadd_ps((a), (b), (c))
+#define vreal_div(a,b)		_mm256_div_ps((a), (b))
+#define vreal_sqrt(a)		_mm256_sqrt_ps(a)
+#define vreal_round(a)		_mm256_round_ps((a), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)
+#define vreal_floor(a)		_mm256_floor_ps(a)
+#define vreal_rsqrt(a)		_mm256_rsqrt_ps(a)
+#define vreal_and(a,b)		_mm256_and_ps((a), (b))
+#define vreal_andnot(a,b)	_mm256_andnot_ps((a), (b))
+#define vreal_xor(a,b)		_mm256_xor_ps((a), (b))
+#define vreal_cmpge(a,b)	_mm256_cmp_ps((a), (b), _CMP_GE_OQ)
+#define vreal_cmpneq(a,b)	_mm256_cmp_ps((a), (b), _CMP_NEQ_UQ)
+#define vreal_cmplt(a,b)	_mm256_cmp_ps((a), (b), _CMP_LT_OQ)
+#define vreal_cmpgt(a,b)	_mm256_cmp_ps((a), (b), _CMP_GT_OQ)
+#define vreal_cmple(a,b)	_mm256_cmp_ps((a), (b), _CMP_LE_OQ)
+#define vreal_movemask(a)	_mm256_movemask_ps(a)
+#define vreal_setzero()		_mm256_setzero_ps()
+#define vreal_blend(a,b,mask)	_mm256_blendv_ps((a), (b), (mask))
+#define vreal_signmask()	_mm256_castsi256_ps(_mm256_set1_epi32(INT32_MIN))
+
+typedef __m128 v4real;
+#define v4real_load(p)		_mm_loadu_ps(p)
+#define v4real_store(p,a)	_mm_storeu_ps((p), (a))
+#define v4real_set1(a)		_mm_set1_ps(a)
+#define v4real_add(a,b)		_mm_add_ps((a), (b))
+#define v4real_mul(a,b)		_mm_mul_ps((a), (b))
+#define v4real_fmadd(a,b,c)	_mm_fmadd_ps((a), (b), (c))
+#endif
+
+/*
+ * vreal_madd(a,b,c)  = c + a*b
+ * vreal_nmadd(a,b,c) = c - a*b
+ *
+ * In strict mode these round the product before the sum, exactly like
+ * the scalar code does, so batched and scalar results are bit identical.
+ */
+#ifdef MATHLIB_STRICT
+#define vreal_madd(a,b,c)	vreal_add((c), vreal_mul((a), (b)))
+#define vreal_nmadd(a,b,c)	vreal_sub((c), vreal_mul((a), (b)))
+#define v4real_madd(a,b,c)	v4real_add((c), v4real_mul((a), (b)))
+#else
+#define vreal_madd(a,b,c)	vreal_fmadd((a), (b), (c))
+#define vreal_nmadd(a,b,c)	vreal_fnmadd((a), (b), (c))
+#define v4real_madd(a,b,c)	v4real_fmadd((a), (b), (c))
+#endif
+
+#pragma GCC push_options
+#pragma GCC target("avx2,fma")
+
+#ifndef MATHLIB_FLOAT
+/* load 4 packed vec3_t's and split them into x, y & z vectors */
+static inline void
+vreal_load3(real *p, vreal *x, vreal *y, vreal *z)
+{
+    __m256d a = _mm256_loadu_pd(p);				// x0 y0 z0 x1
+    __m256d b = _mm256_loadu_pd(p + 4);				// y1 z1 x2 y2
+    __m256d c = _mm256_loadu_pd(p + 8);				// z2 x3 y3 z3
+    __m256d t0 = _mm256_blend_pd(a, b, 0xc);			// x0 y0 x2 y2
+    __m256d t1 = _mm256_permute2f128_pd(a, c, 0x21);		// z0 x1 z2 x3
+    __m256d t2 = _mm256_blend_pd(b, c, 0xc);			// y1 z1 y3 z3
+
+    *x = _mm256_blend_pd(t0, t1, 0xa);
+    *y = _mm256_shuffle_pd(t0, t2, 0x5);
+    *z = _mm256_blend_pd(t1, t2, 0xa);
+}
+
+/* the reverse of vreal_load3() */
+static inline void
+vreal_store3(real *p, vreal x, vreal y, vreal z)
+{
+    __m256d t0 = _mm256_shuffle_pd(x, y, 0x0);			// x0 y0 x2 y2
+    __m256d t1 = _mm256_shuffle_pd(z, x, 0xa);			// z0 x1 z2 x3
+    __m256d t2 = _mm256_shuffle_pd(y, z, 0xf);			// y1 z1 y3 z3
+
+    _mm256_storeu_pd(p,     _mm256_permute2f128_pd(t0, t1, 0x20));
+    _mm256_storeu_pd(p + 4, _mm256_permute2f128_pd(t2, t0, 0x30));
+    _mm256_storeu_pd(p + 8, _mm256_permute2f128_pd(t1, t2, 0x31));
+}
+
+/*
+ * load 4 reals from each of 4 records spaced stride reals apart, and
+ * transpose them so a holds element 0 of every record, b element 1...
+ */
+static inline void
+vreal_load4t(real *p, int stride, vreal *a, vreal *b, vreal *c, vreal *d)
+{
+    __m256d r0 = _mm256_loadu_pd(p);
+    __m256d r1 = _mm256_loadu_pd(p + stride);
+    __m256d r2 = _mm256_loadu_pd(p + stride * 2);
+    __m256d r3 = _mm256_loadu_pd(p + stride * 3);
+    __m256d t0 = _mm256_unpacklo_pd(r0, r1);			// a0 a1 c0 c1
+    __m256d t1 = _mm256_unpackhi_pd(r0, r1);			// b0 b1 d0 d1
+    __m256d t2 = _mm256_unpacklo_pd(r2, r3);			// a2 a3 c2 c3
+    __m256d t3 = _mm256_unpackhi_pd(r2, r3);			// b2 b3 d2 d3
+
+    *a = _mm256_permute2f128_pd(t0, t2, 0x20);
+    *b = _mm256_permute2f128_pd(t1, t3, 0x20);
+    *c = _mm256_permute2f128_pd(t0, t2, 0x31);
+    *d = _mm256_permute2f128_pd(t1, t3, 0x31);
+}
+
+/* the reverse of vreal_load4t() */
+static inline void
+vreal_store4t(real *p, int stride, vreal a, vreal b, vreal c, vreal d)
+{
+    __m256d t0 = _mm256_unpacklo_pd(a, b);			// a0 b0 a2 b2
+    __m256d t1 = _mm256_unpackhi_pd(a, b);			// a1 b1 a3 b3
+    __m256d t2 = _mm256_unpacklo_pd(c, d);			// c0 d0 c2 d2
+    __m256d t3 = _mm256_unpackhi_pd(c, d);			// c1 d1 c3 d3
+
+    _mm256_storeu_pd(p,              _mm256_permute2f128_pd(t0, t2, 0x20));
+    _mm256_storeu_pd(p + stride,     _mm256_permute2f128_pd(t1, t3, 0x20));
+    _mm256_storeu_pd(p + stride * 2, _mm256_permute2f128_pd(t0, t2, 0x31));
+    _mm256_storeu_pd(p + stride * 3, _mm256_permute2f128_pd(t1, t3, 0x31));
+}
+#else
+/* load 8 packed vec3_t's and split them into x, y & z vectors */
+static inline void
+vreal_load3(real *p, vreal *x, vreal *y, vreal *z)
+{
+    __m256 a = _mm256_loadu_ps(p);
+    __m256 b = _mm256_loadu_ps(p + 8);
+    __m256 c = _mm256_loadu_ps(p + 16);
+    // move points 0-3 to the low lanes and 4-7 to the high lanes, then
+    // each lane holds x0 y0 z0 x1 | y1 z1 x2 y2 | z2 x3 y3 z3
+    __m256 m0 = _mm256_permute2f128_ps(a, b, 0x30);
+    __m256 m1 = _mm256_permute2f128_ps(a, c, 0x21);
+    __m256 m2 = _mm256_permute2f128_ps(b, c, 0x30);
+    __m256 t0 = _mm256_shuffle_ps(m1, m2, _MM_SHUFFLE(2,1,3,2));	// x2 y2 x3 y3
+    __m256 t1 = _mm256_shuffle_ps(m0, m1, _MM_SHUFFLE(1,0,2,1));	// y0 z0 y1 z1
+
+    *x = _mm256_shuffle_ps(m0, t0, _MM_SHUFFLE(2,0,3,0));
+    *y = _mm256_shuffle_ps(t1, t0, _MM_SHUFFLE(3,1,2,0));
+    *z = _mm256_shuffle_ps(t1, m2, _MM_SHUFFLE(3,0,3,1));
+}
+
+/* the reverse of vreal_load3() */
+static inline void
+vreal_store3(real *p, vreal x, vreal y, vreal z)
+{
+    __m256 t0 = _mm256_shuffle_ps(x, y, _MM_SHUFFLE(2,0,2,0));	// x0 x2 y0 y2
+    __m256 t1 = _mm256_shuffle_ps(z, x, _MM_SHUFFLE(3,1,2,0));	// z0 z2 x1 x3
+    __m256 t2 = _mm256_shuffle_ps(y, z, _MM_SHUFFLE(3,1,3,1));	// y1 y3 z1 z3
+    __m256 m0 = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(2,0,2,0));	// x0 y0 z0 x1
+    __m256 m1 = _mm256_shuffle_ps(t2, t0, _MM_SHUFFLE(3,1,2,0));	// y1 z1 x2 y2
+    __m256 m2 = _mm256_shuffle_ps(t1, t2, _MM_SHUFFLE(3,1,3,1));	// z2 x3 y3 z3
+
+    _mm256_storeu_ps(p,      _mm256_permute2f128_ps(m0, m1, 0x20));
+    _mm256_storeu_ps(p + 8,  _mm256_permute2f128_ps(m2, m0, 0x30));
+    _mm256_storeu_ps(p + 16, _mm256_permute2f128_ps(m1, m2, 0x31));
+}
+
+/*
+ * load 4 reals from each of 8 records spaced stride reals apart, and
+ * transpose them so a holds element 0 of every record, b element 1...
+ */
+static inline void
+vreal_load4t(real *p, int stride, vreal *a, vreal *b, vreal *c, vreal *d)
+{
+    // records 0-3 go in the low lanes and 4-7 in the high lanes
+    __m256 r0 = _mm256_insertf128_ps(_mm256_castps128_ps256(
+		_mm_loadu_ps(p)), _mm_loadu_ps(p + stride * 4), 1);
+    __m256 r1 = _mm256_insertf128_ps(_mm256_castps128_ps256(
+		_mm_loadu_ps(p + stride)), _mm_loadu_ps(p + stride * 5), 1);
+    __m256 r2 = _mm256_insertf128_ps(_mm256_castps128_ps256(
+		_mm_loadu_ps(p + stride * 2)), _mm_loadu_ps(p + stride * 6), 1);
+    __m256 r3 = _mm256_insertf128_ps(_mm256_castps128_ps256(
+		_mm_loadu_ps(p + stride * 3)), _mm_loadu_ps(p + stride * 7), 1);
+    __m256 t0 = _mm256_unpacklo_ps(r0, r1);			// a0 a1 b0 b1
+    __m256 t1 = _mm256_unpackhi_ps(r0, r1);			// c0 c1 d0 d1
+    __m256 t2 = _mm256_unpacklo_ps(r2, r3);			// a2 a3 b2 b3
+    __m256 t3 = _mm256_unpackhi_ps(r2, r3);			// c2 c3 d2 d3
+
+    *a = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1,0,1,0));
+    *b = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3,2,3,2));
+    *c = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1,0,1,0));
+    *d = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3,2,3,2));
+}
+
+/* the reverse of vreal_load4t() */
+static inline void
+vreal_store4t(real *p, int stride, vreal a, vreal b, vreal c, vreal d)
+{
+    __m256 t0 = _mm256_unpacklo_ps(a, b);			// a0 b0 a1 b1
+    __m256 t1 = _mm256_unpackhi_ps(a, b);			// a2 b2 a3 b3
+    __m256 t2 = _mm256_unpacklo_ps(c, d);			// c0 d0 c1 d1
+    __m256 t3 = _mm256_unpackhi_ps(c, d);			// c2 d2 c3 d3
+    __m256 r0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1,0,1,0));
+    __m256 r1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3,2,3,2));
+    __m256 r2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1,0,1,0));
+    __m256 r3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3,2,3,2));
+
+    _mm_storeu_ps(p,              _mm256_castps256_ps128(r0));
+    _mm_storeu_ps(p + stride,     _mm256_castps256_ps128(r1));
+    _mm_storeu_ps(p + stride * 2, _mm256_castps256_ps128(r2));
+    _mm_storeu_ps(p + stride * 3, _mm256_castps256_ps128(r3));
+    _mm_storeu_ps(p + stride * 4, _mm256_extractf128_ps(r0, 1));
+    _mm_storeu_ps(p + stride * 5, _mm256_extractf128_ps(r1, 1));
+    _mm_storeu_ps(p + stride * 6, _mm256_extractf128_ps(r2, 1));
+    _mm_storeu_ps(p + stride * 7, _mm256_extractf128_ps(r3, 1));
+}
+#endif
+
+/* the same as real_sincos(), on a vector */
+static inline void
+vreal_sincos(vreal a, vreal *s, vreal *c)
+{
+    const vreal one = vreal_set1(1.0), half = vreal_set1(0.5);
+    const vreal sign = vreal_signmask();
+    vreal n, r, z, ps, pc, sr, cr, t, odd;
+
+    n = vreal_mul(a, vreal_set1(SINCOS_2OPI));
+    n = vreal_round(n);
+    r = vreal_nmadd(n, vreal_set1(SINCOS_PIO2_1), a);
+    r = vreal_nmadd(n, vreal_set1(SINCOS_PIO2_2), r);
+    r = vreal_nmadd(n, vreal_set1(SINCOS_PIO2_3), r);
+    z = vreal_mul(r, r);
+
+#ifndef MATHLIB_FLOAT
+    ps = vreal_set1(SINCOS_S6);
+    ps = vreal_madd(ps, z, vreal_set1(SINCOS_S5));
+    ps = vreal_madd(ps, z, vreal_set1(SINCOS_S4));
+    ps = vreal_madd(ps, z, vreal_set1(SINCOS_S3));
+    ps = vreal_madd(ps, z, vreal_set1(SINCOS_S2));
+    ps = vreal_madd(ps, z, vreal_set1(SINCOS_S1));
+
+    pc = vreal_set1(SINCOS_C6);
+    pc = vreal_madd(pc, z, vreal_set1(SINCOS_C5));
+    pc = vreal_madd(pc, z, vreal_set1(SINCOS_C4));
+    pc = vreal_madd(pc, z, vreal_set1(SINCOS_C3));
+    pc = vreal_madd(pc, z, vreal_set1(SINCOS_C2));
+    pc = vreal_madd(pc, z, vreal_set1(SINCOS_C1));
+#else
+    ps = vreal_set1(SINCOS_S3);
+    ps = vreal_madd(ps, z, vreal_set1(SINCOS_S2));
+    ps = vreal_madd(ps, z, vreal_set1(SINCOS_S1));
+
+    pc = vreal_set1(SINCOS_C3);
+    pc = vreal_madd(pc, z, vreal_set1(SINCOS_C2));
+    pc = vreal_madd(pc, z, vreal_set1(SINCOS_C1));
+#endif
+
+    sr = vreal_madd(vreal_mul(r, z), ps, r);
+    cr = vreal_madd(vreal_mul(z, z), pc, vreal_nmadd(half, z, one));
+
+#define vreal_odd(n) \
+	vreal_cmpneq(vreal_mul((n), half), vreal_floor(vreal_mul((n), half)))
+    odd = vreal_odd(n);
+    t = vreal_blend(sr, cr, odd);
+    cr = vreal_blend(cr, sr, odd);
+    sr = t;
+    t = vreal_floor(vreal_mul(n, half));
+    sr = vreal_xor(sr, vreal_and(vreal_odd(t), sign));
+    t = vreal_floor(vreal_mul(vreal_add(n, one), half));
+    cr = vreal_xor(cr, vreal_and(vreal_odd(t), sign));
+#undef vreal_odd
+
+    *s = sr;
+    *c = cr;
+}
+
+#pragma GCC pop_options
+
+#endif /* MATHLIB_AVX2 */
+
+gboolean simd_avx2(void);
+
+/* split [0, n) into chunks and run them on the worker threads */
+typedef void (*batch_func_t)(void *data, int32_t start, int32_t end);
+void batch_run(batch_func_t func, void *data, int32_t n);
+
+#endif
@@ -70,6 +70,10 @@
 /* memset()/strncpy() */
 #include <string.h>
 
+/* INT_MAX, errno for strtol() */
+#include <limits.h>
+#include <errno.h>
+
 #include <glib.h>
 #include <gtk/gtk.h>
 #include <glade/glade.h>
@@ -81,9 +85,25 @@
 
 
 #include "mathlib.h"
+#include "calc.h"
+#include "pose_stream.h"
+#include "jobs.h"
+#include "numfmt.h"
+#include "numparse.h"
 
 #include "../config.h"
 
+#ifdef EMBEDDED_DATA
+// the share/ files compiled in, the data is nul terminated
+typedef struct {
+    const char *name;
+    const char *data;
+    gsize size;
+} embedded_file_t;
+
+#include "embedded_data.h"
+#endif
+
 char *glade_search_dirs[] = {
     "./",
     "share",
@@ -93,34 +113,50 @@ char *glade_search_dirs[] = {
     PACKAGE_SOURCE_DIR "/share"
 };
 
+// xml is only there while the widget is being set up, every widget
+// needed later is looked up before glade_widget_release().
 typedef struct {
     GtkWidget *widget;
     GladeXML *xml;
 } glade_widget_t;
 
 // gtk composite widget types
+// m, v, q and s hold what the entries last displayed, bit i of synced
+// is set while entry i still shows that value (see entries_set()).
+// gwidget and the entries are NULL until the widget is built into parent.
 typedef struct {
     glade_widget_t *gwidget;
     GtkWidget	*entries[16];
     mat4x4_t	m;
+    guint32	synced;
+    GtkWidget	*parent;
+    GtkWidget	*toolbar_box;
 } gtk_matrix_t;
 
 typedef struct {
     glade_widget_t *gwidget;
     GtkWidget	*entries[3];
     vec3_t	v;
+    guint32	synced;
+    GtkWidget	*parent;
+    GtkWidget	*toolbar_box;
 } gtk_vector_t;
 
 typedef struct {
     glade_widget_t *gwidget;
     GtkWidget	*entries[4];
     quat_t	q;
+    guint32	synced;
+    GtkWidget	*parent;
+    GtkWidget	*toolbar_box;
 } gtk_quat_t;
 
 typedef struct {
     glade_widget_t *gwidget;
     GtkWidget	*entry;
     real	s;
+    guint32	synced;
+    GtkWidget	*parent;
 } gtk_scalar_t;
 
 ///////////////////////////////////////////////////////////////////////
@@ -132,8 +168,10 @@ typedef struct {
 typedef struct {
     glade_widget_t *gwidget;
     gtk_matrix_t *m;
+    GtkWidget *memory_box;
     GtkWidget *button_id;
     GtkWidget *button_zero;
+    GtkWidget *button_inv;
     GtkWidget *convert_select;
     GtkWidget *convert_button;
 } gtk_matrix_toolbar_t;
@@ -141,6 +179,7 @@ typedef struct {
 typedef struct {
     glade_widget_t *gwidget;
     gtk_matrix_t *m;
+    GtkWidget *memory_box;
     GtkWidget *button_copy_a;
     GtkWidget *button_copy_b;
 } gtk_matrix_result_toolbar_t;
@@ -148,6 +187,7 @@ typedef struct {
 typedef struct {
     glade_widget_t *gwidget;
     gtk_vector_t *v;
+    GtkWidget *memory_box;
     GtkWidget *button_zero;
     GtkWidget *button_unitize;
     GtkWidget *button_length;
@@ -156,6 +196,7 @@ typedef struct {
 typedef struct {
     glade_widget_t *gwidget;
     gtk_vector_t *v;
+    GtkWidget *memory_box;
     GtkWidget *button_unitize;
     GtkWidget *button_copy_a;
     GtkWidget *button_copy_b;
@@ -168,6 +209,7 @@ typedef struct {
 typedef struct {
     glade_widget_t *gwidget;
     gtk_quat_t *q;
+    GtkWidget *memory_box;
     GtkWidget *button_zero;
     GtkWidget *button_id;
     GtkWidget *button_unitize;
@@ -178,6 +220,7 @@ typedef struct {
 typedef struct {
     glade_widget_t *gwidget;
     gtk_quat_t *q;
+    GtkWidget *memory_box;
     GtkWidget *button_unitize;
     GtkWidget *button_copy_a;
     GtkWidget *button_copy_b;
@@ -279,75 +322,237 @@ GtkWidget *notebook_c;
 
 int MathMode = 0;
 
+// TRUE while entries_set() changes the text, so it isn't taken for typing
+gboolean entries_updating = FALSE;
+
+/*
+ * Display n numbers in n entries. shown and synced cache what the entries
+ * display, only entries whose value changed are touched: every
+ * gtk_entry_set_text() means a relayout and redraw. The changed ones are
+ * formatted into one buffer in a single pass, shortest round trip and
+ * never with an exponent: exponents appear on the right side of the text
+ * entry boxes and can be missed by users, making them think the number is
+ * smaller or larger.
+ */
+void
+entries_set(GtkWidget **entries, real *shown, guint32 *synced, real *v, int n)
+{
+    char buf[16 * NUMFMT_MAX];
+    int offsets[16], cells[16];
+    real changed[16];
+    int i, count = 0;
+
+    g_assert(n <= 16);
+
+    // not built yet, keep the values until it is
+    if (entries[0] == NULL) {
+	memmove(shown, v, n * sizeof(real));
+	*synced = 0;
+	return;
+    }
+
+    // compare the bits, so 0 and -0 differ and nan matches itself
+    for (i = 0; i < n; i++) {
+	if ((*synced & (1u << i)) && memcmp(&shown[i], &v[i], sizeof(real)) == 0)
+	    continue;
+	cells[count] = i;
+	changed[count++] = v[i];
+    }
+    if (count == 0)
+	return;
+
+    numfmt_array(changed, count, '\0', buf, sizeof(buf), offsets);
+
+    entries_updating = TRUE;
+    for (i = 0; i < count; i++) {
+	gtk_entry_set_text(GTK_ENTRY(entries[cells[i]]), buf + offsets[i]);
+	// a number now, whatever entries_get() made of it before
+	gtk_widget_modify_base(entries[cells[i]], GTK_STATE_NORMAL, NULL);
+	shown[cells[i]] = changed[i];
+	*synced |= 1u << cells[i];
+    }
+    entries_updating = FALSE;
+}
+
+/* typing, pasting or cutting makes the cached value of the entry stale */
+void
+entry_changed_cb(GtkEditable *editable, gpointer user_data)
+{
+    guint32 *synced = user_data;
+    int cell;
+
+    if (entries_updating)
+	return;
+
+    cell = GPOINTER_TO_INT(g_object_get_data(G_OBJECT(editable), "cell"));
+    *synced &= ~(1u << cell);
+}
+
 void
-format_number(real n, char *buf, int len)
+entries_watch(GtkWidget **entries, guint32 *synced, int n)
 {
-    // use %g so whole numbers are displayed as a whole number
-    snprintf(buf, len, "%g", n);
-    if (strchr(buf, 'e') != NULL) {
-	// exponent notation detected, use alternate format.
-	// exponents appear on the right side of the text
-	// entry boxes and can be missed by users, making them
-	// think the number is smaller or larger, so use the
-	// %f number format instead for these numbers
-	snprintf(buf, len, "%f", n);
+    int i;
+
+    for (i = 0; i < n; i++) {
+	g_object_set_data(G_OBJECT(entries[i]), "cell", GINT_TO_POINTER(i));
+	g_signal_connect(G_OBJECT(entries[i]), "changed",
+		G_CALLBACK(entry_changed_cb), synced);
     }
-} 
+}
 
 ///////////////////////////////////////////////////////////////////////
 /////////////////////  TEXTAREA RELATED FUNCTIONS  ////////////////////
 ///////////////////////////////////////////////////////////////////////
 
-/* overload printf to print to our text area instead of stdout */
-#define printf _printf
+/*
+ * The notes are buffered: printf() formats straight into a preallocated
+ * buffer and a timeout moves everything that piled up into the text view
+ * in one insert and one scroll, at most once a frame. A matrix multiply
+ * explains itself in 32 lines, inserting and scrolling for each of them
+ * is what made the window crawl. Only the last notes.max_lines lines are
+ * kept.
+ */
+#define NOTES_PENDING_SIZE	(64 * 1024)
+#define NOTES_FLUSH_INTERVAL	16	/* milliseconds, about one frame */
+#define NOTES_DEFAULT_LINES	2000
+
+struct {
+    char pending[NOTES_PENDING_SIZE];
+    size_t len;
+    guint flush_source;		/* 0 when no flush is scheduled */
+    GtkTextMark *end;
+    int max_lines;
+} notes = { .max_lines = NOTES_DEFAULT_LINES };
+
+/* drop the oldest lines beyond the limit */
 void
-_printf(char *fmt, ...)
+notes_trim(GtkTextBuffer *text_buffer)
 {
-    /* Guess we need no more than 100 bytes. */
-    int n, size = 100;
-    char *p;
-    va_list ap;
+    GtkTextIter start, cut, end;
+    int lines;
 
-    if ((p = malloc (size)) == NULL)
-        return;
+    // a newline at the very end leaves an empty last line, which doesn't count
+    lines = gtk_text_buffer_get_line_count(text_buffer);
+    gtk_text_buffer_get_end_iter(text_buffer, &end);
+    if (lines > 1 && gtk_text_iter_starts_line(&end))
+	lines--;
+    if (lines <= notes.max_lines)
+	return;
 
-    for (;;) {
-        /* Try to print in the allocated space. */
-        va_start(ap, fmt);
-        n = vsnprintf (p, size, fmt, ap);
-        va_end(ap);
+    gtk_text_buffer_get_start_iter(text_buffer, &start);
+    gtk_text_buffer_get_iter_at_line(text_buffer, &cut, lines - notes.max_lines);
+    gtk_text_buffer_delete(text_buffer, &start, &cut);
+}
 
-        /* If that worked, return the string. */
-        if (n > -1 && n < size)
-	    break;
+gboolean
+notes_flush(gpointer data)
+{
+    GtkTextIter iter;
+    GtkTextBuffer *text_buffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(text_view));
+
+    notes.flush_source = 0;
+    if (notes.len == 0)
+	return FALSE;
+
+    gtk_text_buffer_get_end_iter(text_buffer, &iter);
+    gtk_text_buffer_insert_with_tags(text_buffer, &iter, notes.pending, notes.len, cyan, NULL);
+    notes.len = 0;
+
+    notes_trim(text_buffer);
+    gtk_text_view_scroll_to_mark(GTK_TEXT_VIEW(text_view), notes.end, 0.49, TRUE, 0, 0);
+
+    return FALSE;
+}
+
+void
+notes_schedule_flush(void)
+{
+    if (notes.flush_source == 0)
+	notes.flush_source = g_timeout_add(NOTES_FLUSH_INTERVAL, notes_flush, NULL);
+}
 
-        /* Else try again with more space. */
-        if (n > -1)             // glibc 2.1
-            size = n+1;         // precisely what is needed
-        else                    // glibc 2.0
-            size *= 2;          // twice the old size
+void
+notes_append(const char *text, size_t len)
+{
+    size_t n;
+
+    while (len > 0) {
+	if (notes.len == sizeof(notes.pending)) {
+	    // full, flush now instead of waiting for the timeout
+	    if (notes.flush_source != 0)
+		g_source_remove(notes.flush_source);
+	    notes_flush(NULL);
+	}
 
-        if ((p = realloc(p, size)) == NULL)
-            return;
+	n = MIN(len, sizeof(notes.pending) - notes.len);
+	memcpy(notes.pending + notes.len, text, n);
+	notes.len += n;
+	text += n;
+	len -= n;
     }
 
-    GtkTextIter iter;
+    notes_schedule_flush();
+}
+
+/* forget everything, shown and pending */
+void
+notes_clear(void)
+{
+    GtkTextIter start_iter, end_iter;
     GtkTextBuffer *text_buffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(text_view));
-    gtk_text_buffer_get_end_iter(text_buffer, &iter);
-    gtk_text_buffer_insert_with_tags(text_buffer, &iter, p, -1, cyan, NULL);
-    gtk_text_iter_forward_to_end(&iter);
-    gtk_text_view_scroll_to_iter(GTK_TEXT_VIEW(text_view), &iter, 0.49, TRUE, 0, 0);
 
-    free(p);
+    notes.len = 0;
+    gtk_text_buffer_get_start_iter(text_buffer, &start_iter);
+    gtk_text_buffer_get_end_iter(text_buffer, &end_iter);
+    gtk_text_buffer_delete(text_buffer, &start_iter, &end_iter);
 }
 
 void
-scrolledwindow1_size_allocate_cb(GtkWidget *widget, gpointer user_data)
+notes_init(void)
 {
     GtkTextIter iter;
     GtkTextBuffer *text_buffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(text_view));
+
+    // right gravity, so it stays at the end as text is inserted there
     gtk_text_buffer_get_end_iter(text_buffer, &iter);
-    gtk_text_view_scroll_to_iter(GTK_TEXT_VIEW(text_view), &iter, 0.49, TRUE, 0, 0);
+    notes.end = gtk_text_buffer_create_mark(text_buffer, "notes_end", &iter, FALSE);
+}
+
+/* overload printf to print to our text area instead of stdout */
+#define printf _printf
+void
+_printf(const char *fmt, ...)
+{
+    size_t space = sizeof(notes.pending) - notes.len;
+    char *p;
+    va_list ap;
+    int n;
+
+    // usually the line fits in what is left of the buffer
+    va_start(ap, fmt);
+    n = vsnprintf(notes.pending + notes.len, space, fmt, ap);
+    va_end(ap);
+    if (n < 0)
+	return;
+
+    if ((size_t) n < space) {
+	notes.len += n;
+	notes_schedule_flush();
+	return;
+    }
+
+    // it didn't, format it again on the heap
+    va_start(ap, fmt);
+    p = g_strdup_vprintf(fmt, ap);
+    va_end(ap);
+    notes_append(p, n);
+    g_free(p);
+}
+
+void
+scrolledwindow1_size_allocate_cb(GtkWidget *widget, gpointer user_data)
+{
+    gtk_text_view_scroll_to_mark(GTK_TEXT_VIEW(text_view), notes.end, 0.49, TRUE, 0, 0);
 }
 
 ///////////////////////////////////////////////////////////////////////
@@ -406,6 +611,161 @@ find_data_file(char *file, char *path, int pathlen)
     return FALSE;
 }
 
+#ifdef EMBEDDED_DATA
+/* a compiled in data file by name, without touching the file system */
+const embedded_file_t *
+embedded_file_find(const char *file)
+{
+    int i;
+
+    for (i = 0; i < G_N_ELEMENTS(embedded_files); i++) {
+	if (strcmp(embedded_files[i].name, file) == 0)
+	    return &embedded_files[i];
+    }
+
+    return NULL;
+}
+#endif
+
+/*
+ * Every .glade file is located and read once and then kept in memory,
+ * widgets are built from that copy with glade_xml_new_from_buffer(), and
+ * only the toplevel asked for is constructed. libglade can't build twice
+ * from one parsed tree and GTK widgets can't be cloned, so each build
+ * still parses the buffer, but there is no more file searching and
+ * reading, and a dialog no longer builds a second main window with it.
+ */
+typedef struct {
+    char *file;
+    gchar *data;
+    gsize size;
+    int built;			// GladeXML objects made from it
+    int live;			// of those, not yet released
+    double seconds;		// spent reading and building
+} glade_template_t;
+
+GHashTable *glade_templates;
+
+glade_template_t *
+glade_template_find(char *file)
+{
+    glade_template_t *t;
+#ifndef EMBEDDED_DATA
+    GError *error = NULL;
+    char buf[BUFSIZ];
+#endif
+
+    if (glade_templates == NULL)
+	glade_templates = g_hash_table_new(g_str_hash, g_str_equal);
+
+    t = g_hash_table_lookup(glade_templates, file);
+    if (t != NULL)
+	return t;
+
+#ifdef EMBEDDED_DATA
+    const embedded_file_t *e = embedded_file_find(file);
+
+    if (e == NULL) {
+	fprintf(stderr, "ERROR: glade file '%s' is not compiled in\n", file);
+	exit(1);
+    }
+
+    // the compiled in copy is used in place, never freed
+    t = g_new0(glade_template_t, 1);
+    t->file = g_strdup(file);
+    t->data = (gchar *) e->data;
+    t->size = e->size;
+#else
+    if (find_data_file(file, buf, BUFSIZ) != TRUE) {
+	fprintf(stderr, "ERROR: unable to locate glade file '%s'\n", file);
+	exit(1);
+    }
+
+    t = g_new0(glade_template_t, 1);
+    t->file = g_strdup(file);
+    if (!g_file_get_contents(buf, &t->data, &t->size, &error)) {
+	fprintf(stderr, "ERROR: unable to read glade file '%s': %s\n", buf, error->message);
+	exit(1);
+    }
+#endif
+
+    g_hash_table_insert(glade_templates, t->file, t);
+    return t;
+}
+
+void
+glade_template_xml_finalized(gpointer data, GObject *xml)
+{
+    glade_template_t *t = data;
+
+    t->live--;
+}
+
+/* build the widget tree under root from a glade file */
+GladeXML *
+glade_template_new(char *file, char *root)
+{
+    glade_template_t *t;
+    GladeXML *xml;
+    GTimer *timer;
+
+    timer = g_timer_new();
+
+    t = glade_template_find(file);
+    xml = glade_xml_new_from_buffer(t->data, t->size, root, NULL);
+    if (xml == NULL) {
+	fprintf(stderr, "ERROR: unable to load '%s' from glade file '%s'\n", root, file);
+	exit(1);
+    }
+
+    t->built++;
+    t->live++;
+    g_object_weak_ref(G_OBJECT(xml), glade_template_xml_finalized, t);
+    t->seconds += g_timer_elapsed(timer, NULL);
+    g_timer_destroy(timer);
+
+    return xml;
+}
+
+void
+glade_template_report_one(gpointer key, gpointer value, gpointer user_data)
+{
+    glade_template_t *t = value;
+
+    fprintf(stderr, "mvqcalc:   %-28s %6lu bytes %3d built %3d live %8.3f ms\n",
+	    t->file, (unsigned long) t->size, t->built, t->live, t->seconds * 1000);
+}
+
+/*
+ * resident set size of the whole process in kB, or -1 where /proc can't
+ * tell. Not just the UI: the libraries, heap and everything else count.
+ */
+long
+process_resident(void)
+{
+    FILE *f;
+    long pages, resident;
+
+    if ((f = fopen("/proc/self/statm", "r")) == NULL)
+	return -1;
+    if (fscanf(f, "%ld %ld", &pages, &resident) != 2)
+	resident = -1;
+    fclose(f);
+
+    return resident < 0 ? -1 : resident * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+/* where startup time went, for --startup-time */
+void
+glade_template_report(GTimer *startup)
+{
+    fprintf(stderr, "mvqcalc: startup took %.3f ms, glade files read once each:\n",
+	    g_timer_elapsed(startup, NULL) * 1000);
+    if (glade_templates != NULL)
+	g_hash_table_foreach(glade_templates, glade_template_report_one, NULL);
+    fprintf(stderr, "mvqcalc: process resident %ld kB\n", process_resident());
+}
+
 // file: filename of glade file
 // window: name of the "window" object in the glade file
 // container: name of container which we detach from the child
@@ -415,23 +775,13 @@ glade_widget_new(char *file, char *window, char *container, GtkWidget *parent)
 {
     glade_widget_t *gw;
     GtkWidget *old_window;
-    char buf[BUFSIZ];
 
     // create object
     gw = malloc(sizeof(glade_widget_t));
     memset(gw, 0, sizeof(glade_widget_t));
 
-    // load glade xml file
-    if (find_data_file(file, buf, BUFSIZ) != TRUE) {
-	fprintf(stderr, "ERROR: unable to locate glade file '%s'\n", file);
-	exit(1);
-    }
-
-    gw->xml = glade_xml_new(buf, NULL, NULL);
-    if (gw->xml == NULL) {
-	fprintf(stderr, "ERROR: unable to load glade file '%s'\n", file);
-	exit(1);
-    }
+    // build the window holding the widget
+    gw->xml = glade_template_new(file, window);
 
     // find the window widget so we can remove the
     // elements from it
@@ -454,54 +804,99 @@ glade_widget_new(char *file, char *window, char *container, GtkWidget *parent)
     gtk_container_add(GTK_CONTAINER(parent), gw->widget);
     gtk_widget_unref(gw->widget);
 
+    // nothing is left in the window it came in
+    gtk_widget_destroy(old_window);
+
     return gw;
 }
 
+/*
+ * Drop the GladeXML tree once the widgets that are needed later have
+ * been looked up. The widgets belong to their containers, so they stay.
+ */
+void
+glade_widget_release(glade_widget_t *gw)
+{
+    g_object_unref(gw->xml);
+    gw->xml = NULL;
+}
+
+/*
+ * Read n numbers from n entries. An empty entry counts as 0. Anything that
+ * is not a number is tinted, the notes say so and FALSE is returned: the
+ * callers then leave the result alone rather than calculate with a 0
+ * nobody typed. They read all of their operands first, with | and not ||,
+ * so every bad entry gets tinted at once. A widget that isn't built yet
+ * reads as the values in shown.
+ */
+gboolean
+entries_get(GtkWidget **entries, real *shown, real *v, int n)
+{
+    static const GdkColor invalid = { 0, 0xffff, 0xc0c0, 0xc0c0 };
+    const char *text, *end;
+    gboolean ok = TRUE;
+    int i;
+
+    if (entries[0] == NULL) {
+	memmove(v, shown, n * sizeof(real));
+	return TRUE;
+    }
+
+    for (i = 0; i < n; i++) {
+	text = gtk_entry_get_text(GTK_ENTRY(entries[i]));
+	v[i] = 0;
+
+	// end stops at the first thing that isn't white space or a number
+	numparse_array(text, &v[i], 1, &end);
+	if (*end == '\0') {
+	    gtk_widget_modify_base(entries[i], GTK_STATE_NORMAL, NULL);
+	} else {
+	    printf("'%s' is not a number\n", text);
+	    gtk_widget_modify_base(entries[i], GTK_STATE_NORMAL, &invalid);
+	    v[i] = 0;
+	    ok = FALSE;
+	}
+    }
+
+    return ok;
+}
+
 ///////////////////////////////////////////////////////////////////////
 ////////////////////////  MATRIX WIDGET  //////////////////////////////
 ///////////////////////////////////////////////////////////////////////
 
-void
+gboolean
 matrix_widget_get(gtk_matrix_t *matrix, mat4x4_t m)
 {
-    const char *buf;
-    int i;
-    GtkWidget *w;
-
-    for (i = 0; i < 16; i++) {
-	w = matrix->entries[i];
-	buf = gtk_entry_get_text(GTK_ENTRY(w));
-	m[i] = atof(buf);
-    }
+    return entries_get(matrix->entries, matrix->m, m, 16);
 }
 
 void
 matrix_widget_set(gtk_matrix_t *matrix, mat4x4_t m)
 {
-    char buf[BUFSIZ];
-    int i;
-    GtkWidget *w;
-
-    for (i = 0; i < 16; i++) {
-	w = matrix->entries[i];
-//	sprintf(buf, NumberFormat, m[i]);
-	format_number(m[i], buf, sizeof(buf));
-	gtk_entry_set_text(GTK_ENTRY(w), buf);
-    }
+    entries_set(matrix->entries, matrix->m, &matrix->synced, m, 16);
 }
 
 gtk_matrix_t *
 matrix_widget_new(GtkWidget *parent)
 {
     gtk_matrix_t *m;
-    int i;
-    char buf[BUFSIZ];
 
-    // create object
+    // create object, the entries come with matrix_widget_build()
     m = malloc(sizeof(gtk_matrix_t));
     memset(m, 0, sizeof(gtk_matrix_t));
+    m->parent = parent;
+
+    return m;
+}
+
+void
+matrix_widget_build(gtk_matrix_t *m)
+{
+    int i;
+    char buf[BUFSIZ];
 
-    m->gwidget = glade_widget_new("matrix_widget.glade", "window1", "matrix_frame", parent);
+    m->gwidget = glade_widget_new("matrix_widget.glade", "window1", "matrix_frame", m->parent);
 
     // locate all of the text entry widget
     for (i = 1; i <= 16; i++) {
@@ -513,7 +908,15 @@ matrix_widget_new(GtkWidget *parent)
 	}
     }
 
-    return m;
+    m->toolbar_box = glade_xml_get_widget(m->gwidget->xml, "matrix_toolbar_container");
+    g_assert(m->toolbar_box != NULL);
+
+    glade_widget_release(m->gwidget);
+
+    entries_watch(m->entries, &m->synced, 16);
+
+    // show what it was given before it existed
+    entries_set(m->entries, m->m, &m->synced, m->m, 16);
 }
 
 ///////////////////////////////////////////////////////////////////////
@@ -524,14 +927,22 @@ gtk_quat_t *
 quat_widget_new(GtkWidget *parent)
 {
     gtk_quat_t *q;
-    char buf[BUFSIZ];
-    int i;
 
-    // create object
+    // create object, the entries come with quat_widget_build()
     q = malloc(sizeof(gtk_quat_t));
     memset(q, 0, sizeof(gtk_quat_t));
+    q->parent = parent;
+
+    return q;
+}
+
+void
+quat_widget_build(gtk_quat_t *q)
+{
+    char buf[BUFSIZ];
+    int i;
 
-    q->gwidget = glade_widget_new("quaternion_widget.glade", "window1", "quat_frame", parent);
+    q->gwidget = glade_widget_new("quaternion_widget.glade", "window1", "quat_frame", q->parent);
 
     // locate all of the text entry widget
     for (i = 1; i <= 4; i++) {
@@ -543,36 +954,27 @@ quat_widget_new(GtkWidget *parent)
 	}
     }
 
-    return q;
+    q->toolbar_box = glade_xml_get_widget(q->gwidget->xml, "quat_toolbar_container");
+    g_assert(q->toolbar_box != NULL);
+
+    glade_widget_release(q->gwidget);
+
+    entries_watch(q->entries, &q->synced, 4);
+
+    // show what it was given before it existed
+    entries_set(q->entries, q->q, &q->synced, q->q, 4);
 }
 
-void
+gboolean
 quat_widget_get(gtk_quat_t *quat, quat_t q)
 {
-    const char *buf;
-    int i;
-    GtkWidget *w;
-
-    for (i = 0; i < 4; i++) {
-	w = quat->entries[i];
-	buf = gtk_entry_get_text(GTK_ENTRY(w));
-	q[i] = atof(buf);
-    }
+    return entries_get(quat->entries, quat->q, q, 4);
 }
 
 void
 quat_widget_set(gtk_quat_t *quat, quat_t q)
 {
-    char buf[BUFSIZ];
-    int i;
-    GtkWidget *w;
-
-    for (i = 0; i < 4; i++) {
-	w = quat->entries[i];
-//	sprintf(buf, NumberFormat, q[i]);
-	format_number(q[i], buf, sizeof(buf));
-	gtk_entry_set_text(GTK_ENTRY(w), buf);
-    }
+    entries_set(quat->entries, quat->q, &quat->synced, q, 4);
 }
 
 ///////////////////////////////////////////////////////////////////////
@@ -583,14 +985,22 @@ gtk_vector_t *
 vector_widget_new(GtkWidget *parent)
 {
     gtk_vector_t *v;
-    char buf[BUFSIZ];
-    int i;
 
-    // create object
+    // create object, the entries come with vector_widget_build()
     v = malloc(sizeof(gtk_vector_t));
     memset(v, 0, sizeof(gtk_vector_t));
+    v->parent = parent;
+
+    return v;
+}
+
+void
+vector_widget_build(gtk_vector_t *v)
+{
+    char buf[BUFSIZ];
+    int i;
 
-    v->gwidget = glade_widget_new("vector_widget.glade", "window1", "vector_frame", parent);
+    v->gwidget = glade_widget_new("vector_widget.glade", "window1", "vector_frame", v->parent);
 
     // locate all of the text entry widget
     for (i = 1; i <= 3; i++) {
@@ -602,36 +1012,27 @@ vector_widget_new(GtkWidget *parent)
 	}
     }
 
-    return v;
+    v->toolbar_box = glade_xml_get_widget(v->gwidget->xml, "vector_toolbar_container");
+    g_assert(v->toolbar_box != NULL);
+
+    glade_widget_release(v->gwidget);
+
+    entries_watch(v->entries, &v->synced, 3);
+
+    // show what it was given before it existed
+    entries_set(v->entries, v->v, &v->synced, v->v, 3);
 }
 
-void
+gboolean
 vector_widget_get(gtk_vector_t *vector, vec3_t v)
 {
-    const char *buf;
-    int i;
-    GtkWidget *w;
-
-    for (i = 0; i < 3; i++) {
-	w = vector->entries[i];
-	buf = gtk_entry_get_text(GTK_ENTRY(w));
-	v[i] = atof(buf);
-    }
+    return entries_get(vector->entries, vector->v, v, 3);
 }
 
 void
 vector_widget_set(gtk_vector_t *vector, vec3_t v)
 {
-    char buf[BUFSIZ];
-    int i;
-    GtkWidget *w;
-
-    for (i = 0; i < 3; i++) {
-	w = vector->entries[i];
-	//sprintf(buf, NumberFormat, v[i]);
-	format_number(v[i], buf, sizeof(buf));
-	gtk_entry_set_text(GTK_ENTRY(w), buf);
-    }
+    entries_set(vector->entries, vector->v, &vector->synced, v, 3);
 }
 
 ///////////////////////////////////////////////////////////////////////
@@ -642,14 +1043,22 @@ gtk_scalar_t *
 scalar_widget_new(GtkWidget *parent)
 {
     gtk_scalar_t *s;
-    char buf[BUFSIZ];
 
-    // create object
+    // create object, the entries come with scalar_widget_build()
     s = malloc(sizeof(gtk_scalar_t));
     memset(s, 0, sizeof(gtk_scalar_t));
+    s->parent = parent;
+
+    return s;
+}
+
+void
+scalar_widget_build(gtk_scalar_t *s)
+{
+    char buf[BUFSIZ];
 
     // load glade xml file
-    s->gwidget = glade_widget_new("scalar_widget.glade", "window1", "scalar_frame", parent);
+    s->gwidget = glade_widget_new("scalar_widget.glade", "window1", "scalar_frame", s->parent);
 
     // locate all of the text entry widget
     s->entry = glade_xml_get_widget(s->gwidget->xml, "entry_1");
@@ -658,30 +1067,24 @@ scalar_widget_new(GtkWidget *parent)
 	exit(1);
     }
 
-    return s;
+    glade_widget_release(s->gwidget);
+
+    entries_watch(&s->entry, &s->synced, 1);
+
+    // show what it was given before it existed
+    entries_set(&s->entry, &s->s, &s->synced, &s->s, 1);
 }
 
-void
+gboolean
 scalar_widget_get(gtk_scalar_t *scalar, real *s)
 {
-    const char *buf;
-    GtkWidget *w;
-
-    w = scalar->entry;
-    buf = gtk_entry_get_text(GTK_ENTRY(w));
-    *s = atof(buf);
+    return entries_get(&scalar->entry, &scalar->s, s, 1);
 }
 
 void
 scalar_widget_set(gtk_scalar_t *scalar, real s)
 {
-    char buf[BUFSIZ];
-    GtkWidget *w;
-
-    w = scalar->entry;
-//    sprintf(buf, NumberFormat, s);
-    format_number(s, buf, sizeof(buf));
-    gtk_entry_set_text(GTK_ENTRY(w), buf);
+    entries_set(&scalar->entry, &scalar->s, &scalar->synced, &s, 1);
 }
 
 ///////////////////////////////////////////////////////////////////////
@@ -703,6 +1106,18 @@ memory_store_new(
     return memory_store;
 }
 
+/*
+ * free what is in a slot. The vectors, quaternions and matrices all come
+ * from the heap (the *_new() functions), so g_free() will do for all.
+ */
+void
+memory_store_clear(memory_store_t *store, int slot)
+{
+    store->active[slot] = FALSE;
+    g_free(store->data[slot]);
+    store->data[slot] = NULL;
+}
+
 void
 memory_store_update_recall_buttons(memory_store_t *store)
 {
@@ -738,7 +1153,10 @@ vector_memory_toolbar_store(gtk_memory_toolbar_t *toolbar)
     v = vec3_new(0,0,0);
 
     printf(">>> vector store\n");
-    vector_widget_get(vector, *v);
+    if (!vector_widget_get(vector, *v)) {
+	g_free(v);
+	return NULL;
+    }
 
     return v;
 }
@@ -753,7 +1171,10 @@ quat_memory_toolbar_store(gtk_memory_toolbar_t *toolbar)
     q = quat_new(0,0,0,0);
 
     printf(">>> quat store\n");
-    quat_widget_get(quat, *q);
+    if (!quat_widget_get(quat, *q)) {
+	g_free(q);
+	return NULL;
+    }
 
     return q;
 }
@@ -768,7 +1189,10 @@ matrix_memory_toolbar_store(gtk_memory_toolbar_t *toolbar)
     m = mat4x4_new();
 
     printf(">>> matrix store\n");
-    matrix_widget_get(matrix, *m);
+    if (!matrix_widget_get(matrix, *m)) {
+	g_free(m);
+	return NULL;
+    }
 
     return m;
 }
@@ -778,8 +1202,14 @@ gtk_memory_toolbar_button_clicked_cb(GtkWidget *widget, void *data)
 {
     memory_event_t *ev = data;
     g_assert(ev != NULL);
+    void *stored;
 
-    ev->store->data[ev->slot-1]   = ev->store->store(ev->toolbar);
+    // NULL if an entry isn't a number, the slot keeps what it had
+    if ((stored = ev->store->store(ev->toolbar)) == NULL)
+	return;
+
+    memory_store_clear(ev->store, ev->slot-1);
+    ev->store->data[ev->slot-1]   = stored;
     ev->store->active[ev->slot-1] = TRUE;
 
     memory_store_update_recall_buttons(ev->store);
@@ -809,15 +1239,18 @@ gtk_memory_toolbar_new(memory_store_t *store, GtkWidget *container, void *cwidge
 	gst->buttons[i] = glade_xml_get_widget(gst->gwidget->xml, buf);
 	g_assert(gst->buttons[i] != NULL);
 
-	ev = malloc(sizeof(memory_event_t));
-	memset(ev, 0, sizeof(memory_event_t));
+	// freed along with the button
+	ev = g_new0(memory_event_t, 1);
 	ev->slot = i + 1;
 	ev->toolbar = gst;
 	ev->store = gst->store;
-	gtk_signal_connect(GTK_OBJECT(gst->buttons[i]), "clicked",
-		GTK_SIGNAL_FUNC(gtk_memory_toolbar_button_clicked_cb), ev);
+	g_signal_connect_data(G_OBJECT(gst->buttons[i]), "clicked",
+		G_CALLBACK(gtk_memory_toolbar_button_clicked_cb), ev,
+		(GClosureNotify) g_free, 0);
     }
 
+    glade_widget_release(gst->gwidget);
+
     memory_store_update_recall_buttons(gst->store);
 
     return gst;
@@ -896,15 +1329,18 @@ gtk_recall_toolbar_new(memory_store_t *store, GtkWidget *container, void *cwidge
 	grt->buttons[i] = glade_xml_get_widget(grt->gwidget->xml, buf);
 	g_assert(grt->buttons[i] != NULL);
 
-	ev = malloc(sizeof(memory_event_t));
-	memset(ev, 0, sizeof(memory_event_t));
+	// freed along with the button
+	ev = g_new0(memory_event_t, 1);
 	ev->slot = i + 1;
 	ev->toolbar = grt;
 	ev->store = grt->store;
-	gtk_signal_connect(GTK_OBJECT(grt->buttons[i]), "clicked",
-		GTK_SIGNAL_FUNC(gtk_recall_toolbar_button_clicked_cb), ev);
+	g_signal_connect_data(G_OBJECT(grt->buttons[i]), "clicked",
+		G_CALLBACK(gtk_recall_toolbar_button_clicked_cb), ev,
+		(GClosureNotify) g_free, 0);
     }
 
+    glade_widget_release(grt->gwidget);
+
     memory_store_update_recall_buttons(grt->store);
 
     return grt;
@@ -914,6 +1350,28 @@ gtk_recall_toolbar_new(memory_store_t *store, GtkWidget *container, void *cwidge
 ////////////////////////  RESET BUTTONS  //////////////////////////////
 ///////////////////////////////////////////////////////////////////////
 
+/*
+ * Hold back repainting the application window while several widgets are
+ * updated, so they are redrawn in one go when thawed. Calls nest.
+ */
+void
+window_freeze_updates(void)
+{
+    GdkWindow *w = gtk_widget_get_window(window);
+
+    if (w != NULL)
+	gdk_window_freeze_updates(w);
+}
+
+void
+window_thaw_updates(void)
+{
+    GdkWindow *w = gtk_widget_get_window(window);
+
+    if (w != NULL)
+	gdk_window_thaw_updates(w);
+}
+
 void
 reset(void)
 {
@@ -928,6 +1386,9 @@ reset(void)
     quat_id(q_id);
     s_id = 0.0;
 
+    // nine widgets change at once, repaint them together afterwards
+    window_freeze_updates();
+
     matrix_widget_set(matrix1, m_id);
     matrix_widget_set(matrix2, m_id);
     matrix_widget_set(matrix3, m_id);
@@ -942,42 +1403,33 @@ reset(void)
 
     scalar_widget_set(scalar1, s_id);
 
-    GtkTextIter start_iter, end_iter;
-    GtkTextBuffer *text_buffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(text_view));
-    gtk_text_buffer_get_start_iter(text_buffer, &start_iter);
-    gtk_text_buffer_get_end_iter(text_buffer, &end_iter);
-    gtk_text_buffer_delete(text_buffer, &start_iter, &end_iter);
+    notes_clear();
 
 
     for (i = 0; i < MEMORY_BUTTONS; i++) {
-	matrix_memory->active[i] = FALSE;
-	if (matrix_memory->data[i] != NULL) {
-	    free(matrix_memory->data[i]);
-	    matrix_memory->data[i] = NULL;
-	}
-	vector_memory->active[i] = FALSE;
-	if (vector_memory->data[i] != NULL) {
-	    free(vector_memory->data[i]);
-	    vector_memory->data[i] = NULL;
-	}
-    	quat_memory->active[i] = FALSE;
-	if (quat_memory->data[i] != NULL) {
-	    free(quat_memory->data[i]);
-	    quat_memory->data[i] = NULL;
-	}
+	memory_store_clear(matrix_memory, i);
+	memory_store_clear(vector_memory, i);
+	memory_store_clear(quat_memory, i);
     }
     memory_store_update_recall_buttons(matrix_memory);
     memory_store_update_recall_buttons(vector_memory);
     memory_store_update_recall_buttons(quat_memory);
 
-    gtk_combo_box_set_active(GTK_COMBO_BOX(matrix_toolbar1->convert_select), -1);
-    gtk_combo_box_set_active(GTK_COMBO_BOX(matrix_toolbar2->convert_select), -1);
-    gtk_combo_box_set_active(GTK_COMBO_BOX(quat_toolbar1->convert_select), -1);
-    gtk_combo_box_set_active(GTK_COMBO_BOX(quat_toolbar2->convert_select), -1);
+    // the toolbars of pages not built yet have nothing to reset
+    if (matrix_toolbar1 != NULL)
+	gtk_combo_box_set_active(GTK_COMBO_BOX(matrix_toolbar1->convert_select), -1);
+    if (matrix_toolbar2 != NULL)
+	gtk_combo_box_set_active(GTK_COMBO_BOX(matrix_toolbar2->convert_select), -1);
+    if (quat_toolbar1 != NULL)
+	gtk_combo_box_set_active(GTK_COMBO_BOX(quat_toolbar1->convert_select), -1);
+    if (quat_toolbar2 != NULL)
+	gtk_combo_box_set_active(GTK_COMBO_BOX(quat_toolbar2->convert_select), -1);
 
     gtk_notebook_set_current_page(GTK_NOTEBOOK(notebook_a), NOTEBOOK_PAGE_MATRIX);
     gtk_notebook_set_current_page(GTK_NOTEBOOK(notebook_b), NOTEBOOK_PAGE_MATRIX);
     gtk_notebook_set_current_page(GTK_NOTEBOOK(notebook_c), NOTEBOOK_PAGE_MATRIX);
+
+    window_thaw_updates();
 }
 
 void
@@ -995,10 +1447,10 @@ add_vector_vector_vector(void)
 {
     vec3_t a, b, c;
 
-    vector_widget_get(vector1, a);
-    vector_widget_get(vector2, b);
+    if (!vector_widget_get(vector1, a) | !vector_widget_get(vector2, b))
+	return;
 
-    vec3_add(a, b, c);
+    calc_add_vector_vector_vector(a, b, c);
 
     vector_widget_set(vector3, c);
 
@@ -1010,10 +1462,10 @@ add_quat_quat_quat(void)
 {
     quat_t a, b, c;
 
-    quat_widget_get(quat1, a);
-    quat_widget_get(quat2, b);
+    if (!quat_widget_get(quat1, a) | !quat_widget_get(quat2, b))
+	return;
 
-    quat_add(a, b, c);
+    calc_add_quat_quat_quat(a, b, c);
 
     quat_widget_set(quat3, c);
 
@@ -1045,10 +1497,10 @@ subtract_vector_vector_vector(void)
 {
     vec3_t a, b, c;
 
-    vector_widget_get(vector1, a);
-    vector_widget_get(vector2, b);
+    if (!vector_widget_get(vector1, a) | !vector_widget_get(vector2, b))
+	return;
 
-    vec3_sub(a, b, c);
+    calc_subtract_vector_vector_vector(a, b, c);
 
     vector_widget_set(vector3, c);
 
@@ -1060,10 +1512,10 @@ subtract_quat_quat_quat(void)
 {
     quat_t a, b, c;
 
-    quat_widget_get(quat1, a);
-    quat_widget_get(quat2, b);
+    if (!quat_widget_get(quat1, a) | !quat_widget_get(quat2, b))
+	return;
 
-    quat_sub_quick(a, b, c);
+    calc_subtract_quat_quat_quat(a, b, c);
 
     quat_widget_set(quat3, c);
 
@@ -1096,12 +1548,10 @@ dot_vector_vector_scalar(void)
     vec3_t a, b;
     real c;
 
-    vector_widget_get(vector1, a);
-    vector_widget_get(vector2, b);
-
-    printf(">>> obtaining dot product of vector A and vector B\n");
+    if (!vector_widget_get(vector1, a) | !vector_widget_get(vector2, b))
+	return;
 
-    c = vec3_dot(a, b);
+    calc_dot_vector_vector_scalar(a, b, &c);
 
     scalar_widget_set(scalar3, c);
 
@@ -1130,18 +1580,10 @@ cross_vector_vector_vector(void)
 {
     vec3_t a, b, c;
 
-    vector_widget_get(vector1, a);
-    vector_widget_get(vector2, b);
+    if (!vector_widget_get(vector1, a) | !vector_widget_get(vector2, b))
+	return;
 
-    printf(">>> Performing cross product operation\n");
-    printf("X = (AY*BZ) - (AZ*BY)\n");
-    printf("X = (%g*%g) - (%g*%g)\n", a[Y], b[Z], a[Z], b[Y]);
-    printf("Y = (AZ*BX) - (AX*BZ)\n");
-    printf("Y = (%g*%g) - (%g*%g)\n", a[Z], b[X], a[X], b[Z]);
-    printf("Z = (AX*BY) - (AY*BX)\n");
-    printf("Z = (%g*%g) - (%g*%g)\n", a[X], b[Y], a[Y], b[X]);
-
-    vec3_cross(a, b, c);
+    calc_cross_vector_vector_vector(a, b, c);
 
     vector_widget_set(vector3, c);
 
@@ -1171,18 +1613,13 @@ angle_vector_vector_scalar(void)
     vec3_t a, b;
     real c;
 
-    vector_widget_get(vector1, a);
-    vector_widget_get(vector2, b);
-
-    printf("WARNING: answer may not be correct, verification required\n");
-    printf(">>> calculating angle between vector A & vector B (units in radians)\n");
+    if (!vector_widget_get(vector1, a) | !vector_widget_get(vector2, b))
+	return;
 
-    vec3_angle(a, b, &c);
+    calc_angle_vector_vector_scalar(a, b, &c);
 
     scalar_widget_set(scalar3, c);
 
-    printf("C = %g degrees\n", c * RAD2DEG);
-
     gtk_notebook_set_current_page(GTK_NOTEBOOK(notebook_c), NOTEBOOK_PAGE_SCALAR);
 }
 
@@ -1207,55 +1644,11 @@ void
 multiply_matrix_matrix_matrix(void)
 {
     mat4x4_t a, b, c;
-    int i;
-
-    printf(">>> multiplying matrix a & matrix b\n");
-
-    matrix_widget_get(matrix1, a);
-    matrix_widget_get(matrix2, b);
-
-//    mat4x4_mult(a, b, c);
-
-#define M1(row,col)  a[(col<<2)+row]
-#define M2(row,col)  b[(col<<2)+row]
-#define M3(row,col)  c[(col<<2)+row]
 
-    for (i = 0; i < 4; i++) {
-        const real ai0=M1(i,0),  ai1=M1(i,1),  ai2=M1(i,2),  ai3=M1(i,3);
+    if (!matrix_widget_get(matrix1, a) | !matrix_widget_get(matrix2, b))
+	return;
 
-        M3(i,0) = ai0 * M2(0,0) + ai1 * M2(1,0) + ai2 * M2(2,0) + ai3 * M2(3,0);
-	printf("C%d0 = (A%d0 * B00) + (A%d1 * B10) + (A%d2 * B20) + (A%d3 * B30)\n",
-		i, i, i, i, i);
-	printf("C%d0 = (%g * %g) + (%g * %g) + (%g * %g) + (%g * %g)\n",
-		i,
-		ai0, M2(0,0),
-		ai1, M2(1,0),
-		ai2, M2(2,0),
-		ai3, M2(3,0));
-
-
-        M3(i,1) = ai0 * M2(0,1) + ai1 * M2(1,1) + ai2 * M2(2,1) + ai3 * M2(3,1);
-        printf("C%d1 = (A%d0 * B01) + (A%d1 * B11) + (A%d2 * B21) + (A%d3 * B31)\n",
-                i, i, i, i, i);
-	printf("C%d1 = (%g * %g) + (%g * %g) + (%g * %g) + (%g * %g)\n",
-		i, ai0, M2(0,1), ai1, M2(1,1), ai2, M2(2,1), ai3, M2(3,1));
-
-        M3(i,2) = ai0 * M2(0,2) + ai1 * M2(1,2) + ai2 * M2(2,2) + ai3 * M2(3,2);
-        printf("C%d2 = (A%d0 * B02) + (A%d1 * B12) + (A%d2 * B22) + (A%d3 * B32)\n",
-                i, i, i, i, i);
-	printf("C%d2 = (%g * %g) + (%g * %g) + (%g * %g) + (%g * %g)\n",
-		i, ai0, M2(0,2), ai1, M2(1,2), ai2, M2(2,2), ai3, M2(3,2));
-
-        M3(i,3) = ai0 * M2(0,3) + ai1 * M2(1,3) + ai2 * M2(2,3) + ai3 * M2(3,3);
-        printf("C%d3 = (A%d0 * B03) + (A%d1 * B13) + (A%d2 * B23) + (A%d3 * B33)\n",
-                i, i, i, i, i);
-	printf("C%d3 = (%g * %g) + (%g * %g) + (%g * %g) + (%g * %g)\n",
-		i, ai0, M2(0,3), ai1, M2(1,3), ai2, M2(2,3), ai3, M2(3,3));
-   }
-
-#undef M1
-#undef M2
-#undef M3
+    calc_multiply_matrix_matrix_matrix(a, b, c);
 
     matrix_widget_set(matrix3, c);
 
@@ -1269,13 +1662,10 @@ multiply_scalar_vector_vector(void)
     real a;
     vec3_t b, c;
 
-    printf(">>> Multiplying vector by scalar\n");
-
-    scalar_widget_get(scalar1, &a);
-    vector_widget_get(vector2, b);
+    if (!scalar_widget_get(scalar1, &a) | !vector_widget_get(vector2, b))
+	return;
 
-    vec3_cp(b, c);
-    vec3_scale(c, a);
+    calc_multiply_scalar_vector_vector(a, b, c);
 
     vector_widget_set(vector3, c);
 
@@ -1287,11 +1677,11 @@ multiply_vector_vector_vector(void)
 {
     vec3_t a, b, c;
 
-    printf(">>> Multiplying vector by vector\n");
+    if (!vector_widget_get(vector1, a) | !vector_widget_get(vector2, b))
+	return;
+
+    calc_multiply_vector_vector_vector(a, b, c);
 
-    vector_widget_get(vector1, a);
-    vector_widget_get(vector2, b);
-    vec3_mult(a, b, c);
     vector_widget_set(vector3, c);
 
     gtk_notebook_set_current_page(GTK_NOTEBOOK(notebook_c), NOTEBOOK_PAGE_VECTOR);
@@ -1302,31 +1692,10 @@ multiply_quat_quat_quat(void)
 {
     quat_t a, b, c;
 
+    if (!quat_widget_get(quat1, a) | !quat_widget_get(quat2, b))
+	return;
 
-    quat_widget_get(quat1, a);
-    quat_widget_get(quat2, b);
-
-    quat_cp(a, c);
-
-    printf(">>> Multiplying quaternion by quaternion\n");
-    // q1[X] = q2[W] * tmp[X] + q2[X] * tmp[W] + q2[Y] * tmp[Z] - q2[Z] * tmp[Y];
-    printf("X = (AX * BW) + (AW * BX) + (AZ * BY) - (AY * BZ)\n");
-    printf("X = (%g * %g) + (%g * %g) + (%g * %g) - (%g * %g)\n",
-	    a[X], b[W], a[W], b[X], a[Z], b[Y], a[Y], b[Z]);
-    // q1[Y] = q2[W] * tmp[Y] - q2[X] * tmp[Z] + q2[Y] * tmp[W] + q2[Z] * tmp[X];
-    printf("Y = (AY * BW) - (AZ * BX) + (AW * BY) + (AX * BZ)\n");
-    printf("Y = (%g * %g) - (%g * %g) + (%g * %g) + (%g * %g)\n",
-	    a[Y], b[W], a[Z], b[X], a[W], b[Y], a[X], b[Z]);
-    // q1[Z] = q2[W] * tmp[Z] + q2[X] * tmp[Y] - q2[Y] * tmp[X] + q2[Z] * tmp[W];
-    printf("Z = (AZ * BW) + (AY * BX) - (AX * BY) + (AW * BZ)\n");
-    printf("Z = (%g * %g) + (%g * %g) - (%g * %g) + (%g * %g)\n",
-	    a[Z], b[W], a[Y], b[X], a[X], b[Y], a[W], b[Z]);
-    // q1[W] = q2[W] * tmp[W] - q2[X] * tmp[X] - q2[Y] * tmp[Y] - q2[Z] * tmp[Z];
-    printf("W = (AW * BW) - (AX * BX) - (AY * BY) - (AZ * BZ)\n");
-    printf("W = (%g * %g) - (%g * %g) - (%g * %g) - (%g * %g)\n",
-	    a[W], b[W], a[X], b[X], a[Y], b[Y], a[Z], b[Z]);
-
-    quat_mult(c, b);
+    calc_multiply_quat_quat_quat(a, b, c);
 
     quat_widget_set(quat3, c);
 
@@ -1364,14 +1733,10 @@ divide_vector_vector_vector(void)
 {
     vec3_t a, b, c;
 
-    vector_widget_get(vector1, a);
-    vector_widget_get(vector2, b);
-
-    printf(">>> dividing vector A by vector B\n");
+    if (!vector_widget_get(vector1, a) | !vector_widget_get(vector2, b))
+	return;
 
-    c[X] = a[X] / b[X];
-    c[Y] = a[Y] / b[Y];
-    c[Z] = a[Z] / b[Z];
+    calc_divide_vector_vector_vector(a, b, c);
 
     vector_widget_set(vector3, c);
 
@@ -1387,13 +1752,10 @@ divide_scalar_vector_vector(void)
     real a;
     vec3_t b, c;
 
-    scalar_widget_get(scalar1, &a);
-    vector_widget_get(vector2, b);
-
-    printf(">>> dividing vector B by scalar A\n");
+    if (!scalar_widget_get(scalar1, &a) | !vector_widget_get(vector2, b))
+	return;
 
-    vec3_cp(b, c);
-    vec3_div(c, a);
+    calc_divide_scalar_vector_vector(a, b, c);
 
     vector_widget_set(vector3, c);
 
@@ -1426,13 +1788,10 @@ translate_vector_matrix_matrix(void)
     vec3_t a;
     mat4x4_t b, c;
 
-    printf(">>> translating matrix by vector\n");
+    if (!vector_widget_get(vector1, a) | !matrix_widget_get(matrix2, b))
+	return;
 
-    vector_widget_get(vector1, a);
-    matrix_widget_get(matrix2, b);
-
-    mat4x4_copy(b, c);
-    mat4x4_translate(c, a[X], a[Y], a[Z]);
+    calc_translate_vector_matrix_matrix(a, b, c);
 
     matrix_widget_set(matrix3, c);
 
@@ -1462,13 +1821,10 @@ scale_scalar_matrix_matrix(void)
     real a;
     mat4x4_t b, c;
 
-    printf(">>> scaling matrix by scalar\n");
-
-    scalar_widget_get(scalar1, &a);
-    matrix_widget_get(matrix2, b);
+    if (!scalar_widget_get(scalar1, &a) | !matrix_widget_get(matrix2, b))
+	return;
 
-    mat4x4_copy(b, c);
-    mat4x4_scale(c, a);
+    calc_scale_scalar_matrix_matrix(a, b, c);
 
     matrix_widget_set(matrix3, c);
 
@@ -1482,13 +1838,10 @@ scale_scalar_vector_vector(void)
     real a;
     vec3_t b, c;
 
-    printf(">>> scaling vector by scalar\n");
-
-    scalar_widget_get(scalar1, &a);
-    vector_widget_get(vector2, b);
+    if (!scalar_widget_get(scalar1, &a) | !vector_widget_get(vector2, b))
+	return;
 
-    vec3_cp(b, c);
-    vec3_scale(c, a);
+    calc_scale_scalar_vector_vector(a, b, c);
 
     vector_widget_set(vector3, c);
 
@@ -1519,45 +1872,12 @@ void
 rotate_vector_matrix_matrix(void)
 {
     vec3_t a;
-    mat4x4_t b, c, tmp;
-    real angle;
-
-    printf(">>> rotating matrix B by vector A\n");
-    printf(">>> NOTE: rotating in parts: value X on the X axis, then Y on the Y axis, then Z on the Z axis\n");
-    printf(">>> using degrees for input and placing radians in the matrix\n");
-
-    vector_widget_get(vector1, a);
-    matrix_widget_get(matrix2, b);
-
-    mat4x4_copy(b, c);
-
-#define M1(row,col) c[col * 4 + row]
-    if (a[X] != 0.0) {
-	mat4x4_id(tmp);
-	angle = a[X] * DEG2RAD;
-	M1(1,1) = cos(angle);
-	M1(1,2) = -1.0 * sin(angle);
-	M1(2,1) = sin(angle);
-	M1(2,2) = cos(angle);
-    	mat4x4_mult(c, tmp, c);
-    } else if (a[Y] != 0.0) {
-	mat4x4_id(tmp);
-	angle = a[Y] * DEG2RAD;
-	M1(0,0) = cos(angle);
-	M1(0,2) = sin(angle);
-	M1(2,0) = -1.0 * sin(angle);
-	M1(2,2) = cos(angle);
-    	mat4x4_mult(c, tmp, c);
-    } else if (a[Z] != 0.0) {
-	mat4x4_id(tmp);
-	angle = a[Z] * DEG2RAD;
-	M1(0,0) = cos(angle);
-	M1(0,1) = -1.0 * sin(angle);
-	M1(1,0) = sin(angle);
-	M1(1,1) = cos(angle);
-    	mat4x4_mult(c, tmp, c);
-    }
-#undef M1
+    mat4x4_t b, c;
+
+    if (!vector_widget_get(vector1, a) | !matrix_widget_get(matrix2, b))
+	return;
+
+    calc_rotate_vector_matrix_matrix(a, b, c);
 
     matrix_widget_set(matrix3, c);
 
@@ -1570,12 +1890,10 @@ rotate_vector_quat_quat(void)
     vec3_t a;
     quat_t b, c;
 
-    vector_widget_get(vector1, a);
-    quat_widget_get(quat2, b);
-
-    quat_cp(b, c);
+    if (!vector_widget_get(vector1, a) | !quat_widget_get(quat2, b))
+	return;
 
-    quat_set3(c, a[X], a[Y], a[Z]);
+    calc_rotate_vector_quat_quat(a, b, c);
 
     quat_widget_set(quat3, c);
 
@@ -1605,16 +1923,12 @@ button_rotate_clicked_cb(GtkWidget *widget, gpointer user_data)
 void
 swap_matrix_matrix(void)
 {
-    mat4x4_t a, b, c;
-
-    matrix_widget_get(matrix1, a);
-    matrix_widget_get(matrix2, b);
+    mat4x4_t a, b;
 
-    printf(">>> swapping values of matrix a & matrix b\n");
+    if (!matrix_widget_get(matrix1, a) | !matrix_widget_get(matrix2, b))
+	return;
 
-    mat4x4_copy(a, c);
-    mat4x4_copy(b, a);
-    mat4x4_copy(c, b);
+    calc_swap_matrix_matrix(a, b);
 
     matrix_widget_set(matrix1, a);
     matrix_widget_set(matrix2, b);
@@ -1623,16 +1937,12 @@ swap_matrix_matrix(void)
 void
 swap_vector_vector(void)
 {
-    vec3_t a, b, c;
-
-    vector_widget_get(vector1, a);
-    vector_widget_get(vector2, b);
+    vec3_t a, b;
 
-    printf(">>> swapping values of vector a & vector b\n");
+    if (!vector_widget_get(vector1, a) | !vector_widget_get(vector2, b))
+	return;
 
-    vec3_cp(a, c);
-    vec3_cp(b, a);
-    vec3_cp(c, b);
+    calc_swap_vector_vector(a, b);
 
     vector_widget_set(vector1, a);
     vector_widget_set(vector2, b);
@@ -1641,16 +1951,12 @@ swap_vector_vector(void)
 void
 swap_quat_quat(void)
 {
-    quat_t a, b, c;
+    quat_t a, b;
 
-    quat_widget_get(quat1, a);
-    quat_widget_get(quat2, b);
+    if (!quat_widget_get(quat1, a) | !quat_widget_get(quat2, b))
+	return;
 
-    printf(">>> swapping values of quaternion a & quaternion b\n");
-
-    quat_cp(a, c);
-    quat_cp(b, a);
-    quat_cp(c, b);
+    calc_swap_quat_quat(a, b);
 
     quat_widget_set(quat1, a);
     quat_widget_set(quat2, b);
@@ -1685,17 +1991,10 @@ transform_matrix_vector_vector(void)
     mat4x4_t a;
     vec3_t b, c;
 
-    printf(">>> transforming vector b by matrix a\n");
-
-    matrix_widget_get(matrix1, a);
-    vector_widget_get(vector2, b);
-
-    vec3_cp(b, c);
+    if (!matrix_widget_get(matrix1, a) | !vector_widget_get(vector2, b))
+	return;
 
-// does not apply translation
-//    transform_point(cc, a, bb);
-
-    vec3_transform(&c, 1, a);
+    calc_transform_matrix_vector_vector(a, b, c);
 
     vector_widget_set(vector3, c);
 
@@ -1813,38 +2112,20 @@ recalculate_active_operations(void)
 		    MathMode = MODE_SM;
 		    break;
 		case NOTEBOOK_PAGE_VECTOR:
-		    gtk_notebook_set_current_page(GTK_NOTEBOOK(notebook_c), NOTEBOOK_PAGE_VECTOR);
-		    // same operation
-		    gtk_widget_set_sensitive(button_multiply, TRUE);
-		    gtk_widget_set_sensitive(button_divide, TRUE);
-		    gtk_widget_set_sensitive(button_scale, TRUE);
-		    MathMode = MODE_SV;
-		    break;
-		default:
-		    break;
-	    }
-	    break;
-	default:
-	    break;
-    }
-}
-
-void
-notebook_a_switch_page_cb(GtkWidget *widget, gpointer user_data)
-{
-    recalculate_active_operations();
-}
-
-void
-notebook_b_switch_page_cb(GtkWidget *widget, gpointer user_data)
-{
-    recalculate_active_operations();
-}
-
-void
-notebook_c_switch_page_cb(GtkWidget *widget, gpointer user_data)
-{
-    //recalculate_active_operations();
+		    gtk_notebook_set_current_page(GTK_NOTEBOOK(notebook_c), NOTEBOOK_PAGE_VECTOR);
+		    // same operation
+		    gtk_widget_set_sensitive(button_multiply, TRUE);
+		    gtk_widget_set_sensitive(button_divide, TRUE);
+		    gtk_widget_set_sensitive(button_scale, TRUE);
+		    MathMode = MODE_SV;
+		    break;
+		default:
+		    break;
+	    }
+	    break;
+	default:
+	    break;
+    }
 }
 
 ///////////////////////////////////////////////////////////////////////
@@ -1876,7 +2157,8 @@ quat_toolbar_button_unitize_clicked_cb(GtkWidget *widget, gpointer user_data)
 
     printf(">>> unitizing quaternion cb: 0x%08x\n", qt);
 
-    quat_widget_get(qt->q, q);
+    if (!quat_widget_get(qt->q, q))
+	return;
     quat_norm(q);
     quat_widget_set(qt->q, q);
 }
@@ -1901,7 +2183,8 @@ convert_quat_matrix(gtk_quat_t *quat, gtk_matrix_t *matrix)
     quat_t q;
     mat4x4_t m;
 
-    quat_widget_get(quat, q);
+    if (!quat_widget_get(quat, q))
+	return;
 
     quat_to_mat(q, m);
 
@@ -1914,7 +2197,8 @@ convert_quat_vector(gtk_quat_t *quat, gtk_vector_t *vector, int axis)
     quat_t q;
     vec3_t v;
 
-    quat_widget_get(quat, q);
+    if (!quat_widget_get(quat, q))
+	return;
 
     if (axis == X) {
 	quat_to_vecs(q, NULL, NULL, v);
@@ -1991,9 +2275,8 @@ quat_toolbar_widget_new(gtk_quat_t *quat)
 
     qt->q = quat;
 
-    // get the container widget from the quat widget
-    box = glade_xml_get_widget(quat->gwidget->xml, "quat_toolbar_container");
-    g_assert(box != NULL);
+    // the container widget of the quat widget, found when it was built
+    box = quat->toolbar_box;
 
     // load glade xml file
     qt->gwidget = glade_widget_new("quaternion_toolbar.glade", "window1", "quat_toolbar_box", box);
@@ -2024,6 +2307,12 @@ quat_toolbar_widget_new(gtk_quat_t *quat)
     gtk_signal_connect(GTK_OBJECT(qt->convert_button), "clicked",
 	    GTK_SIGNAL_FUNC(quat_toolbar_convert_button_clicked_cb), qt);
 
+    // where the memory and recall toolbars go
+    qt->memory_box = glade_xml_get_widget(qt->gwidget->xml, "quat_toolbar_recall_hbox");
+    g_assert(qt->memory_box != NULL);
+
+    glade_widget_release(qt->gwidget);
+
     return qt;
 }
 
@@ -2041,7 +2330,8 @@ quat_result_toolbar_button_copy_a_clicked_cb(GtkWidget *widget, gpointer user_da
 
     printf(">>> copying result quaternion c to quaternion a: 0x%08x\n", qrt);
 
-    quat_widget_get(qrt->q, q);
+    if (!quat_widget_get(qrt->q, q))
+	return;
     quat_widget_set(quat1, q);
 
     gtk_notebook_set_current_page(GTK_NOTEBOOK(notebook_a), NOTEBOOK_PAGE_QUAT);
@@ -2057,7 +2347,8 @@ quat_result_toolbar_button_copy_b_clicked_cb(GtkWidget *widget, gpointer user_da
 
     printf(">>> copying result quaternion c to quaternion b: 0x%08x\n", qrt);
 
-    quat_widget_get(qrt->q, q);
+    if (!quat_widget_get(qrt->q, q))
+	return;
     quat_widget_set(quat2, q);
 
     gtk_notebook_set_current_page(GTK_NOTEBOOK(notebook_b), NOTEBOOK_PAGE_QUAT);
@@ -2073,7 +2364,8 @@ quat_result_toolbar_button_unitize_clicked_cb(GtkWidget *widget, gpointer user_d
 
     printf(">>> unitizing quaternion cb: 0x%08x\n", qrt);
 
-    quat_widget_get(qrt->q, q);
+    if (!quat_widget_get(qrt->q, q))
+	return;
     quat_norm(q);
     quat_widget_set(qrt->q, q);
 }
@@ -2090,9 +2382,8 @@ quat_result_toolbar_widget_new(gtk_quat_t *quat)
 
     qrt->q = quat;
 
-    // get the container widget from the quat widget
-    box = glade_xml_get_widget(quat->gwidget->xml, "quat_toolbar_container");
-    g_assert(box != NULL);
+    // the container widget of the quat widget, found when it was built
+    box = quat->toolbar_box;
 
     // load glade xml file
     qrt->gwidget = glade_widget_new("quaternion_result_toolbar.glade", "window1", "quat_result_toolbar_box", box);
@@ -2115,6 +2406,12 @@ quat_result_toolbar_widget_new(gtk_quat_t *quat)
     gtk_signal_connect(GTK_OBJECT(qrt->button_unitize), "clicked",
 	    GTK_SIGNAL_FUNC(quat_result_toolbar_button_unitize_clicked_cb), qrt);
 
+    // where the memory and recall toolbars go
+    qrt->memory_box = glade_xml_get_widget(qrt->gwidget->xml, "quat_result_toolbar_memory_hbox");
+    g_assert(qrt->memory_box != NULL);
+
+    glade_widget_release(qrt->gwidget);
+
     return qrt;
 }
 
@@ -2147,7 +2444,8 @@ vector_toolbar_button_unitize_clicked_cb(GtkWidget *widget, gpointer user_data)
 
     printf(">>> unitizing vector: 0x%08x\n", vt);
 
-    vector_widget_get(vt->v, v);
+    if (!vector_widget_get(vt->v, v))
+	return;
     vec3_norm(v);
     vector_widget_set(vt->v, v);
 }
@@ -2163,7 +2461,8 @@ vector_toolbar_button_length_clicked_cb(GtkWidget *widget, gpointer user_data)
     vec3_t a;
     real c;
 
-    vector_widget_get(vt->v, a);
+    if (!vector_widget_get(vt->v, a))
+	return;
 
     // #define vec3_len(v) sqrt((v)[X]*(v)[X] + (v)[Y]*(v)[Y] + (v)[Z]*(v)[Z])
     c = vec3_len(a);
@@ -2190,9 +2489,8 @@ vector_toolbar_widget_new(gtk_vector_t *vector)
 
     vt->v = vector;
 
-    // get the container widget from the vector widget
-    box = glade_xml_get_widget(vector->gwidget->xml, "vector_toolbar_container");
-    g_assert(box != NULL);
+    // the container widget of the vector widget, found when it was built
+    box = vector->toolbar_box;
 
     // load glade xml file
     vt->gwidget = glade_widget_new("vector_toolbar.glade", "window1", "vector_toolbar_box", box);
@@ -2215,6 +2513,12 @@ vector_toolbar_widget_new(gtk_vector_t *vector)
     gtk_signal_connect(GTK_OBJECT(vt->button_unitize), "clicked",
 	    GTK_SIGNAL_FUNC(vector_toolbar_button_unitize_clicked_cb), vt);
 
+    // where the memory and recall toolbars go
+    vt->memory_box = glade_xml_get_widget(vt->gwidget->xml, "vector_toolbar_recall_hbox");
+    g_assert(vt->memory_box != NULL);
+
+    glade_widget_release(vt->gwidget);
+
     return vt;
 }
 
@@ -2232,7 +2536,8 @@ vector_result_toolbar_button_copy_a_clicked_cb(GtkWidget *widget, gpointer user_
 
     printf(">>> copying result vector c to vector a: 0x%08x\n", vrt);
 
-    vector_widget_get(vrt->v, v);
+    if (!vector_widget_get(vrt->v, v))
+	return;
     vector_widget_set(vector1, v);
 
     gtk_notebook_set_current_page(GTK_NOTEBOOK(notebook_a), NOTEBOOK_PAGE_VECTOR);
@@ -2248,7 +2553,8 @@ vector_result_toolbar_button_copy_b_clicked_cb(GtkWidget *widget, gpointer user_
 
     printf(">>> copying result vector c to vector b: 0x%08x\n", vrt);
 
-    vector_widget_get(vrt->v, v);
+    if (!vector_widget_get(vrt->v, v))
+	return;
     vector_widget_set(vector2, v);
 
     gtk_notebook_set_current_page(GTK_NOTEBOOK(notebook_b), NOTEBOOK_PAGE_VECTOR);
@@ -2265,7 +2571,8 @@ vector_result_toolbar_button_unitize_clicked_cb(GtkWidget *widget, gpointer user
 
     printf(">>> unitizing result vector: 0x%08x\n", vrt);
 
-    vector_widget_get(vrt->v, v);
+    if (!vector_widget_get(vrt->v, v))
+	return;
     vec3_norm(v);
     vector_widget_set(vrt->v, v);
 }
@@ -2282,9 +2589,8 @@ vector_result_toolbar_widget_new(gtk_vector_t *vector)
 
     vrt->v = vector;
 
-    // get the container widget from the vector widget
-    box = glade_xml_get_widget(vector->gwidget->xml, "vector_toolbar_container");
-    g_assert(box != NULL);
+    // the container widget of the vector widget, found when it was built
+    box = vector->toolbar_box;
 
     // load glade xml file
     vrt->gwidget = glade_widget_new("vector_result_toolbar.glade", "window1", "vector_result_toolbar_box", box);
@@ -2307,6 +2613,12 @@ vector_result_toolbar_widget_new(gtk_vector_t *vector)
     gtk_signal_connect(GTK_OBJECT(vrt->button_unitize), "clicked",
 	    GTK_SIGNAL_FUNC(vector_result_toolbar_button_unitize_clicked_cb), vrt);
 
+    // where the memory and recall toolbars go
+    vrt->memory_box = glade_xml_get_widget(vrt->gwidget->xml, "vector_result_toolbar_memory_hbox");
+    g_assert(vrt->memory_box != NULL);
+
+    glade_widget_release(vrt->gwidget);
+
     return vrt;
 }
 
@@ -2342,17 +2654,37 @@ matrix_toolbar_button_zero_clicked_cb(GtkWidget *widget, gpointer user_data)
     matrix_widget_set(mt->m, m);
 }
 
+void
+matrix_toolbar_button_inv_clicked_cb(GtkWidget *widget, gpointer user_data)
+{
+    gtk_matrix_toolbar_t *mt = user_data;
+    g_assert(mt != NULL);
+
+    mat4x4_t m;
+
+    printf(">>> inverting matrix: 0x%08x\n", mt);
+
+    if (!matrix_widget_get(mt->m, m))
+	return;
+    if (!mat4x4_inv(m, m)) {
+	printf(">>> matrix is singular and has no inverse\n");
+	return;
+    }
+    matrix_widget_set(mt->m, m);
+}
+
 void
 convert_matrix_quat(gtk_matrix_t *matrix, gtk_quat_t *quat)
 {
-//    mat4x4_t m;
-//    quat_t q;
+    mat4x4_t m;
+    quat_t q;
 
-//    matrix_widget_get(matrix, m);
+    if (!matrix_widget_get(matrix, m))
+	return;
 
-    printf(">>> matrix to quaternion conversion is not yet implemented\n");
+    mat4x4_to_quat(m, q);
 
-//    quat_widget_set(quat, q);
+    quat_widget_set(quat, q);
 }
 
 void
@@ -2361,7 +2693,8 @@ convert_matrix_vector(gtk_matrix_t *matrix, gtk_vector_t *vector)
     mat4x4_t m;
     vec3_t v;
 
-    matrix_widget_get(matrix, m);
+    if (!matrix_widget_get(matrix, m))
+	return;
 
     v[X] = m[12];
     v[Y] = m[13];
@@ -2414,9 +2747,8 @@ matrix_toolbar_widget_new(gtk_matrix_t *matrix)
 
     mt->m = matrix;
 
-    // get the container widget from the matrix widget
-    box = glade_xml_get_widget(matrix->gwidget->xml, "matrix_toolbar_container");
-    g_assert(box != NULL);
+    // the container widget of the matrix widget, found when it was built
+    box = matrix->toolbar_box;
 
     // load glade xml file
     mt->gwidget = glade_widget_new("matrix_toolbar.glade", "window1", "matrix_toolbar_box", box);
@@ -2428,6 +2760,9 @@ matrix_toolbar_widget_new(gtk_matrix_t *matrix)
     mt->button_zero = glade_xml_get_widget(mt->gwidget->xml, "matrix_toolbar_button_zero");
     g_assert(mt->button_zero != NULL);
 
+    mt->button_inv = glade_xml_get_widget(mt->gwidget->xml, "matrix_toolbar_button_inv");
+    g_assert(mt->button_inv != NULL);
+
     mt->convert_select = glade_xml_get_widget(mt->gwidget->xml, "matrix_toolbar_convert_select");
     g_assert(mt->convert_select != NULL);
 
@@ -2439,9 +2774,17 @@ matrix_toolbar_widget_new(gtk_matrix_t *matrix)
 	    GTK_SIGNAL_FUNC(matrix_toolbar_button_id_clicked_cb), mt);
     gtk_signal_connect(GTK_OBJECT(mt->button_zero), "clicked",
 	    GTK_SIGNAL_FUNC(matrix_toolbar_button_zero_clicked_cb), mt);
+    gtk_signal_connect(GTK_OBJECT(mt->button_inv), "clicked",
+	    GTK_SIGNAL_FUNC(matrix_toolbar_button_inv_clicked_cb), mt);
     gtk_signal_connect(GTK_OBJECT(mt->convert_button), "clicked",
 	    GTK_SIGNAL_FUNC(matrix_toolbar_convert_button_clicked_cb), mt);
 
+    // where the memory and recall toolbars go
+    mt->memory_box = glade_xml_get_widget(mt->gwidget->xml, "matrix_toolbar_recall_box");
+    g_assert(mt->memory_box != NULL);
+
+    glade_widget_release(mt->gwidget);
+
     return mt;
 }
 
@@ -2459,7 +2802,8 @@ matrix_result_toolbar_button_copy_a_clicked_cb(GtkWidget *widget, gpointer user_
 
     printf(">>> copying result matrix c to matrix a: 0x%08x\n", mrt);
 
-    matrix_widget_get(mrt->m, m);
+    if (!matrix_widget_get(mrt->m, m))
+	return;
     matrix_widget_set(matrix1, m);
 
     gtk_notebook_set_current_page(GTK_NOTEBOOK(notebook_a), NOTEBOOK_PAGE_MATRIX);
@@ -2475,7 +2819,8 @@ matrix_result_toolbar_button_copy_b_clicked_cb(GtkWidget *widget, gpointer user_
 
     printf(">>> copying result matrix c to matrix b: 0x%08x\n", mrt);
 
-    matrix_widget_get(mrt->m, m);
+    if (!matrix_widget_get(mrt->m, m))
+	return;
     matrix_widget_set(matrix2, m);
 
     gtk_notebook_set_current_page(GTK_NOTEBOOK(notebook_b), NOTEBOOK_PAGE_MATRIX);
@@ -2493,9 +2838,8 @@ matrix_result_toolbar_widget_new(gtk_matrix_t *matrix)
 
     mrt->m = matrix;
 
-    // get the container widget from the matrix widget
-    box = glade_xml_get_widget(matrix->gwidget->xml, "matrix_toolbar_container");
-    g_assert(box != NULL);
+    // the container widget of the matrix widget, found when it was built
+    box = matrix->toolbar_box;
 
     // load glade xml file
     mrt->gwidget = glade_widget_new("matrix_result_toolbar.glade", "window1", "matrix_result_toolbar_box", box);
@@ -2513,6 +2857,12 @@ matrix_result_toolbar_widget_new(gtk_matrix_t *matrix)
     gtk_signal_connect(GTK_OBJECT(mrt->button_copy_b), "clicked",
 	    GTK_SIGNAL_FUNC(matrix_result_toolbar_button_copy_b_clicked_cb), mrt);
 
+    // where the memory and recall toolbars go
+    mrt->memory_box = glade_xml_get_widget(mrt->gwidget->xml, "matrix_result_toolbar_memory_hbox");
+    g_assert(mrt->memory_box != NULL);
+
+    glade_widget_release(mrt->gwidget);
+
     return mrt;
 }
 
@@ -2525,16 +2875,10 @@ screenreswarning_dialog_run(void)
 {
     GtkWidget *screenreswarning_dialog;
     GladeXML *xml;
-    char buf[BUFSIZ];
     int ret;
 
     /* load the interface */
-    if (find_data_file("main_window.glade", buf, BUFSIZ) != TRUE) {
-	fprintf(stderr, "ERROR: unable to locate glade file: '%s'\n", "main_window.glade");
-	exit(1);
-    }
-    xml = glade_xml_new(buf, NULL, NULL);
-    g_assert(xml != NULL);
+    xml = glade_template_new("main_window.glade", "screenreswarningdialog");
 
     // locate screenreswarning dialog widget
     screenreswarning_dialog = glade_xml_get_widget(xml, "screenreswarningdialog");
@@ -2547,6 +2891,9 @@ screenreswarning_dialog_run(void)
     ret = gtk_dialog_run(GTK_DIALOG(screenreswarning_dialog));
     fprintf(stderr, "dialog returned: %d\n", ret);
 
+    gtk_widget_destroy(screenreswarning_dialog);
+    g_object_unref(xml);
+
     if (ret != 1) {
 	exit(0);
     }
@@ -2568,15 +2915,9 @@ about_dialog_activate(GtkWidget *widget)
 {
     GtkWidget *about_dialog;
     GladeXML *xml;
-    char buf[BUFSIZ];
 
     /* load the interface */
-    if (find_data_file("main_window.glade", buf, BUFSIZ) != TRUE) {
-	fprintf(stderr, "ERROR: unable to locate glade file: '%s'\n", "main_window.glade");
-	exit(1);
-    }
-    xml = glade_xml_new(buf, NULL, NULL);
-    g_assert(xml != NULL);
+    xml = glade_template_new("main_window.glade", "aboutdialog");
 
     // locate about dialog widget
     about_dialog = glade_xml_get_widget(xml, "aboutdialog");
@@ -2587,6 +2928,154 @@ about_dialog_activate(GtkWidget *widget)
     gtk_widget_set_visible(about_dialog, TRUE);
 
     glade_xml_signal_autoconnect(xml);
+    g_object_unref(xml);
+}
+
+///////////////////////////////////////////////////////////////////////
+//////////////////////////  BATCH JOBS  ///////////////////////////////
+///////////////////////////////////////////////////////////////////////
+
+/*
+ * File > Run Batch File evaluates a file in the mvqcalc --batch format
+ * on a worker thread and writes the results next to it, FILE.out, while
+ * a dialog shows the progress and can cancel it. Several can run at once.
+ */
+typedef struct {
+    job_t *job;
+    char *in;
+    char *out;
+    batch_stats_t stats;
+    gboolean ok;
+    GtkWidget *dialog;
+    GtkWidget *label;
+    GtkWidget *progressbar;
+} batch_job_t;
+
+/* on the worker */
+gboolean
+batch_job_poll(double fraction, void *data)
+{
+    job_t *job = data;
+
+    job_set_progress(job, fraction);
+    return !job_cancelled(job);
+}
+
+/* on the worker */
+void
+batch_job_run(job_t *job, gpointer data)
+{
+    batch_job_t *bj = data;
+
+    bj->ok = batch_run_file(bj->in, bj->out, batch_job_poll, job, &bj->stats);
+}
+
+void
+batch_job_progress(job_t *job, double fraction, gpointer data)
+{
+    batch_job_t *bj = data;
+    char buf[32];
+
+    snprintf(buf, sizeof(buf), "%.0f%%", fraction * 100);
+    gtk_progress_bar_set_fraction(GTK_PROGRESS_BAR(bj->progressbar), fraction);
+    gtk_progress_bar_set_text(GTK_PROGRESS_BAR(bj->progressbar), buf);
+}
+
+void
+batch_job_done(job_t *job, gboolean cancelled, gpointer data)
+{
+    batch_job_t *bj = data;
+
+    if (bj->stats.cancelled) {
+	// only set once this run has opened the output, so this is our
+	// partial result and not a whole one left by an earlier run
+	unlink(bj->out);
+	_printf(">>> batch %s cancelled after %ld lines\n", bj->in, bj->stats.lines);
+    } else if (cancelled && !bj->ok && bj->stats.lines == 0)
+	// cancelled before it started, the output was never touched
+	_printf(">>> batch %s cancelled\n", bj->in);
+    else if (bj->stats.lines == 0 && !bj->ok)
+	_printf(">>> batch %s could not be run\n", bj->in);
+    else
+	_printf(">>> batch %s: %ld lines, %ld errors, results in %s\n",
+		bj->in, bj->stats.lines, bj->stats.errors, bj->out);
+
+    gtk_widget_destroy(bj->dialog);
+    g_free(bj->in);
+    g_free(bj->out);
+    g_free(bj);
+}
+
+void
+batch_job_response_cb(GtkDialog *dialog, gint response, gpointer user_data)
+{
+    batch_job_t *bj = user_data;
+
+    // the dialog goes away once the job has noticed
+    job_cancel(bj->job);
+    gtk_label_set_text(GTK_LABEL(bj->label), "Cancelling...");
+    gtk_dialog_set_response_sensitive(dialog, GTK_RESPONSE_CANCEL, FALSE);
+}
+
+/* closing the dialog cancels too, it is destroyed by batch_job_done() */
+gboolean
+batch_job_delete_event_cb(GtkWidget *widget, GdkEvent *event, gpointer user_data)
+{
+    batch_job_response_cb(GTK_DIALOG(widget), GTK_RESPONSE_DELETE_EVENT, user_data);
+    return TRUE;
+}
+
+void
+batch_job_new(char *file)
+{
+    batch_job_t *bj;
+    GladeXML *xml;
+
+    bj = g_new0(batch_job_t, 1);
+    bj->in = g_strdup(file);
+    bj->out = g_strconcat(file, ".out", NULL);
+
+    xml = glade_template_new("main_window.glade", "batchdialog");
+
+    bj->dialog = glade_xml_get_widget(xml, "batchdialog");
+    g_assert(bj->dialog != NULL);
+
+    bj->label = glade_xml_get_widget(xml, "batch_label");
+    g_assert(bj->label != NULL);
+
+    bj->progressbar = glade_xml_get_widget(xml, "batch_progressbar");
+    g_assert(bj->progressbar != NULL);
+
+    g_object_unref(xml);
+
+    gtk_label_set_text(GTK_LABEL(bj->label), bj->in);
+    gtk_window_set_transient_for(GTK_WINDOW(bj->dialog), GTK_WINDOW(window));
+    g_signal_connect(bj->dialog, "response", G_CALLBACK(batch_job_response_cb), bj);
+    g_signal_connect(bj->dialog, "delete-event", G_CALLBACK(batch_job_delete_event_cb), bj);
+    gtk_widget_set_visible(bj->dialog, TRUE);
+
+    bj->job = job_submit(batch_job_run, batch_job_progress, batch_job_done, bj);
+}
+
+void
+menu_batch_cb(GtkWidget *w, gpointer data)
+{
+    GtkWidget *chooser;
+    char *file;
+
+    chooser = gtk_file_chooser_dialog_new("Run Batch File", GTK_WINDOW(window),
+	    GTK_FILE_CHOOSER_ACTION_OPEN,
+	    GTK_STOCK_CANCEL, GTK_RESPONSE_CANCEL,
+	    GTK_STOCK_OPEN, GTK_RESPONSE_ACCEPT,
+	    NULL);
+
+    if (gtk_dialog_run(GTK_DIALOG(chooser)) == GTK_RESPONSE_ACCEPT) {
+	file = gtk_file_chooser_get_filename(GTK_FILE_CHOOSER(chooser));
+	batch_job_new(file);
+	g_free(file);
+    }
+
+    gtk_widget_destroy(chooser);
 }
 
 ///////////////////////////////////////////////////////////////////////
@@ -2596,27 +3085,264 @@ about_dialog_activate(GtkWidget *widget)
 void
 window_delete_event_cb(GtkWidget *widget, gpointer user_data)
 {
+    // batch jobs remove their partial output when cancelled
+    jobs_cancel_all();
     exit(0);
 }
 
+///////////////////////////////////////////////////////////////////////
+/////////////////////////  NOTEBOOK PAGES  ////////////////////////////
+///////////////////////////////////////////////////////////////////////
+
+/*
+ * Only the matrix pages, the ones shown first, are built before the
+ * window maps. The rest are built when they are switched to, or one per
+ * idle callback once the window is up, whichever comes first. Until then
+ * their widgets have no entries and just keep the values they are given
+ * (see entries_set()), so the rest of the program doesn't need to know.
+ */
+typedef struct {
+    GtkWidget **notebook;
+    int page;
+    void (*build)(GtkWidget *notebook);
+    gboolean built;
+} notebook_page_t;
+
+GTimer *startup;
+gboolean startup_time = FALSE;
+
+void
+matrix_page_build(GtkWidget *notebook)
+{
+    GtkWidget *container;
+
+    if (notebook == notebook_c) {
+	matrix_widget_build(matrix3);
+	matrix_result_toolbar = matrix_result_toolbar_widget_new(matrix3);
+
+	container = matrix_result_toolbar->memory_box;
+	gtk_memory_toolbar_new(matrix_memory, container, matrix3);
+    } else if (notebook == notebook_a) {
+	matrix_widget_build(matrix1);
+	matrix_toolbar1 = matrix_toolbar_widget_new(matrix1);
+
+	container = matrix_toolbar1->memory_box;
+	gtk_memory_toolbar_new(matrix_memory, container, matrix1);
+	gtk_recall_toolbar_new(matrix_memory, container, matrix1);
+    } else {
+	matrix_widget_build(matrix2);
+	matrix_toolbar2 = matrix_toolbar_widget_new(matrix2);
+
+	container = matrix_toolbar2->memory_box;
+	gtk_memory_toolbar_new(matrix_memory, container, matrix2);
+	gtk_recall_toolbar_new(matrix_memory, container, matrix2);
+    }
+}
+
+void
+vector_page_build(GtkWidget *notebook)
+{
+    GtkWidget *container;
+
+    if (notebook == notebook_c) {
+	vector_widget_build(vector3);
+	vector_result_toolbar = vector_result_toolbar_widget_new(vector3);
+
+	container = vector_result_toolbar->memory_box;
+	gtk_memory_toolbar_new(vector_memory, container, vector3);
+    } else if (notebook == notebook_a) {
+	vector_widget_build(vector1);
+	vector_toolbar1 = vector_toolbar_widget_new(vector1);
+
+	container = vector_toolbar1->memory_box;
+	gtk_recall_toolbar_new(vector_memory, container, vector1);
+    } else {
+	vector_widget_build(vector2);
+	vector_toolbar2 = vector_toolbar_widget_new(vector2);
+
+	container = vector_toolbar2->memory_box;
+	gtk_recall_toolbar_new(vector_memory, container, vector2);
+    }
+}
+
+void
+quat_page_build(GtkWidget *notebook)
+{
+    GtkWidget *container;
+
+    if (notebook == notebook_c) {
+	quat_widget_build(quat3);
+	quat_result_toolbar = quat_result_toolbar_widget_new(quat3);
+
+	container = quat_result_toolbar->memory_box;
+	gtk_memory_toolbar_new(quat_memory, container, quat3);
+    } else if (notebook == notebook_a) {
+	quat_widget_build(quat1);
+	quat_toolbar1 = quat_toolbar_widget_new(quat1);
+
+	container = quat_toolbar1->memory_box;
+	gtk_recall_toolbar_new(quat_memory, container, quat1);
+    } else {
+	quat_widget_build(quat2);
+	quat_toolbar2 = quat_toolbar_widget_new(quat2);
+
+	container = quat_toolbar2->memory_box;
+	gtk_recall_toolbar_new(quat_memory, container, quat2);
+    }
+}
+
+void
+scalar_page_build(GtkWidget *notebook)
+{
+    scalar_widget_build(notebook == notebook_c ? scalar3 : scalar1);
+}
+
+notebook_page_t notebook_pages[] = {
+    { &notebook_a, NOTEBOOK_PAGE_MATRIX, matrix_page_build },
+    { &notebook_b, NOTEBOOK_PAGE_MATRIX, matrix_page_build },
+    { &notebook_c, NOTEBOOK_PAGE_MATRIX, matrix_page_build },
+    { &notebook_a, NOTEBOOK_PAGE_VECTOR, vector_page_build },
+    { &notebook_b, NOTEBOOK_PAGE_VECTOR, vector_page_build },
+    { &notebook_c, NOTEBOOK_PAGE_VECTOR, vector_page_build },
+    { &notebook_a, NOTEBOOK_PAGE_QUAT,   quat_page_build },
+    { &notebook_b, NOTEBOOK_PAGE_QUAT,   quat_page_build },
+    { &notebook_c, NOTEBOOK_PAGE_QUAT,   quat_page_build },
+    { &notebook_a, NOTEBOOK_PAGE_SCALAR, scalar_page_build },
+    { &notebook_c, NOTEBOOK_PAGE_SCALAR, scalar_page_build },
+};
+
+void
+notebook_page_build(GtkWidget *notebook, int page)
+{
+    int i;
+
+    for (i = 0; i < G_N_ELEMENTS(notebook_pages); i++) {
+	notebook_page_t *p = &notebook_pages[i];
+
+	if (*p->notebook == notebook && p->page == page && !p->built) {
+	    p->built = TRUE;
+	    p->build(notebook);
+	}
+    }
+}
+
+/* build one page that is still missing, until there are none */
+gboolean
+notebook_pages_idle(gpointer data)
+{
+    int i;
+
+    for (i = 0; i < G_N_ELEMENTS(notebook_pages); i++) {
+	if (!notebook_pages[i].built) {
+	    notebook_page_build(*notebook_pages[i].notebook, notebook_pages[i].page);
+	    return TRUE;
+	}
+    }
+
+    if (startup_time) {
+	fprintf(stderr, "mvqcalc: all pages built after %.3f ms\n",
+		g_timer_elapsed(startup, NULL) * 1000);
+	glade_template_report(startup);
+    }
+
+    return FALSE;
+}
+
+gboolean
+window_first_expose_cb(GtkWidget *widget, GdkEventExpose *event, gpointer user_data)
+{
+    g_signal_handlers_disconnect_by_func(widget, window_first_expose_cb, user_data);
+
+    fprintf(stderr, "mvqcalc: first frame after %.3f ms, process resident %ld kB\n",
+	    g_timer_elapsed(startup, NULL) * 1000, process_resident());
+
+    return FALSE;
+}
+
+void
+notebook_a_switch_page_cb(GtkWidget *widget, gpointer user_data)
+{
+    notebook_page_build(widget, gtk_notebook_get_current_page(GTK_NOTEBOOK(widget)));
+    recalculate_active_operations();
+}
+
+void
+notebook_b_switch_page_cb(GtkWidget *widget, gpointer user_data)
+{
+    notebook_page_build(widget, gtk_notebook_get_current_page(GTK_NOTEBOOK(widget)));
+    recalculate_active_operations();
+}
+
+void
+notebook_c_switch_page_cb(GtkWidget *widget, gpointer user_data)
+{
+    notebook_page_build(widget, gtk_notebook_get_current_page(GTK_NOTEBOOK(widget)));
+    //recalculate_active_operations();
+}
+
 int
 main(int argc, char **argv)
 {
     GladeXML *xml1;
     GtkWidget *box1, *box2, *box3, *box4, *box5, *box6, *box7, *box8, *box9, *box10, *box11;
     mat4x4_t m;
+    char *end;
+    long lines;
+#ifndef EMBEDDED_DATA
     char buf[BUFSIZ];
+#endif
     gint width;
+    int i;
+    startup = g_timer_new();
+
+#if !GLIB_CHECK_VERSION(2,32,0)
+    // the batched math functions use worker threads
+    g_thread_init(NULL);
+#endif
+
+    // headless mode, must be decided before gtk_init() needs a display
+    if (argc > 1 && strcmp(argv[1], "--batch") == 0)
+	return batch_main(argc - 1, argv + 1);
+    if (argc > 1 && strcmp(argv[1], "--poses") == 0)
+	return pose_stream_main(argc - 1, argv + 1);
 
     mat4x4_id(m);
 
     // custom resources
+#ifndef EMBEDDED_DATA
     if (find_data_file("gtkrc", buf, BUFSIZ) == TRUE) {
 	gtk_rc_add_default_file(buf);
     }
+#endif
 
     gtk_init(&argc, &argv);
 
+#ifdef EMBEDDED_DATA
+    // only a gtkrc, like find_data_file() above, the dark theme stays
+    // something to copy to gtkrc
+    const embedded_file_t *gtkrc = embedded_file_find("gtkrc");
+
+    if (gtkrc != NULL)
+	gtk_rc_parse_string(gtkrc->data);
+#endif
+
+    // gtk_init() has taken out the options that were for GTK
+    for (i = 1; i < argc; i++) {
+	if (strcmp(argv[i], "--notes-lines") == 0 && i + 1 < argc) {
+	    errno = 0;
+	    lines = strtol(argv[++i], &end, 10);
+	    if (*argv[i] == '\0' || *end != '\0' || errno == ERANGE ||
+		    lines <= 0 || lines > INT_MAX) {
+		fprintf(stderr, "mvqcalc: --notes-lines needs a number of lines from 1 to %d\n",
+			INT_MAX);
+		exit(2);
+	    }
+	    notes.max_lines = lines;
+	} else if (strcmp(argv[i], "--startup-time") == 0) {
+	    startup_time = TRUE;
+	}
+    }
+
     GdkScreen *gdk_screen = gdk_screen_get_default();
     width = gdk_screen_get_width(gdk_screen);
 
@@ -2637,15 +3363,7 @@ main(int argc, char **argv)
 	screenreswarning_dialog_run();
 
     /* load the interface */
-    if (find_data_file("main_window.glade", buf, BUFSIZ) != TRUE) {
-	fprintf(stderr, "ERROR: cannot locate glade file: '%s'\n", "main_window.glade");
-	exit(1);
-    }
-    xml1 = glade_xml_new(buf, NULL, NULL);
-    if (xml1 == NULL) {
-	fprintf(stderr, "ERROR: cannot load glade file: '%s'\n", "main_window.glade");
-	exit(1);
-    }
+    xml1 = glade_template_new("main_window.glade", "window");
 
     // locate window widget
     window = glade_xml_get_widget(xml1, "window");
@@ -2737,98 +3455,37 @@ main(int argc, char **argv)
 
     ///////////////////////////////////////////////////////////
 
-    matrix1 = matrix_widget_new(box1);
-    matrix_widget_set(matrix1, m);
-    matrix_toolbar1 = matrix_toolbar_widget_new(matrix1);
-
-    matrix2 = matrix_widget_new(box2);
-    matrix_widget_set(matrix2, m);
-    matrix_toolbar2 = matrix_toolbar_widget_new(matrix2);
-
-    matrix3 = matrix_widget_new(box3);
-    matrix_widget_set(matrix3, m);
-    matrix_result_toolbar = matrix_result_toolbar_widget_new(matrix3);
-
-    ///////////////////////////////////////////////////////////
-
-    GtkWidget *container;
-
     matrix_memory = memory_store_new(matrix_memory_toolbar_store, matrix_memory_toolbar_recall);
     quat_memory   = memory_store_new(quat_memory_toolbar_store, quat_memory_toolbar_recall);
     vector_memory = memory_store_new(vector_memory_toolbar_store, vector_memory_toolbar_recall);
 
     ///////////////////////////////////////////////////////////
 
-    container = glade_xml_get_widget(matrix_result_toolbar->gwidget->xml, "matrix_result_toolbar_memory_hbox");
-    g_assert(container != NULL);
-    gtk_memory_toolbar_new(matrix_memory, container, matrix3);
-
-    container = glade_xml_get_widget(matrix_toolbar1->gwidget->xml, "matrix_toolbar_recall_box");
-    g_assert(container != NULL);
-    gtk_memory_toolbar_new(matrix_memory, container, matrix1);
-    gtk_recall_toolbar_new(matrix_memory, container, matrix1);
-
-    container = glade_xml_get_widget(matrix_toolbar2->gwidget->xml, "matrix_toolbar_recall_box");
-    g_assert(container != NULL);
-    gtk_memory_toolbar_new(matrix_memory, container, matrix2);
-    gtk_recall_toolbar_new(matrix_memory, container, matrix2);
-
-    ///////////////////////////////////////////////////////////
+    // every page gets its widget now, but only holds values until built
+    matrix1 = matrix_widget_new(box1);
+    matrix2 = matrix_widget_new(box2);
+    matrix3 = matrix_widget_new(box3);
 
     vector1 = vector_widget_new(box4);
-    vector_toolbar1 = vector_toolbar_widget_new(vector1);
-
     vector2 = vector_widget_new(box5);
-    vector_toolbar2 = vector_toolbar_widget_new(vector2);
-
     vector3 = vector_widget_new(box6);
-    vector_result_toolbar = vector_result_toolbar_widget_new(vector3);
-
-    ///////////////////////////////////////////////////////////
-
-    container = glade_xml_get_widget(vector_result_toolbar->gwidget->xml, "vector_result_toolbar_memory_hbox");
-    g_assert(container != NULL);
-    gtk_memory_toolbar_new(vector_memory, container, vector3);
-
-    container = glade_xml_get_widget(vector_toolbar1->gwidget->xml, "vector_toolbar_recall_hbox");
-    g_assert(container != NULL);
-    gtk_recall_toolbar_new(vector_memory, container, vector1);
-
-    container = glade_xml_get_widget(vector_toolbar2->gwidget->xml, "vector_toolbar_recall_hbox");
-    g_assert(container != NULL);
-    gtk_recall_toolbar_new(vector_memory, container, vector2);
-
-    ///////////////////////////////////////////////////////////
 
     quat1 = quat_widget_new(box7);
-    quat_toolbar1 = quat_toolbar_widget_new(quat1);
-
     quat2 = quat_widget_new(box8);
-    quat_toolbar2 = quat_toolbar_widget_new(quat2);
-
     quat3 = quat_widget_new(box9);
-    quat_result_toolbar = quat_result_toolbar_widget_new(quat3);
-
-    ///////////////////////////////////////////////////////////
-
-    container = glade_xml_get_widget(quat_result_toolbar->gwidget->xml, "quat_result_toolbar_memory_hbox");
-    g_assert(container != NULL);
-    gtk_memory_toolbar_new(quat_memory, container, quat3);
-
-    container = glade_xml_get_widget(quat_toolbar1->gwidget->xml, "quat_toolbar_recall_hbox");
-    g_assert(container != NULL);
-    gtk_recall_toolbar_new(quat_memory, container, quat1);
-
-    container = glade_xml_get_widget(quat_toolbar2->gwidget->xml, "quat_toolbar_recall_hbox");
-    g_assert(container != NULL);
-    gtk_recall_toolbar_new(quat_memory, container, quat2);
-
-    ///////////////////////////////////////////////////////////
 
     scalar1 = scalar_widget_new(box10);
-
     scalar3 = scalar_widget_new(box11);
 
+    matrix_widget_set(matrix1, m);
+    matrix_widget_set(matrix2, m);
+    matrix_widget_set(matrix3, m);
+
+    // the matrix pages are the ones shown first
+    notebook_page_build(notebook_a, NOTEBOOK_PAGE_MATRIX);
+    notebook_page_build(notebook_b, NOTEBOOK_PAGE_MATRIX);
+    notebook_page_build(notebook_c, NOTEBOOK_PAGE_MATRIX);
+
     ///////////////////////////////////////////////////////////
 
     // configure text buffer
@@ -2838,12 +3495,23 @@ main(int argc, char **argv)
     GtkTextBuffer *text_buffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(text_view));
     red = gtk_text_buffer_create_tag(text_buffer, "red", "foreground", "#ff0000", NULL);
     cyan = gtk_text_buffer_create_tag(text_buffer, "cyan", "foreground", "#00ffff", NULL);
+    notes_init();
+
+    // explain the math of each operation in the text area
+    calc_explain = _printf;
 
     reset();
     recalculate_active_operations();
 
     /* connect the signals in the interface */
     glade_xml_signal_autoconnect(xml1);
+    g_object_unref(xml1);
+
+    if (startup_time)
+	g_signal_connect(window, "expose-event", G_CALLBACK(window_first_expose_cb), NULL);
+
+    // the other pages are built once the window is up
+    g_idle_add_full(G_PRIORITY_LOW, notebook_pages_idle, NULL, NULL);
 
     /* start the event loop */
     gtk_main();
@@ -0,0 +1,510 @@
+/*
+ *  Name: mvqfile.c
+ *  Description: Memory mapped array files of vectors, quaternions & matrices
+ *
+ *  Copyright (C) 2012  Jason Hall
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * The reader maps the whole file private and writable: the batched
+ * functions can work on the payload in place without copying it first,
+ * and whatever they write never reaches the file.
+ *
+ * The writer streams appends through stdio and writes the final count
+ * into the header when it is closed. A file whose writer never got to
+ * mvq_writer_close() reads back as empty.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <stdint.h>
+
+/* open()/fstat()/mmap()/ftruncate() */
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "mvqfile.h"
+
+G_STATIC_ASSERT(sizeof(mvq_header_t) == MVQ_ALIGN);
+
+#define ALIGN_UP(n)	(((n) + MVQ_ALIGN - 1) & ~(guint64) (MVQ_ALIGN - 1))
+
+struct mvq_reader_s {
+    void *map;
+    size_t size;
+    mvq_header_t *header;
+    char *payload;
+};
+
+struct mvq_writer_s {
+    FILE *fp;
+    char *path;
+    mvq_header_t header;
+    gboolean failed;
+    int error;		/* errno of the first failed write */
+};
+
+static int
+type_components(mvq_type_t type)
+{
+    switch (type) {
+	case MVQ_SCALAR:
+	    return 1;
+	case MVQ_VEC3:
+	    return 3;
+	case MVQ_QUAT:
+	    return 4;
+	case MVQ_MAT4X4:
+	    return 16;
+	default:
+	    return 0;
+    }
+}
+
+static size_t
+element_size(const mvq_header_t *h)
+{
+    return (size_t) h->components * h->precision;
+}
+
+///////////////////////////////////////////////////////////////////////
+/////////////////////////////  READER  ////////////////////////////////
+///////////////////////////////////////////////////////////////////////
+
+static gboolean
+header_valid(const char *path, const mvq_header_t *h, size_t size)
+{
+    guint64 payload;
+
+    if (memcmp(h->magic, MVQ_MAGIC, sizeof(h->magic)) != 0) {
+	fprintf(stderr, "mvqcalc: %s: not an array file\n", path);
+	return FALSE;
+    }
+    if (h->byte_order != MVQ_BYTE_ORDER) {
+	fprintf(stderr, "mvqcalc: %s: written with the other byte order\n", path);
+	return FALSE;
+    }
+    if (h->version != MVQ_VERSION) {
+	fprintf(stderr, "mvqcalc: %s: unsupported version %u\n", path,
+		h->version);
+	return FALSE;
+    }
+    if (h->header_size < sizeof(mvq_header_t) ||
+	    h->header_size % MVQ_ALIGN != 0 ||
+	    type_components(h->type) == 0 ||
+	    h->components != type_components(h->type) ||
+	    (h->precision != sizeof(real) && h->precision != sizeof(realf)) ||
+	    (h->layout != MVQ_PACKED && h->layout != MVQ_PLANAR) ||
+	    (h->layout == MVQ_PLANAR && h->type != MVQ_QUAT)) {
+	fprintf(stderr, "mvqcalc: %s: bad header\n", path);
+	return FALSE;
+    }
+
+    // the divisions keep a corrupt count or capacity from overflowing
+    if (h->layout == MVQ_PACKED) {
+	if (h->count > size / element_size(h)) {
+	    fprintf(stderr, "mvqcalc: %s: file is truncated\n", path);
+	    return FALSE;
+	}
+	payload = h->count * element_size(h);
+    } else {
+	if (h->count > h->capacity || h->plane_stride > size / 4 ||
+		h->capacity > h->plane_stride / h->precision ||
+		h->plane_stride % MVQ_ALIGN != 0) {
+	    fprintf(stderr, "mvqcalc: %s: bad header\n", path);
+	    return FALSE;
+	}
+	payload = 4 * h->plane_stride;
+    }
+    if (h->header_size + payload > size) {
+	fprintf(stderr, "mvqcalc: %s: file is truncated\n", path);
+	return FALSE;
+    }
+
+    return TRUE;
+}
+
+/* Map an array file, returns NULL after reporting why it can't. */
+mvq_reader_t *
+mvq_reader_open(const char *path)
+{
+    mvq_reader_t *r;
+    struct stat st;
+    void *map;
+    int fd;
+
+    if ((fd = open(path, O_RDONLY)) < 0) {
+	perror(path);
+	return NULL;
+    }
+    if (fstat(fd, &st) != 0) {
+	perror(path);
+	close(fd);
+	return NULL;
+    }
+    if ((size_t) st.st_size < sizeof(mvq_header_t)) {
+	fprintf(stderr, "mvqcalc: %s: not an array file\n", path);
+	close(fd);
+	return NULL;
+    }
+
+    map = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+	perror(path);
+	return NULL;
+    }
+
+    if (!header_valid(path, map, st.st_size)) {
+	munmap(map, st.st_size);
+	return NULL;
+    }
+
+    r = g_new0(mvq_reader_t, 1);
+    r->map     = map;
+    r->size    = st.st_size;
+    r->header  = map;
+    r->payload = (char *) map + r->header->header_size;
+
+#ifdef MADV_SEQUENTIAL
+    madvise(map, st.st_size, MADV_SEQUENTIAL);
+#endif
+
+    return r;
+}
+
+void
+mvq_reader_close(mvq_reader_t *r)
+{
+    if (r == NULL)
+	return;
+
+    munmap(r->map, r->size);
+    g_free(r);
+}
+
+const mvq_header_t *
+mvq_reader_header(mvq_reader_t *r)
+{
+    return r->header;
+}
+
+/*
+ * The packed payload, if it holds elements of the given type and
+ * precision (sizeof(real) or sizeof(realf)), NULL otherwise. The result
+ * can be cast to real *, vec3_t *, quat_t * or mat4x4_t * (or the float
+ * versions) and is 64 byte aligned.
+ */
+void *
+mvq_reader_data(mvq_reader_t *r, mvq_type_t type, int precision)
+{
+    const mvq_header_t *h = r->header;
+
+    if (h->layout != MVQ_PACKED || h->type != type || h->precision != precision)
+	return NULL;
+
+    return r->payload;
+}
+
+static gboolean
+reader_planes(mvq_reader_t *r, int precision, void *planes[4])
+{
+    const mvq_header_t *h = r->header;
+    int i;
+
+    if (h->layout != MVQ_PLANAR || h->precision != precision)
+	return FALSE;
+
+    for (i = 0; i < 4; i++)
+	planes[i] = r->payload + i * h->plane_stride;
+
+    return TRUE;
+}
+
+/* Point q at the planes of a planar quaternion file. */
+gboolean
+mvq_reader_quat_soa(mvq_reader_t *r, quat_soa_t *q)
+{
+    void *planes[4];
+
+    if (!reader_planes(r, sizeof(real), planes))
+	return FALSE;
+
+    q->x = planes[0];
+    q->y = planes[1];
+    q->z = planes[2];
+    q->w = planes[3];
+    return TRUE;
+}
+
+gboolean
+mvq_reader_quatf_soa(mvq_reader_t *r, quatf_soa_t *q)
+{
+    void *planes[4];
+
+    if (!reader_planes(r, sizeof(realf), planes))
+	return FALSE;
+
+    q->x = planes[0];
+    q->y = planes[1];
+    q->z = planes[2];
+    q->w = planes[3];
+    return TRUE;
+}
+
+///////////////////////////////////////////////////////////////////////
+/////////////////////////////  WRITER  ////////////////////////////////
+///////////////////////////////////////////////////////////////////////
+
+static void
+writer_io_failed(mvq_writer_t *w)
+{
+    if (!w->failed)
+	w->error = errno;
+    w->failed = TRUE;
+}
+
+/*
+ * Create an array file for elements of the given type and precision
+ * (sizeof(real) or sizeof(realf)). MVQ_PLANAR needs the largest number
+ * of quaternions that will be appended up front, capacity is ignored for
+ * MVQ_PACKED.
+ */
+mvq_writer_t *
+mvq_writer_open(const char *path, mvq_type_t type, int precision,
+	mvq_layout_t layout, guint64 capacity)
+{
+    mvq_writer_t *w;
+    mvq_header_t *h;
+    FILE *fp;
+
+    g_return_val_if_fail(type_components(type) != 0, NULL);
+    g_return_val_if_fail(precision == sizeof(real) ||
+	    precision == sizeof(realf), NULL);
+    g_return_val_if_fail(layout == MVQ_PACKED || type == MVQ_QUAT, NULL);
+
+    // the four planes have to fit in a size_t
+    if (layout == MVQ_PLANAR &&
+	    capacity > (SIZE_MAX / 4 - MVQ_ALIGN - sizeof(mvq_header_t)) / precision) {
+	fprintf(stderr, "mvqcalc: %s: capacity %" G_GUINT64_FORMAT " is too large\n",
+		path, capacity);
+	return NULL;
+    }
+
+    if ((fp = fopen(path, "w+b")) == NULL) {
+	perror(path);
+	return NULL;
+    }
+
+    w = g_new0(mvq_writer_t, 1);
+    w->fp   = fp;
+    w->path = g_strdup(path);
+
+    h = &w->header;
+    memcpy(h->magic, MVQ_MAGIC, sizeof(h->magic));
+    h->byte_order  = MVQ_BYTE_ORDER;
+    h->version     = MVQ_VERSION;
+    h->header_size = sizeof(mvq_header_t);
+    h->type        = type;
+    h->precision   = precision;
+    h->layout      = layout;
+    h->components  = type_components(type);
+
+    if (layout == MVQ_PLANAR) {
+	h->capacity     = capacity;
+	h->plane_stride = ALIGN_UP(capacity * precision);
+
+	// size the file so the planes exist before the first append
+	if (ftruncate(fileno(fp), h->header_size + 4 * h->plane_stride) != 0)
+	    w->failed = TRUE;
+    }
+
+    // count stays 0 until mvq_writer_close()
+    if (fwrite(h, sizeof(*h), 1, fp) != 1)
+	w->failed = TRUE;
+
+    if (w->failed) {
+	perror(path);
+	fclose(fp);
+	unlink(path);
+	g_free(w->path);
+	g_free(w);
+	return NULL;
+    }
+
+    return w;
+}
+
+/*
+ * Write n reals read every stride bytes from src into plane at the
+ * current count.
+ */
+static void
+write_plane(mvq_writer_t *w, int plane, const char *src, size_t stride,
+	size_t n)
+{
+    const mvq_header_t *h = &w->header;
+    char buf[4096];
+    size_t i, j, batch = sizeof(buf) / h->precision;
+    off_t offset;
+
+    offset = h->header_size + plane * h->plane_stride + h->count * h->precision;
+    if (fseeko(w->fp, offset, SEEK_SET) != 0) {
+	writer_io_failed(w);
+	return;
+    }
+
+    for (i = 0; i < n; i += batch) {
+	size_t m = MIN(batch, n - i);
+
+	if (stride == h->precision) {
+	    memcpy(buf, src + i * stride, m * h->precision);
+	} else {
+	    for (j = 0; j < m; j++)
+		memcpy(buf + j * h->precision, src + (i + j) * stride,
+			h->precision);
+	}
+	if (fwrite(buf, h->precision, m, w->fp) != m) {
+	    writer_io_failed(w);
+	    return;
+	}
+    }
+}
+
+static gboolean
+planar_room(mvq_writer_t *w, size_t n)
+{
+    if (w->header.count + n > w->header.capacity) {
+	fprintf(stderr, "mvqcalc: %s: more than %" G_GUINT64_FORMAT
+		" quaternions appended\n", w->path, w->header.capacity);
+	w->failed = TRUE;
+	return FALSE;
+    }
+    return TRUE;
+}
+
+/*
+ * Append n elements laid out like an array of the file's element type.
+ * For planar files these are quat_t (or quatf_t) which get split up.
+ */
+gboolean
+mvq_writer_append(mvq_writer_t *w, const void *items, size_t n)
+{
+    mvq_header_t *h = &w->header;
+    size_t size = element_size(h);
+    int i;
+
+    if (w->failed)
+	return FALSE;
+
+    if (h->layout == MVQ_PACKED) {
+	if (fwrite(items, size, n, w->fp) != n)
+	    writer_io_failed(w);
+    } else if (planar_room(w, n)) {
+	for (i = 0; i < 4; i++)
+	    write_plane(w, i, (const char *) items + i * h->precision, size, n);
+    }
+
+    if (!w->failed)
+	h->count += n;
+    return !w->failed;
+}
+
+static gboolean
+append_planes(mvq_writer_t *w, int precision, void *planes[4], size_t n)
+{
+    mvq_header_t *h = &w->header;
+    int i;
+
+    g_return_val_if_fail(h->type == MVQ_QUAT && h->precision == precision,
+	    FALSE);
+
+    if (w->failed)
+	return FALSE;
+
+    if (h->layout == MVQ_PACKED) {
+	char buf[4096];
+	size_t size = element_size(h), batch = sizeof(buf) / size;
+	size_t j, k, m;
+
+	// interleave back into quat_t
+	for (j = 0; j < n && !w->failed; j += batch) {
+	    m = MIN(batch, n - j);
+	    for (k = 0; k < m; k++) {
+		for (i = 0; i < 4; i++)
+		    memcpy(buf + k * size + i * precision,
+			    (char *) planes[i] + (j + k) * precision, precision);
+	    }
+	    if (fwrite(buf, size, m, w->fp) != m)
+		writer_io_failed(w);
+	}
+    } else if (planar_room(w, n)) {
+	for (i = 0; i < 4; i++)
+	    write_plane(w, i, planes[i], precision, n);
+    }
+
+    if (!w->failed)
+	h->count += n;
+    return !w->failed;
+}
+
+gboolean
+mvq_writer_append_quat_soa(mvq_writer_t *w, quat_soa_t *q, size_t n)
+{
+    void *planes[4] = { q->x, q->y, q->z, q->w };
+
+    return append_planes(w, sizeof(real), planes, n);
+}
+
+gboolean
+mvq_writer_append_quatf_soa(mvq_writer_t *w, quatf_soa_t *q, size_t n)
+{
+    void *planes[4] = { q->x, q->y, q->z, q->w };
+
+    return append_planes(w, sizeof(realf), planes, n);
+}
+
+/*
+ * Store the final count and close the file. Returns FALSE if anything
+ * written since mvq_writer_open() failed.
+ */
+gboolean
+mvq_writer_close(mvq_writer_t *w)
+{
+    gboolean ok;
+
+    if (!w->failed && (fseeko(w->fp, 0, SEEK_SET) != 0 ||
+		fwrite(&w->header, sizeof(w->header), 1, w->fp) != 1))
+	writer_io_failed(w);
+    if (fclose(w->fp) != 0)
+	writer_io_failed(w);
+
+    // running out of planar capacity was reported when it happened
+    if (w->error != 0)
+	fprintf(stderr, "mvqcalc: %s: write error: %s\n", w->path,
+		g_strerror(w->error));
+
+    ok = !w->failed;
+
+    g_free(w->path);
+    g_free(w);
+    return ok;
+}
@@ -0,0 +1,94 @@
+/*
+ *  Name: mvqfile.h
+ *  Description: Memory mapped array files of vectors, quaternions & matrices
+ *
+ *  Copyright (C) 2012  Jason Hall
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MVQFILE_H
+#define MVQFILE_H
+
+#include "mathlib.h"
+
+/*
+ * File layout: one 64 byte mvq_header_t followed by the payload, which
+ * starts at header_size (a multiple of MVQ_ALIGN).
+ *
+ * MVQ_PACKED stores the elements back to back exactly like an array of
+ * real, vec3_t, quat_t or mat4x4_t (or their float versions), so a mapped
+ * file can be handed straight to the batched functions.
+ *
+ * MVQ_PLANAR is for quaternions only and stores the x, y, z and w
+ * components in four planes of 'capacity' reals each, every plane
+ * starting on an MVQ_ALIGN boundary, which is the quat_soa_t layout.
+ *
+ * Everything is stored in the byte order of the machine that wrote the
+ * file. Readers refuse files of the other byte order rather than copy.
+ */
+
+#define MVQ_MAGIC	"MVQARRAY"
+#define MVQ_VERSION	1
+#define MVQ_ALIGN	64
+#define MVQ_BYTE_ORDER	0x01020304
+
+typedef enum {
+    MVQ_SCALAR = 1,
+    MVQ_VEC3,
+    MVQ_QUAT,
+    MVQ_MAT4X4
+} mvq_type_t;
+
+typedef enum {
+    MVQ_PACKED = 0,
+    MVQ_PLANAR
+} mvq_layout_t;
+
+typedef struct {
+    char magic[8];		/* MVQ_MAGIC, not nul terminated */
+    guint32 byte_order;		/* MVQ_BYTE_ORDER */
+    guint16 version;		/* MVQ_VERSION */
+    guint16 header_size;	/* offset of the payload */
+    guint8 type;		/* mvq_type_t */
+    guint8 precision;		/* bytes per real, 4 or 8 */
+    guint8 layout;		/* mvq_layout_t */
+    guint8 components;		/* reals per element: 1, 3, 4 or 16 */
+    guint32 reserved0;
+    guint64 count;		/* elements stored */
+    guint64 capacity;		/* MVQ_PLANAR: elements each plane holds */
+    guint64 plane_stride;	/* MVQ_PLANAR: bytes from one plane to the next */
+    guint8 reserved[16];
+} mvq_header_t;
+
+typedef struct mvq_reader_s mvq_reader_t;
+typedef struct mvq_writer_s mvq_writer_t;
+
+mvq_reader_t *mvq_reader_open(const char *path);
+void mvq_reader_close(mvq_reader_t *r);
+const mvq_header_t *mvq_reader_header(mvq_reader_t *r);
+void *mvq_reader_data(mvq_reader_t *r, mvq_type_t type, int precision);
+gboolean mvq_reader_quat_soa(mvq_reader_t *r, quat_soa_t *q);
+gboolean mvq_reader_quatf_soa(mvq_reader_t *r, quatf_soa_t *q);
+
+mvq_writer_t *mvq_writer_open(const char *path, mvq_type_t type,
+	int precision, mvq_layout_t layout, guint64 capacity);
+gboolean mvq_writer_append(mvq_writer_t *w, const void *items, size_t n);
+gboolean mvq_writer_append_quat_soa(mvq_writer_t *w, quat_soa_t *q,
+	size_t n);
+gboolean mvq_writer_append_quatf_soa(mvq_writer_t *w, quatf_soa_t *q,
+	size_t n);
+gboolean mvq_writer_close(mvq_writer_t *w);
+
+#endif /* MVQFILE_H */
@@ -0,0 +1,245 @@
+/*
+ *  Name: mvqfile_check.c
+ *  Description: Checks for the array file reader and writer (make check)
+ *
+ *  Copyright (C) 2012  Jason Hall
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Writes packed and planar files and reads them back, and makes sure
+ * the reader refuses corrupt headers instead of handing out pointers
+ * past the end of the mapping:
+ *
+ *	mvqfile_check [DIRECTORY]
+ *
+ * The scratch files go to DIRECTORY, the current one by default. Exits
+ * with 1 if any check failed.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* unlink() */
+#include <unistd.h>
+
+#include "mvqfile.h"
+
+#define CHECK_COUNT	1000
+
+static int failures;
+
+static void
+check(gboolean ok, const char *what)
+{
+    printf("%-48s %s\n", what, ok ? "ok" : "FAILED");
+    if (!ok)
+	failures++;
+}
+
+static void
+check_packed(const char *path)
+{
+    vec3_t *v;
+    mvq_writer_t *w;
+    mvq_reader_t *r;
+    vec3_t *data;
+    int i;
+
+    v = g_new(vec3_t, CHECK_COUNT);
+    for (i = 0; i < CHECK_COUNT; i++) {
+	v[i][0] = i;
+	v[i][1] = -i * 0.5;
+	v[i][2] = 1.0 / (i + 1);
+    }
+
+    // in two appends, so the second one has to go after the first
+    w = mvq_writer_open(path, MVQ_VEC3, sizeof(real), MVQ_PACKED, 0);
+    check(w != NULL, "packed: open for writing");
+    if (w == NULL)
+	goto out;
+    check(mvq_writer_append(w, v, CHECK_COUNT / 2) &&
+	    mvq_writer_append(w, v + CHECK_COUNT / 2, CHECK_COUNT - CHECK_COUNT / 2),
+	    "packed: append");
+    check(mvq_writer_close(w), "packed: close");
+
+    r = mvq_reader_open(path);
+    check(r != NULL, "packed: open for reading");
+    if (r == NULL)
+	goto out;
+    check(mvq_reader_header(r)->count == CHECK_COUNT, "packed: count");
+    check(mvq_reader_data(r, MVQ_QUAT, sizeof(real)) == NULL,
+	    "packed: refuses the wrong type");
+    data = mvq_reader_data(r, MVQ_VEC3, sizeof(real));
+    check(data != NULL && ((size_t) data % MVQ_ALIGN) == 0, "packed: aligned data");
+    check(data != NULL && memcmp(data, v, CHECK_COUNT * sizeof(vec3_t)) == 0,
+	    "packed: round trip");
+    mvq_reader_close(r);
+
+out:
+    unlink(path);
+    g_free(v);
+}
+
+static void
+check_planar(const char *path)
+{
+    quat_soa_t q, in;
+    mvq_writer_t *w;
+    mvq_reader_t *r;
+    quat_t e;
+    gboolean same;
+    int i;
+
+    q.x = g_new(real, CHECK_COUNT);
+    q.y = g_new(real, CHECK_COUNT);
+    q.z = g_new(real, CHECK_COUNT);
+    q.w = g_new(real, CHECK_COUNT);
+    for (i = 0; i < CHECK_COUNT; i++) {
+	q.x[i] = i;
+	q.y[i] = i + 0.25;
+	q.z[i] = -i;
+	q.w[i] = 1.0 / (i + 1);
+    }
+
+    // room for more than is written, the planes must still line up
+    w = mvq_writer_open(path, MVQ_QUAT, sizeof(real), MVQ_PLANAR, CHECK_COUNT + 37);
+    check(w != NULL, "planar: open for writing");
+    if (w == NULL)
+	goto out;
+    check(mvq_writer_append_quat_soa(w, &q, CHECK_COUNT - 1), "planar: append soa");
+
+    // and an array of structures element at the end
+    e[0] = q.x[CHECK_COUNT - 1];
+    e[1] = q.y[CHECK_COUNT - 1];
+    e[2] = q.z[CHECK_COUNT - 1];
+    e[3] = q.w[CHECK_COUNT - 1];
+    check(mvq_writer_append(w, e, 1), "planar: append quat_t");
+    check(mvq_writer_close(w), "planar: close");
+
+    r = mvq_reader_open(path);
+    check(r != NULL, "planar: open for reading");
+    if (r == NULL)
+	goto out;
+    check(mvq_reader_header(r)->count == CHECK_COUNT, "planar: count");
+    check(mvq_reader_data(r, MVQ_QUAT, sizeof(real)) == NULL,
+	    "planar: no packed data");
+    same = mvq_reader_quat_soa(r, &in) &&
+	    memcmp(in.x, q.x, CHECK_COUNT * sizeof(real)) == 0 &&
+	    memcmp(in.y, q.y, CHECK_COUNT * sizeof(real)) == 0 &&
+	    memcmp(in.z, q.z, CHECK_COUNT * sizeof(real)) == 0 &&
+	    memcmp(in.w, q.w, CHECK_COUNT * sizeof(real)) == 0;
+    check(same, "planar: round trip");
+    mvq_reader_close(r);
+
+out:
+    unlink(path);
+    g_free(q.x);
+    g_free(q.y);
+    g_free(q.z);
+    g_free(q.w);
+}
+
+/* write a header followed by size - sizeof(*h) zero bytes */
+static gboolean
+write_raw(const char *path, const mvq_header_t *h, size_t size)
+{
+    char *buf;
+    FILE *fp;
+    gboolean ok;
+
+    buf = g_malloc0(size);
+    memcpy(buf, h, sizeof(*h));
+
+    if ((fp = fopen(path, "wb")) == NULL) {
+	perror(path);
+	g_free(buf);
+	return FALSE;
+    }
+    ok = fwrite(buf, size, 1, fp) == 1;
+    ok &= fclose(fp) == 0;
+
+    g_free(buf);
+    return ok;
+}
+
+static void
+check_corrupt(const char *path)
+{
+    mvq_header_t h;
+    mvq_reader_t *r;
+
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, MVQ_MAGIC, sizeof(h.magic));
+    h.byte_order   = MVQ_BYTE_ORDER;
+    h.version      = MVQ_VERSION;
+    h.header_size  = sizeof(mvq_header_t);
+    h.type         = MVQ_QUAT;
+    h.precision    = sizeof(real);
+    h.layout       = MVQ_PLANAR;
+    h.components   = 4;
+
+    // capacity * precision wraps around to 0, which is below any stride
+    h.count        = 1000000;
+    h.capacity     = (guint64) 1 << 61;
+    h.plane_stride = 64;
+
+    r = NULL;
+    if (write_raw(path, &h, sizeof(h) + 4 * h.plane_stride))
+	r = mvq_reader_open(path);
+    check(r == NULL, "corrupt: planar capacity overflow refused");
+    mvq_reader_close(r);
+
+    // a packed count that doesn't fit the file
+    h.layout       = MVQ_PACKED;
+    h.count        = 1000000;
+    h.capacity     = 0;
+    h.plane_stride = 0;
+
+    r = NULL;
+    if (write_raw(path, &h, sizeof(h) + 64))
+	r = mvq_reader_open(path);
+    check(r == NULL, "corrupt: truncated packed file refused");
+    mvq_reader_close(r);
+
+    unlink(path);
+
+    check(mvq_writer_open(path, MVQ_QUAT, sizeof(real), MVQ_PLANAR,
+		(guint64) 1 << 61) == NULL,
+	    "corrupt: writer refuses an overflowing capacity");
+    unlink(path);
+}
+
+int
+main(int argc, char **argv)
+{
+    const char *dir = argc > 1 ? argv[1] : ".";
+    char *path;
+
+    path = g_strdup_printf("%s/mvqfile_check.%d.mvq", dir, (int) getpid());
+
+    check_packed(path);
+    check_planar(path);
+    check_corrupt(path);
+
+    g_free(path);
+
+    if (failures > 0) {
+	printf("%d checks FAILED\n", failures);
+	return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,382 @@
+/*
+ *  Name: numfmt.c
+ *  Description: Shortest round trip number formatting
+ *
+ *  Copyright (C) 2012  Jason Hall
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * The digits come from Ulf Adams' Ryu algorithm ("Ryu: fast float-to-string
+ * conversion", PLDI 2018): the interval of decimals that round to the
+ * double is computed with one 64x128 bit multiply per bound against a
+ * table of powers of 5, then digits are dropped while the bounds still
+ * differ. No bignums, no loops over candidate precisions, no libc.
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#include "numfmt.h"
+#include "numfmt_table.h"
+
+#define DOUBLE_MANTISSA_BITS	52
+#define DOUBLE_EXPONENT_BITS	11
+#define DOUBLE_BIAS		1023
+
+static const char digit_pairs[200] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+/* ceil(log2(5^e)), or 1 for e == 0 */
+static inline int32_t
+pow5bits(int32_t e)
+{
+    return ((e * 1217359) >> 19) + 1;
+}
+
+/* floor(log10(2^e)) */
+static inline uint32_t
+log10_pow2(int32_t e)
+{
+    return (e * 78913) >> 18;
+}
+
+/* floor(log10(5^e)) */
+static inline uint32_t
+log10_pow5(int32_t e)
+{
+    return (e * 732923) >> 20;
+}
+
+static inline uint32_t
+pow5_factor(uint64_t v)
+{
+    uint32_t count = 0;
+
+    while (v % 5 == 0) {
+	v /= 5;
+	count++;
+    }
+    return count;
+}
+
+static inline int
+multiple_of_pow5(uint64_t v, uint32_t p)
+{
+    return pow5_factor(v) >= p;
+}
+
+static inline int
+multiple_of_pow2(uint64_t v, uint32_t p)
+{
+    return (v & ((1ULL << p) - 1)) == 0;
+}
+
+/* (m * mul) >> j, where mul is 128 bits and j >= 64 */
+static inline uint64_t
+mul_shift64(uint64_t m, const uint64_t *mul, int32_t j)
+{
+#ifdef __SIZEOF_INT128__
+    unsigned __int128 b0 = (unsigned __int128) m * mul[0];
+    unsigned __int128 b2 = (unsigned __int128) m * mul[1];
+
+    return (uint64_t) (((b0 >> 64) + b2) >> (j - 64));
+#else
+    // the same with 32 bit halves
+    uint64_t m_lo = (uint32_t) m, m_hi = m >> 32;
+    uint64_t lo, mid, hi, b0_hi, b2_lo, b2_hi, sum;
+    int shift = j - 64;
+
+    // high 64 bits of m * mul[0]
+    lo  = m_lo * (uint32_t) mul[0];
+    mid = m_hi * (uint32_t) mul[0] + (lo >> 32);
+    hi  = m_lo * (mul[0] >> 32) + (uint32_t) mid;
+    b0_hi = m_hi * (mul[0] >> 32) + (mid >> 32) + (hi >> 32);
+
+    // all 128 bits of m * mul[1]
+    lo  = m_lo * (uint32_t) mul[1];
+    mid = m_hi * (uint32_t) mul[1] + (lo >> 32);
+    hi  = m_lo * (mul[1] >> 32) + (uint32_t) mid;
+    b2_lo = (hi << 32) | (uint32_t) lo;
+    b2_hi = m_hi * (mul[1] >> 32) + (mid >> 32) + (hi >> 32);
+
+    sum = b2_lo + b0_hi;
+    b2_hi += sum < b0_hi;
+
+    if (shift == 0)
+	return sum;
+    return (b2_hi << (64 - shift)) | (sum >> shift);
+#endif
+}
+
+/*
+ * The decimal digits and exponent of the shortest decimal that rounds to
+ * the double with the given mantissa and biased exponent bits, so that
+ * the value is *digits * 10^*exponent. Ryu's d2d().
+ */
+static void
+shortest_decimal(uint64_t ieee_mantissa, uint32_t ieee_exponent,
+	uint64_t *digits, int32_t *exponent)
+{
+    int32_t e2, e10;
+    uint64_t m2, mv, vr, vp, vm, output;
+    uint32_t mm_shift, q;
+    int accept_bounds, vm_trailing_zeros = 0, vr_trailing_zeros = 0;
+    int32_t removed = 0, k, i, j;
+    uint8_t last_removed = 0;
+
+    if (ieee_exponent == 0) {
+	e2 = 1 - DOUBLE_BIAS - DOUBLE_MANTISSA_BITS - 2;
+	m2 = ieee_mantissa;
+    } else {
+	e2 = (int32_t) ieee_exponent - DOUBLE_BIAS - DOUBLE_MANTISSA_BITS - 2;
+	m2 = (1ULL << DOUBLE_MANTISSA_BITS) | ieee_mantissa;
+    }
+    accept_bounds = (m2 & 1) == 0;
+
+    // the value and its halfway points to the neighbours, times 4
+    mv = 4 * m2;
+    mm_shift = ieee_mantissa != 0 || ieee_exponent <= 1;
+
+    if (e2 >= 0) {
+	q = log10_pow2(e2) - (e2 > 3);
+	e10 = q;
+	k = POW5_INV_BITCOUNT + pow5bits(q) - 1;
+	i = -e2 + (int32_t) q + k;
+	vr = mul_shift64(4 * m2, pow5_inv_split[q], i);
+	vp = mul_shift64(4 * m2 + 2, pow5_inv_split[q], i);
+	vm = mul_shift64(4 * m2 - 1 - mm_shift, pow5_inv_split[q], i);
+	if (q <= 21) {
+	    // only one of mp, mv and mm can be a multiple of 5
+	    if (mv % 5 == 0)
+		vr_trailing_zeros = multiple_of_pow5(mv, q);
+	    else if (accept_bounds)
+		vm_trailing_zeros = multiple_of_pow5(mv - 1 - mm_shift, q);
+	    else
+		vp -= multiple_of_pow5(mv + 2, q);
+	}
+    } else {
+	q = log10_pow5(-e2) - (-e2 > 1);
+	e10 = (int32_t) q + e2;
+	i = -e2 - (int32_t) q;
+	k = pow5bits(i) - POW5_BITCOUNT;
+	j = (int32_t) q - k;
+	vr = mul_shift64(4 * m2, pow5_split[i], j);
+	vp = mul_shift64(4 * m2 + 2, pow5_split[i], j);
+	vm = mul_shift64(4 * m2 - 1 - mm_shift, pow5_split[i], j);
+	if (q <= 1) {
+	    // mv has at least q trailing zero bits, so vr is exact
+	    vr_trailing_zeros = 1;
+	    if (accept_bounds)
+		vm_trailing_zeros = mm_shift == 1;
+	    else
+		vp--;
+	} else if (q < 63) {
+	    vr_trailing_zeros = multiple_of_pow2(mv, q);
+	}
+    }
+
+    if (vm_trailing_zeros || vr_trailing_zeros) {
+	// rare: exact ties need the removed digits tracked precisely
+	while (vp / 10 > vm / 10) {
+	    vm_trailing_zeros &= vm % 10 == 0;
+	    vr_trailing_zeros &= last_removed == 0;
+	    last_removed = vr % 10;
+	    vr /= 10;
+	    vp /= 10;
+	    vm /= 10;
+	    removed++;
+	}
+	if (vm_trailing_zeros) {
+	    while (vm % 10 == 0) {
+		vr_trailing_zeros &= last_removed == 0;
+		last_removed = vr % 10;
+		vr /= 10;
+		vp /= 10;
+		vm /= 10;
+		removed++;
+	    }
+	}
+	// exactly halfway, round to even
+	if (vr_trailing_zeros && last_removed == 5 && vr % 2 == 0)
+	    last_removed = 4;
+	output = vr + ((vr == vm && (!accept_bounds || !vm_trailing_zeros)) ||
+		last_removed >= 5);
+    } else {
+	int round_up = 0;
+
+	if (vp / 100 > vm / 100) {
+	    round_up = vr % 100 >= 50;
+	    vr /= 100;
+	    vp /= 100;
+	    vm /= 100;
+	    removed += 2;
+	}
+	while (vp / 10 > vm / 10) {
+	    round_up = vr % 10 >= 5;
+	    vr /= 10;
+	    vp /= 10;
+	    vm /= 10;
+	    removed++;
+	}
+	output = vr + (vr == vm || round_up);
+    }
+
+    *digits = output;
+    *exponent = e10 + removed;
+}
+
+static inline int
+decimal_length(uint64_t v)
+{
+    int len = 1;
+
+    while (v >= 10) {
+	v /= 10;
+	len++;
+    }
+    return len;
+}
+
+/* write the len digits of v ending just before end */
+static inline void
+write_digits(uint64_t v, char *end, int len)
+{
+    while (len >= 2) {
+	int pair = (v % 100) * 2;
+
+	v /= 100;
+	end -= 2;
+	end[0] = digit_pairs[pair];
+	end[1] = digit_pairs[pair + 1];
+	len -= 2;
+    }
+    if (len)
+	*--end = '0' + v;
+}
+
+/*
+ * Format v into buf (at least NUMFMT_MAX bytes) and return the length,
+ * not counting the nul.
+ */
+int
+numfmt_double(double v, char *buf)
+{
+    uint64_t bits, mantissa, digits;
+    uint32_t exponent;
+    int32_t e10;
+    int len, point;
+    char *p = buf;
+
+    memcpy(&bits, &v, sizeof(bits));
+    mantissa = bits & ((1ULL << DOUBLE_MANTISSA_BITS) - 1);
+    exponent = (bits >> DOUBLE_MANTISSA_BITS) & ((1u << DOUBLE_EXPONENT_BITS) - 1);
+
+    // same spellings as printf("%g")
+    if (exponent == (1u << DOUBLE_EXPONENT_BITS) - 1) {
+	if (mantissa != 0) {
+	    strcpy(buf, "nan");
+	    return 3;
+	}
+	strcpy(buf, bits >> 63 ? "-inf" : "inf");
+	return bits >> 63 ? 4 : 3;
+    }
+
+    if (bits >> 63)
+	*p++ = '-';
+
+    if (exponent == 0 && mantissa == 0) {
+	*p++ = '0';
+	*p = '\0';
+	return p - buf;
+    }
+
+    shortest_decimal(mantissa, exponent, &digits, &e10);
+    len = decimal_length(digits);
+    point = len + e10;	// digits before the decimal point
+
+    if (e10 >= 0) {
+	// whole number, pad with zeros
+	write_digits(digits, p + len, len);
+	p += len;
+	memset(p, '0', e10);
+	p += e10;
+    } else if (point > 0) {
+	// make room for the point in front of the fraction
+	write_digits(digits, p + len, len);
+	memmove(p + point + 1, p + point, len - point);
+	p[point] = '.';
+	p += len + 1;
+    } else {
+	*p++ = '0';
+	*p++ = '.';
+	memset(p, '0', -point);
+	p += -point;
+	write_digits(digits, p + len, len);
+	p += len;
+    }
+
+    *p = '\0';
+    return p - buf;
+}
+
+/*
+ * Format n numbers into one buffer. With sep == '\0' every number is
+ * nul terminated on its own, for handing out to widgets, otherwise they
+ * are separated by sep and only the last one is terminated, for output.
+ * offsets, if not NULL, receives where each number starts.
+ *
+ * Returns the bytes used including the final nul, or 0 if size is too
+ * small. n * NUMFMT_MAX bytes are always enough.
+ */
+size_t
+numfmt_array(const double *v, int n, char sep, char *buf, size_t size,
+	int *offsets)
+{
+    char tmp[NUMFMT_MAX];
+    size_t used = 0;
+    int i, len;
+
+    if (n == 0) {
+	if (size == 0)
+	    return 0;
+	*buf = '\0';
+	return 1;
+    }
+
+    for (i = 0; i < n; i++) {
+	if (offsets != NULL)
+	    offsets[i] = used;
+
+	if (size - used >= NUMFMT_MAX) {
+	    len = numfmt_double(v[i], buf + used);
+	} else {
+	    len = numfmt_double(v[i], tmp);
+	    if ((size_t) len + 1 > size - used)
+		return 0;
+	    memcpy(buf + used, tmp, len + 1);
+	}
+
+	used += len;
+	if (sep != '\0' && i + 1 < n)
+	    buf[used] = sep;
+	used++;
+    }
+
+    return used;
+}
@@ -0,0 +1,41 @@
+/*
+ *  Name: numfmt.h
+ *  Description: Shortest round trip number formatting
+ *
+ *  Copyright (C) 2012  Jason Hall
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NUMFMT_H
+#define NUMFMT_H
+
+#include <stddef.h>
+
+/*
+ * Numbers are written with the fewest digits that read back as the same
+ * double, and never in exponent notation: the entry boxes show the end
+ * of the text and an exponent there is easily missed. 1e-7 comes out as
+ * 0.0000001 and 1e21 as 1000000000000000000000.
+ *
+ * The longest possible result (the smallest negative denormal) takes
+ * NUMFMT_MAX bytes including the nul.
+ */
+#define NUMFMT_MAX	328
+
+int numfmt_double(double v, char *buf);
+size_t numfmt_array(const double *v, int n, char sep, char *buf, size_t size,
+	int *offsets);
+
+#endif /* NUMFMT_H */
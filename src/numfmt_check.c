@@ -0,0 +1,303 @@
+/*
+ *  Name: numfmt_check.c
+ *  Description: Checks for the number formatting (make check)
+ *
+ *  Copyright (C) 2012  Jason Hall
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Formats random and edge case doubles with numfmt_double() and reads
+ * them back with strtod(), which must give the same bits, checks they
+ * use no more digits than printf("%.*e") needs for that, and that
+ * numfmt_array() lays them out as its comment says:
+ *
+ *	numfmt_check
+ *
+ * Exits with 1 if any check failed.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <float.h>
+#include <math.h>
+
+#include "numfmt.h"
+
+#define SIGN_BIT	0x8000000000000000ULL
+#define EXPONENT_BITS	0x7ff0000000000000ULL
+
+/* random bit patterns, and as many again spread over a few decades */
+#define CHECK_RANDOM	100000
+
+/* numbers per numfmt_array() call */
+#define CHECK_ARRAY	50
+
+static int failures;
+
+static void
+check(int ok, const char *what)
+{
+    printf("%-48s %s\n", what, ok ? "ok" : "FAILED");
+    if (!ok)
+	failures++;
+}
+
+static double
+from_bits(uint64_t bits)
+{
+    double v;
+
+    memcpy(&v, &bits, sizeof(v));
+    return v;
+}
+
+static uint64_t
+to_bits(double v)
+{
+    uint64_t bits;
+
+    memcpy(&bits, &v, sizeof(bits));
+    return bits;
+}
+
+/* rand() is never seeded, so every run checks the same numbers */
+static uint64_t
+random_bits(void)
+{
+    return ((uint64_t) rand() << 62) ^ ((uint64_t) rand() << 31) ^ rand();
+}
+
+/* significant digits in s, the leading and padding zeros don't count */
+static int
+significant_digits(const char *s)
+{
+    int first = -1, last = -1, i, n = 0;
+
+    for (i = 0; s[i] != '\0'; i++) {
+	if (s[i] < '0' || s[i] > '9')
+	    continue;
+	if (s[i] != '0') {
+	    if (first < 0)
+		first = n;
+	    last = n;
+	}
+	n++;
+    }
+    return first < 0 ? 1 : last - first + 1;
+}
+
+/* the fewest digits printf() needs for v to read back the same */
+static int
+shortest_digits(double v)
+{
+    char buf[32];
+    int precision;
+
+    for (precision = 0; precision < 17; precision++) {
+	snprintf(buf, sizeof(buf), "%.*e", precision, v);
+	if (strtod(buf, NULL) == v)
+	    break;
+    }
+    return precision + 1;
+}
+
+/*
+ * v formats to something strtod() reads back bit for bit, that is no
+ * longer than it needs to be and fits in NUMFMT_MAX. Prints the first
+ * few that don't.
+ */
+static int
+round_trips(double v)
+{
+    static int reported;
+    char buf[NUMFMT_MAX + 16];
+    char *end;
+    double back;
+    int len;
+
+    memset(buf, 'x', sizeof(buf));
+    len = numfmt_double(v, buf);
+    back = strtod(buf, &end);
+
+    if (len < NUMFMT_MAX && buf[len] == '\0' && (size_t) len == strlen(buf) &&
+	    *end == '\0' && to_bits(back) == to_bits(v) &&
+	    !strchr(buf, 'e') &&
+	    (v == 0 || significant_digits(buf) <= shortest_digits(v)))
+	return 1;
+
+    if (reported++ < 10)
+	printf("  %.17g (0x%016llx) came out as \"%.40s\"\n", v,
+		(unsigned long long) to_bits(v), buf);
+    return 0;
+}
+
+static void
+check_edges(void)
+{
+    static const double edges[] = {
+	0.0, 1.0, 0.1, 0.2, 0.3, 1.0 / 3.0, 2.0 / 3.0, 123456789.0,
+	9007199254740992.0, 9007199254740993.0, 9007199254740994.0,
+	1e21, 1e22, 1e23, 5e-324, 1e-7, 1.7976931348623157e308,
+	DBL_MAX, DBL_MIN, DBL_EPSILON, 2.2250738585072009e-308,
+	4.9406564584124654e-324, 1.2345678901234567e-300
+    };
+    char buf[NUMFMT_MAX], what[64];
+    int i, e, ok;
+
+    ok = 1;
+    for (i = 0; i < sizeof(edges) / sizeof(edges[0]); i++)
+	ok &= round_trips(edges[i]) && round_trips(-edges[i]);
+    check(ok, "edge values");
+
+    // the largest, the second smallest and one between, then any of them
+    ok = round_trips(from_bits(0x000fffffffffffffULL)) &&
+	 round_trips(from_bits(0x0000000000000002ULL)) &&
+	 round_trips(from_bits(0x0000000080000000ULL));
+    for (i = 0; i < 1000; i++)
+	ok &= round_trips(from_bits(random_bits() & 0x800fffffffffffffULL));
+    check(ok, "denormals");
+
+    ok = 1;
+    for (e = -323; e <= 308; e++) {
+	snprintf(buf, sizeof(buf), "1e%d", e);
+	ok &= round_trips(strtod(buf, NULL));
+	snprintf(buf, sizeof(buf), "-9.99e%d", e - 1);
+	ok &= round_trips(strtod(buf, NULL));
+    }
+    check(ok, "powers of ten");
+
+    ok = 1;
+    for (e = -1074; e <= 1023; e++)
+	ok &= round_trips(ldexp(1, e)) && round_trips(nextafter(ldexp(1, e), 0));
+    check(ok, "powers of two");
+
+    // -0 keeps its sign, the others print like printf("%g"). Made from
+    // bits, -ffast-math is free to lose them otherwise.
+    numfmt_double(from_bits(SIGN_BIT), buf);
+    check(strcmp(buf, "-0") == 0 && to_bits(strtod(buf, NULL)) == SIGN_BIT,
+	    "-0");
+    ok = numfmt_double(from_bits(EXPONENT_BITS), buf) == 3 &&
+	 strcmp(buf, "inf") == 0;
+    ok &= numfmt_double(from_bits(SIGN_BIT | EXPONENT_BITS), buf) == 4 &&
+	  strcmp(buf, "-inf") == 0;
+    ok &= numfmt_double(from_bits(EXPONENT_BITS | 1), buf) == 3 &&
+	  strcmp(buf, "nan") == 0;
+    check(ok, "inf and nan");
+
+    // the longest one there is
+    i = numfmt_double(-5e-324, buf);
+    snprintf(what, sizeof(what), "-5e-324 takes NUMFMT_MAX (%d)", i + 1);
+    check(i + 1 == NUMFMT_MAX && round_trips(-5e-324), what);
+}
+
+static void
+check_random(void)
+{
+    uint64_t bits;
+    double v;
+    int i, ok;
+
+    ok = 1;
+    for (i = 0; i < CHECK_RANDOM; i++) {
+	do {
+	    bits = random_bits();
+	} while ((bits & EXPONENT_BITS) == EXPONENT_BITS);
+	ok &= round_trips(from_bits(bits));
+    }
+    check(ok, "random bit patterns");
+
+    ok = 1;
+    for (i = 0; i < CHECK_RANDOM; i++) {
+	v = (rand() / (double) RAND_MAX - 0.5) * pow(10, rand() % 13 - 6);
+	ok &= round_trips(v);
+    }
+    check(ok, "random values from 1e-6 to 1e6");
+}
+
+/*
+ * with a separator the numbers come back from splitting on it, without
+ * one from the offsets, and size must be just enough
+ */
+static void
+check_array(void)
+{
+    double v[CHECK_ARRAY], back;
+    char buf[CHECK_ARRAY * NUMFMT_MAX], tmp[NUMFMT_MAX];
+    char *p, *end;
+    int offsets[CHECK_ARRAY];
+    size_t used, expect;
+    int i, ok;
+
+    expect = 0;
+    for (i = 0; i < CHECK_ARRAY; i++) {
+	v[i] = i % 7 == 0 ? -5e-324 :
+	       (rand() / (double) RAND_MAX - 0.5) * pow(10, rand() % 20 - 10);
+	expect += numfmt_double(v[i], tmp) + 1;
+    }
+
+    used = numfmt_array(v, CHECK_ARRAY, ',', buf, sizeof(buf), offsets);
+    ok = used == expect && strlen(buf) + 1 == used;
+    for (i = 0, p = buf; ok && i < CHECK_ARRAY; i++) {
+	back = strtod(p, &end);
+	ok = offsets[i] == p - buf && to_bits(back) == to_bits(v[i]) &&
+	     *end == (i + 1 < CHECK_ARRAY ? ',' : '\0');
+	p = end + 1;
+    }
+    check(ok, "numfmt_array with a separator");
+
+    used = numfmt_array(v, CHECK_ARRAY, '\0', buf, sizeof(buf), offsets);
+    ok = used == expect;
+    for (i = 0; ok && i < CHECK_ARRAY; i++) {
+	back = strtod(buf + offsets[i], &end);
+	ok = to_bits(back) == to_bits(v[i]) && *end == '\0' &&
+	     (i + 1 == CHECK_ARRAY ? end + 1 - buf == used :
+				      end + 1 - buf == offsets[i + 1]);
+    }
+    check(ok, "numfmt_array nul terminated, offsets");
+
+    ok = numfmt_array(v, CHECK_ARRAY, ',', buf, expect, NULL) == expect &&
+	 numfmt_array(v, CHECK_ARRAY, ',', buf, expect - 1, NULL) == 0 &&
+	 numfmt_array(v, CHECK_ARRAY, '\0', buf, expect, NULL) == expect &&
+	 numfmt_array(v, CHECK_ARRAY, '\0', buf, expect - 1, NULL) == 0;
+    check(ok, "numfmt_array size exactly enough");
+
+    // n * NUMFMT_MAX is always enough, and the longest need all of it
+    for (i = 0; i < CHECK_ARRAY; i++)
+	v[i] = -5e-324;
+    ok = numfmt_array(v, CHECK_ARRAY, ' ', buf, sizeof(buf), NULL) == sizeof(buf) &&
+	 numfmt_array(v, CHECK_ARRAY, '\0', buf, sizeof(buf), NULL) == sizeof(buf);
+    check(ok, "numfmt_array n * NUMFMT_MAX");
+
+    ok = numfmt_array(v, 0, ',', buf, sizeof(buf), NULL) == 1 && buf[0] == '\0' &&
+	 numfmt_array(v, 0, ',', buf, 0, NULL) == 0;
+    check(ok, "numfmt_array no numbers");
+}
+
+int
+main(int argc, char **argv)
+{
+    check_edges();
+    check_random();
+    check_array();
+
+    if (failures > 0) {
+	printf("%d checks FAILED\n", failures);
+	return 1;
+    }
+    return 0;
+}
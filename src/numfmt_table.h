@@ -0,0 +1,707 @@
+/*
+ *  Name: numfmt_table.h
+ *  Description: Powers of 5 for numfmt.c, generated, do not edit
+ *
+ *  Copyright (C) 2012  Jason Hall
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Each entry is a 128 bit value split into its low and high 64 bits.
+ *
+ * pow5_inv_split[q] = floor(2^(bits(5^q) - 1 + 125) / 5^q) + 1
+ * pow5_split[i]     = 5^i shifted to exactly 125 significant bits
+ *
+ * where bits(x) is the number of bits in x.
+ */
+
+#define POW5_INV_BITCOUNT	125
+#define POW5_BITCOUNT		125
+#define POW5_INV_TABLE_SIZE	342
+#define POW5_TABLE_SIZE		326
+
+static const uint64_t pow5_inv_split[POW5_INV_TABLE_SIZE][2] = {
+    {                    1ULL,  2305843009213693952ULL },
+    { 11068046444225730970ULL,  1844674407370955161ULL },
+    {  5165088340638674453ULL,  1475739525896764129ULL },
+    {  7821419487252849886ULL,  1180591620717411303ULL },
+    {  8824922364862649494ULL,  1888946593147858085ULL },
+    {  7059937891890119595ULL,  1511157274518286468ULL },
+    { 13026647942995916322ULL,  1208925819614629174ULL },
+    {  9774590264567735146ULL,  1934281311383406679ULL },
+    { 11509021026396098440ULL,  1547425049106725343ULL },
+    { 16585914450600699399ULL,  1237940039285380274ULL },
+    { 15469416676735388068ULL,  1980704062856608439ULL },
+    { 16064882156130220778ULL,  1584563250285286751ULL },
+    {  9162556910162266299ULL,  1267650600228229401ULL },
+    {  7281393426775805432ULL,  2028240960365167042ULL },
+    { 16893161185646375315ULL,  1622592768292133633ULL },
+    {  2446482504291369283ULL,  1298074214633706907ULL },
+    {  7603720821608101175ULL,  2076918743413931051ULL },
+    {  2393627842544570617ULL,  1661534994731144841ULL },
+    { 16672297533003297786ULL,  1329227995784915872ULL },
+    { 11918280793837635165ULL,  2126764793255865396ULL },
+    {  5845275820328197809ULL,  1701411834604692317ULL },
+    { 15744267100488289217ULL,  1361129467683753853ULL },
+    {  3054734472329800808ULL,  2177807148294006166ULL },
+    { 17201182836831481939ULL,  1742245718635204932ULL },
+    {  6382248639981364905ULL,  1393796574908163946ULL },
+    {  2832900194486363201ULL,  2230074519853062314ULL },
+    {  5955668970331000884ULL,  1784059615882449851ULL },
+    {  1075186361522890384ULL,  1427247692705959881ULL },
+    { 12788344622662355584ULL,  2283596308329535809ULL },
+    { 13920024512871794791ULL,  1826877046663628647ULL },
+    {  3757321980813615186ULL,  1461501637330902918ULL },
+    { 10384555214134712795ULL,  1169201309864722334ULL },
+    {  5547241898389809503ULL,  1870722095783555735ULL },
+    {  4437793518711847602ULL,  1496577676626844588ULL },
+    { 10928932444453298728ULL,  1197262141301475670ULL },
+    { 17486291911125277965ULL,  1915619426082361072ULL },
+    {  6610335899416401726ULL,  1532495540865888858ULL },
+    { 12666966349016942027ULL,  1225996432692711086ULL },
+    { 12888448528943286597ULL,  1961594292308337738ULL },
+    { 17689456452638449924ULL,  1569275433846670190ULL },
+    { 14151565162110759939ULL,  1255420347077336152ULL },
+    {  7885109000409574610ULL,  2008672555323737844ULL },
+    {  9997436015069570011ULL,  1606938044258990275ULL },
+    {  7997948812055656009ULL,  1285550435407192220ULL },
+    { 12796718099289049614ULL,  2056880696651507552ULL },
+    {  2858676849947419045ULL,  1645504557321206042ULL },
+    { 13354987924183666206ULL,  1316403645856964833ULL },
+    { 17678631863951955605ULL,  2106245833371143733ULL },
+    {  3074859046935833515ULL,  1684996666696914987ULL },
+    { 13527933681774397782ULL,  1347997333357531989ULL },
+    { 10576647446613305481ULL,  2156795733372051183ULL },
+    { 15840015586774465031ULL,  1725436586697640946ULL },
+    {  8982663654677661702ULL,  1380349269358112757ULL },
+    { 18061610662226169046ULL,  2208558830972980411ULL },
+    { 10759939715039024913ULL,  1766847064778384329ULL },
+    { 12297300586773130254ULL,  1413477651822707463ULL },
+    { 15986332124095098083ULL,  2261564242916331941ULL },
+    {  9099716884534168143ULL,  1809251394333065553ULL },
+    { 14658471137111155161ULL,  1447401115466452442ULL },
+    {  4348079280205103483ULL,  1157920892373161954ULL },
+    { 14335624477811986218ULL,  1852673427797059126ULL },
+    {  7779150767507678651ULL,  1482138742237647301ULL },
+    {  2533971799264232598ULL,  1185710993790117841ULL },
+    { 15122401323048503126ULL,  1897137590064188545ULL },
+    { 12097921058438802501ULL,  1517710072051350836ULL },
+    {  5988988032009131678ULL,  1214168057641080669ULL },
+    { 16961078480698431330ULL,  1942668892225729070ULL },
+    { 13568862784558745064ULL,  1554135113780583256ULL },
+    {  7165741412905085728ULL,  1243308091024466605ULL },
+    { 11465186260648137165ULL,  1989292945639146568ULL },
+    { 16550846638002330379ULL,  1591434356511317254ULL },
+    { 16930026125143774626ULL,  1273147485209053803ULL },
+    {  4951948911778577463ULL,  2037035976334486086ULL },
+    {   272210314680951647ULL,  1629628781067588869ULL },
+    {  3907117066486671641ULL,  1303703024854071095ULL },
+    {  6251387306378674625ULL,  2085924839766513752ULL },
+    { 16069156289328670670ULL,  1668739871813211001ULL },
+    {  9165976216721026213ULL,  1334991897450568801ULL },
+    {  7286864317269821294ULL,  2135987035920910082ULL },
+    { 16897537898041588005ULL,  1708789628736728065ULL },
+    { 13518030318433270404ULL,  1367031702989382452ULL },
+    {  6871453250525591353ULL,  2187250724783011924ULL },
+    {  9186511415162383406ULL,  1749800579826409539ULL },
+    { 11038557946871817048ULL,  1399840463861127631ULL },
+    { 10282995085511086630ULL,  2239744742177804210ULL },
+    {  8226396068408869304ULL,  1791795793742243368ULL },
+    { 13959814484210916090ULL,  1433436634993794694ULL },
+    { 11267656730511734774ULL,  2293498615990071511ULL },
+    {  5324776569667477496ULL,  1834798892792057209ULL },
+    {  7949170070475892320ULL,  1467839114233645767ULL },
+    { 17427382500606444826ULL,  1174271291386916613ULL },
+    {  5747719112518849781ULL,  1878834066219066582ULL },
+    { 15666221734240810795ULL,  1503067252975253265ULL },
+    { 12532977387392648636ULL,  1202453802380202612ULL },
+    {  5295368560860596524ULL,  1923926083808324180ULL },
+    {  4236294848688477220ULL,  1539140867046659344ULL },
+    {  7078384693692692099ULL,  1231312693637327475ULL },
+    { 11325415509908307358ULL,  1970100309819723960ULL },
+    {  9060332407926645887ULL,  1576080247855779168ULL },
+    { 14626963555825137356ULL,  1260864198284623334ULL },
+    { 12335095245094488799ULL,  2017382717255397335ULL },
+    {  9868076196075591040ULL,  1613906173804317868ULL },
+    { 15273158586344293478ULL,  1291124939043454294ULL },
+    { 13369007293925138595ULL,  2065799902469526871ULL },
+    {  7005857020398200553ULL,  1652639921975621497ULL },
+    { 16672732060544291412ULL,  1322111937580497197ULL },
+    { 11918976037903224966ULL,  2115379100128795516ULL },
+    {  5845832015580669650ULL,  1692303280103036413ULL },
+    { 12055363241948356366ULL,  1353842624082429130ULL },
+    {   841837113407818570ULL,  2166148198531886609ULL },
+    {  4362818505468165179ULL,  1732918558825509287ULL },
+    { 14558301248600263113ULL,  1386334847060407429ULL },
+    { 12225235553534690011ULL,  2218135755296651887ULL },
+    {  2401490813343931363ULL,  1774508604237321510ULL },
+    {  1921192650675145090ULL,  1419606883389857208ULL },
+    { 17831303500047873437ULL,  2271371013423771532ULL },
+    {  6886345170554478103ULL,  1817096810739017226ULL },
+    {  1819727321701672159ULL,  1453677448591213781ULL },
+    { 16213177116328979020ULL,  1162941958872971024ULL },
+    { 14873036941900635463ULL,  1860707134196753639ULL },
+    { 15587778368262418694ULL,  1488565707357402911ULL },
+    {  8780873879868024632ULL,  1190852565885922329ULL },
+    {  2981351763563108441ULL,  1905364105417475727ULL },
+    { 13453127855076217722ULL,  1524291284333980581ULL },
+    {  7073153469319063855ULL,  1219433027467184465ULL },
+    { 11317045550910502167ULL,  1951092843947495144ULL },
+    { 12742985255470312057ULL,  1560874275157996115ULL },
+    { 10194388204376249646ULL,  1248699420126396892ULL },
+    {  1553625868034358140ULL,  1997919072202235028ULL },
+    {  8621598323911307159ULL,  1598335257761788022ULL },
+    { 17965325103354776697ULL,  1278668206209430417ULL },
+    { 13987124906400001422ULL,  2045869129935088668ULL },
+    {   121653480894270168ULL,  1636695303948070935ULL },
+    {    97322784715416134ULL,  1309356243158456748ULL },
+    { 14913111714512307107ULL,  2094969989053530796ULL },
+    {  8241140556867935363ULL,  1675975991242824637ULL },
+    { 17660958889720079260ULL,  1340780792994259709ULL },
+    { 17189487779326395846ULL,  2145249268790815535ULL },
+    { 13751590223461116677ULL,  1716199415032652428ULL },
+    { 18379969808252713988ULL,  1372959532026121942ULL },
+    { 14650556434236701088ULL,  2196735251241795108ULL },
+    {   652398703163629901ULL,  1757388200993436087ULL },
+    { 11589965406756634890ULL,  1405910560794748869ULL },
+    {  7475898206584884855ULL,  2249456897271598191ULL },
+    {  2291369750525997561ULL,  1799565517817278553ULL },
+    {  9211793429904618695ULL,  1439652414253822842ULL },
+    { 18428218302589300235ULL,  2303443862806116547ULL },
+    {  7363877012587619542ULL,  1842755090244893238ULL },
+    { 13269799239553916280ULL,  1474204072195914590ULL },
+    { 10615839391643133024ULL,  1179363257756731672ULL },
+    {  2227947767661371545ULL,  1886981212410770676ULL },
+    { 16539753473096738529ULL,  1509584969928616540ULL },
+    { 13231802778477390823ULL,  1207667975942893232ULL },
+    {  6413489186596184024ULL,  1932268761508629172ULL },
+    { 16198837793502678189ULL,  1545815009206903337ULL },
+    {  5580372605318321905ULL,  1236652007365522670ULL },
+    {  8928596168509315048ULL,  1978643211784836272ULL },
+    { 18210923379033183008ULL,  1582914569427869017ULL },
+    {  7190041073742725760ULL,  1266331655542295214ULL },
+    {   436019273762630246ULL,  2026130648867672343ULL },
+    {  7727513048493924843ULL,  1620904519094137874ULL },
+    {  9871359253537050198ULL,  1296723615275310299ULL },
+    {  4726128361433549347ULL,  2074757784440496479ULL },
+    {  7470251503888749801ULL,  1659806227552397183ULL },
+    { 13354898832594820487ULL,  1327844982041917746ULL },
+    { 13989140502667892133ULL,  2124551971267068394ULL },
+    { 14880661216876224029ULL,  1699641577013654715ULL },
+    { 11904528973500979224ULL,  1359713261610923772ULL },
+    {  4289851098633925465ULL,  2175541218577478036ULL },
+    { 18189276137874781665ULL,  1740432974861982428ULL },
+    {  3483374466074094362ULL,  1392346379889585943ULL },
+    {  1884050330976640656ULL,  2227754207823337509ULL },
+    {  5196589079523222848ULL,  1782203366258670007ULL },
+    { 15225317707844309248ULL,  1425762693006936005ULL },
+    {  5913764258841343181ULL,  2281220308811097609ULL },
+    {  8420360221814984868ULL,  1824976247048878087ULL },
+    { 17804334621677718864ULL,  1459980997639102469ULL },
+    { 17932816512084085415ULL,  1167984798111281975ULL },
+    { 10245762345624985047ULL,  1868775676978051161ULL },
+    {  4507261061758077715ULL,  1495020541582440929ULL },
+    {  7295157664148372495ULL,  1196016433265952743ULL },
+    {  7982903447895485668ULL,  1913626293225524389ULL },
+    { 10075671573058298858ULL,  1530901034580419511ULL },
+    {  4371188443704728763ULL,  1224720827664335609ULL },
+    { 14372599139411386667ULL,  1959553324262936974ULL },
+    { 15187428126271019657ULL,  1567642659410349579ULL },
+    { 15839291315758726049ULL,  1254114127528279663ULL },
+    {  3206773216762499739ULL,  2006582604045247462ULL },
+    { 13633465017635730761ULL,  1605266083236197969ULL },
+    { 14596120828850494932ULL,  1284212866588958375ULL },
+    {  4907049252451240275ULL,  2054740586542333401ULL },
+    {   236290587219081897ULL,  1643792469233866721ULL },
+    { 14946427728742906810ULL,  1315033975387093376ULL },
+    { 16535586736504830250ULL,  2104054360619349402ULL },
+    {  5849771759720043554ULL,  1683243488495479522ULL },
+    { 15747863852001765813ULL,  1346594790796383617ULL },
+    { 10439186904235184007ULL,  2154551665274213788ULL },
+    { 15730047152871967852ULL,  1723641332219371030ULL },
+    { 12584037722297574282ULL,  1378913065775496824ULL },
+    {  9066413911450387881ULL,  2206260905240794919ULL },
+    { 10942479943902220628ULL,  1765008724192635935ULL },
+    {  8753983955121776503ULL,  1412006979354108748ULL },
+    { 10317025513452932081ULL,  2259211166966573997ULL },
+    {   874922781278525018ULL,  1807368933573259198ULL },
+    {  8078635854506640661ULL,  1445895146858607358ULL },
+    { 13841606313089133175ULL,  1156716117486885886ULL },
+    { 14767872471458792434ULL,  1850745787979017418ULL },
+    {   746251532941302978ULL,  1480596630383213935ULL },
+    {   597001226353042382ULL,  1184477304306571148ULL },
+    { 15712597221132509104ULL,  1895163686890513836ULL },
+    {  8880728962164096960ULL,  1516130949512411069ULL },
+    { 10793931984473187891ULL,  1212904759609928855ULL },
+    { 17270291175157100626ULL,  1940647615375886168ULL },
+    {  2748186495899949531ULL,  1552518092300708935ULL },
+    {  2198549196719959625ULL,  1242014473840567148ULL },
+    { 18275073973719576693ULL,  1987223158144907436ULL },
+    { 10930710364233751031ULL,  1589778526515925949ULL },
+    { 12433917106128911148ULL,  1271822821212740759ULL },
+    {  8826220925580526867ULL,  2034916513940385215ULL },
+    {  7060976740464421494ULL,  1627933211152308172ULL },
+    { 16716827836597268165ULL,  1302346568921846537ULL },
+    { 11989529279587987770ULL,  2083754510274954460ULL },
+    {  9591623423670390216ULL,  1667003608219963568ULL },
+    { 15051996368420132820ULL,  1333602886575970854ULL },
+    { 13015147745246481542ULL,  2133764618521553367ULL },
+    {  3033420566713364587ULL,  1707011694817242694ULL },
+    {  6116085268112601993ULL,  1365609355853794155ULL },
+    {  9785736428980163188ULL,  2184974969366070648ULL },
+    { 15207286772667951197ULL,  1747979975492856518ULL },
+    {  1097782973908629988ULL,  1398383980394285215ULL },
+    {  1756452758253807981ULL,  2237414368630856344ULL },
+    {  5094511021344956708ULL,  1789931494904685075ULL },
+    {  4075608817075965366ULL,  1431945195923748060ULL },
+    {  6520974107321544586ULL,  2291112313477996896ULL },
+    {  1527430471115325346ULL,  1832889850782397517ULL },
+    { 12289990821117991246ULL,  1466311880625918013ULL },
+    { 17210690286378213644ULL,  1173049504500734410ULL },
+    {  9090360384495590213ULL,  1876879207201175057ULL },
+    { 18340334751822203140ULL,  1501503365760940045ULL },
+    { 14672267801457762512ULL,  1201202692608752036ULL },
+    { 16096930852848599373ULL,  1921924308174003258ULL },
+    {  1809498238053148529ULL,  1537539446539202607ULL },
+    { 12515645034668249793ULL,  1230031557231362085ULL },
+    {  1578287981759648052ULL,  1968050491570179337ULL },
+    { 12330676829633449412ULL,  1574440393256143469ULL },
+    { 13553890278448669853ULL,  1259552314604914775ULL },
+    {  3239480371808320148ULL,  2015283703367863641ULL },
+    { 17348979556414297411ULL,  1612226962694290912ULL },
+    {  6500486015647617283ULL,  1289781570155432730ULL },
+    { 10400777625036187652ULL,  2063650512248692368ULL },
+    { 15699319729512770768ULL,  1650920409798953894ULL },
+    { 16248804598352126938ULL,  1320736327839163115ULL },
+    {  7551343283653851484ULL,  2113178124542660985ULL },
+    {  6041074626923081187ULL,  1690542499634128788ULL },
+    { 12211557331022285596ULL,  1352433999707303030ULL },
+    {  1091747655926105338ULL,  2163894399531684849ULL },
+    {  4562746939482794594ULL,  1731115519625347879ULL },
+    {  7339546366328145998ULL,  1384892415700278303ULL },
+    {  8053925371383123274ULL,  2215827865120445285ULL },
+    {  6443140297106498619ULL,  1772662292096356228ULL },
+    { 12533209867169019542ULL,  1418129833677084982ULL },
+    {  5295740528502789974ULL,  2269007733883335972ULL },
+    { 15304638867027962949ULL,  1815206187106668777ULL },
+    {  4865013464138549713ULL,  1452164949685335022ULL },
+    { 14960057215536570740ULL,  1161731959748268017ULL },
+    {  9178696285890871890ULL,  1858771135597228828ULL },
+    { 14721654658196518159ULL,  1487016908477783062ULL },
+    {  4398626097073393881ULL,  1189613526782226450ULL },
+    {  7037801755317430209ULL,  1903381642851562320ULL },
+    {  5630241404253944167ULL,  1522705314281249856ULL },
+    {   814844308661245011ULL,  1218164251424999885ULL },
+    {  1303750893857992017ULL,  1949062802279999816ULL },
+    { 15800395974054034906ULL,  1559250241823999852ULL },
+    {  5261619149759407279ULL,  1247400193459199882ULL },
+    { 12107939454356961969ULL,  1995840309534719811ULL },
+    {  5997002748743659252ULL,  1596672247627775849ULL },
+    {  8486951013736837725ULL,  1277337798102220679ULL },
+    {  2511075177753209390ULL,  2043740476963553087ULL },
+    { 13076906586428298482ULL,  1634992381570842469ULL },
+    { 14150874083884549109ULL,  1307993905256673975ULL },
+    {  4194654460505726958ULL,  2092790248410678361ULL },
+    { 18113118827372222859ULL,  1674232198728542688ULL },
+    {  3422448617672047318ULL,  1339385758982834151ULL },
+    { 16543964232501006678ULL,  2143017214372534641ULL },
+    {  9545822571258895019ULL,  1714413771498027713ULL },
+    { 15015355686490936662ULL,  1371531017198422170ULL },
+    {  5577825024675947042ULL,  2194449627517475473ULL },
+    { 11840957649224578280ULL,  1755559702013980378ULL },
+    { 16851463748863483271ULL,  1404447761611184302ULL },
+    { 12204946739213931940ULL,  2247116418577894884ULL },
+    { 13453306206113055875ULL,  1797693134862315907ULL },
+    {  3383947335406624054ULL,  1438154507889852726ULL },
+    { 16482362180876329456ULL,  2301047212623764361ULL },
+    {  9496540929959153242ULL,  1840837770099011489ULL },
+    { 11286581558709232917ULL,  1472670216079209191ULL },
+    {  5339916432225476010ULL,  1178136172863367353ULL },
+    {  4854517476818851293ULL,  1885017876581387765ULL },
+    {  3883613981455081034ULL,  1508014301265110212ULL },
+    { 14174937629389795797ULL,  1206411441012088169ULL },
+    { 11611853762797942306ULL,  1930258305619341071ULL },
+    {  5600134195496443521ULL,  1544206644495472857ULL },
+    { 15548153800622885787ULL,  1235365315596378285ULL },
+    {  6430302007287065643ULL,  1976584504954205257ULL },
+    { 16212288050055383484ULL,  1581267603963364205ULL },
+    { 12969830440044306787ULL,  1265014083170691364ULL },
+    {  9683682259845159889ULL,  2024022533073106183ULL },
+    { 15125643437359948558ULL,  1619218026458484946ULL },
+    {  8411165935146048523ULL,  1295374421166787957ULL },
+    { 17147214310975587960ULL,  2072599073866860731ULL },
+    { 10028422634038560045ULL,  1658079259093488585ULL },
+    {  8022738107230848036ULL,  1326463407274790868ULL },
+    {  9147032156827446534ULL,  2122341451639665389ULL },
+    { 11006974540203867551ULL,  1697873161311732311ULL },
+    {  5116230817421183718ULL,  1358298529049385849ULL },
+    { 15564666937357714594ULL,  2173277646479017358ULL },
+    {  1383687105660440706ULL,  1738622117183213887ULL },
+    { 12174996128754083534ULL,  1390897693746571109ULL },
+    {  8411947361780802685ULL,  2225436309994513775ULL },
+    {  6729557889424642148ULL,  1780349047995611020ULL },
+    {  5383646311539713719ULL,  1424279238396488816ULL },
+    {  1235136468979721303ULL,  2278846781434382106ULL },
+    { 15745504434151418335ULL,  1823077425147505684ULL },
+    { 16285752362063044992ULL,  1458461940118004547ULL },
+    {  5649904260166615347ULL,  1166769552094403638ULL },
+    {  5350498001524674232ULL,  1866831283351045821ULL },
+    {   591049586477829062ULL,  1493465026680836657ULL },
+    { 11540886113407994219ULL,  1194772021344669325ULL },
+    {    18673707743239135ULL,  1911635234151470921ULL },
+    { 14772334225162232601ULL,  1529308187321176736ULL },
+    {  8128518565387875758ULL,  1223446549856941389ULL },
+    {  1937583260394870242ULL,  1957514479771106223ULL },
+    {  8928764237799716840ULL,  1566011583816884978ULL },
+    { 14521709019723594119ULL,  1252809267053507982ULL },
+    {  8477339172590109297ULL,  2004494827285612772ULL },
+    { 17849917782297818407ULL,  1603595861828490217ULL },
+    {  6901236596354434079ULL,  1282876689462792174ULL },
+    { 18420676183650915173ULL,  2052602703140467478ULL },
+    {  3668494502695001169ULL,  1642082162512373983ULL },
+    { 10313493231639821582ULL,  1313665730009899186ULL },
+    {  9122891541139893884ULL,  2101865168015838698ULL },
+    { 14677010862395735754ULL,  1681492134412670958ULL },
+    {   673562245690857633ULL,  1345193707530136767ULL },
+};
+
+static const uint64_t pow5_split[POW5_TABLE_SIZE][2] = {
+    {                    0ULL,  1152921504606846976ULL },
+    {                    0ULL,  1441151880758558720ULL },
+    {                    0ULL,  1801439850948198400ULL },
+    {                    0ULL,  2251799813685248000ULL },
+    {                    0ULL,  1407374883553280000ULL },
+    {                    0ULL,  1759218604441600000ULL },
+    {                    0ULL,  2199023255552000000ULL },
+    {                    0ULL,  1374389534720000000ULL },
+    {                    0ULL,  1717986918400000000ULL },
+    {                    0ULL,  2147483648000000000ULL },
+    {                    0ULL,  1342177280000000000ULL },
+    {                    0ULL,  1677721600000000000ULL },
+    {                    0ULL,  2097152000000000000ULL },
+    {                    0ULL,  1310720000000000000ULL },
+    {                    0ULL,  1638400000000000000ULL },
+    {                    0ULL,  2048000000000000000ULL },
+    {                    0ULL,  1280000000000000000ULL },
+    {                    0ULL,  1600000000000000000ULL },
+    {                    0ULL,  2000000000000000000ULL },
+    {                    0ULL,  1250000000000000000ULL },
+    {                    0ULL,  1562500000000000000ULL },
+    {                    0ULL,  1953125000000000000ULL },
+    {                    0ULL,  1220703125000000000ULL },
+    {                    0ULL,  1525878906250000000ULL },
+    {                    0ULL,  1907348632812500000ULL },
+    {                    0ULL,  1192092895507812500ULL },
+    {                    0ULL,  1490116119384765625ULL },
+    {  4611686018427387904ULL,  1862645149230957031ULL },
+    {  9799832789158199296ULL,  1164153218269348144ULL },
+    { 12249790986447749120ULL,  1455191522836685180ULL },
+    { 15312238733059686400ULL,  1818989403545856475ULL },
+    { 14528612397897220096ULL,  2273736754432320594ULL },
+    { 13692068767113150464ULL,  1421085471520200371ULL },
+    { 12503399940464050176ULL,  1776356839400250464ULL },
+    { 15629249925580062720ULL,  2220446049250313080ULL },
+    {  9768281203487539200ULL,  1387778780781445675ULL },
+    {  7598665485932036096ULL,  1734723475976807094ULL },
+    {   274959820560269312ULL,  2168404344971008868ULL },
+    {  9395221924704944128ULL,  1355252715606880542ULL },
+    {  2520655369026404352ULL,  1694065894508600678ULL },
+    { 12374191248137781248ULL,  2117582368135750847ULL },
+    { 14651398557727195136ULL,  1323488980084844279ULL },
+    { 13702562178731606016ULL,  1654361225106055349ULL },
+    {  3293144668132343808ULL,  2067951531382569187ULL },
+    { 18199116482078572544ULL,  1292469707114105741ULL },
+    {  8913837547316051968ULL,  1615587133892632177ULL },
+    { 15753982952572452864ULL,  2019483917365790221ULL },
+    { 12152082354571476992ULL,  1262177448353618888ULL },
+    { 15190102943214346240ULL,  1577721810442023610ULL },
+    {  9764256642163156992ULL,  1972152263052529513ULL },
+    { 17631875447420442880ULL,  1232595164407830945ULL },
+    {  8204786253993389888ULL,  1540743955509788682ULL },
+    {  1032610780636961552ULL,  1925929944387235853ULL },
+    {  2951224747111794922ULL,  1203706215242022408ULL },
+    {  3689030933889743652ULL,  1504632769052528010ULL },
+    { 13834660704216955373ULL,  1880790961315660012ULL },
+    { 17870034976990372916ULL,  1175494350822287507ULL },
+    { 17725857702810578241ULL,  1469367938527859384ULL },
+    {  3710578054803671186ULL,  1836709923159824231ULL },
+    {    26536550077201078ULL,  2295887403949780289ULL },
+    { 11545800389866720434ULL,  1434929627468612680ULL },
+    { 14432250487333400542ULL,  1793662034335765850ULL },
+    {  8816941072311974870ULL,  2242077542919707313ULL },
+    { 17039803216263454053ULL,  1401298464324817070ULL },
+    { 12076381983474541759ULL,  1751623080406021338ULL },
+    {  5872105442488401391ULL,  2189528850507526673ULL },
+    { 15199280947623720629ULL,  1368455531567204170ULL },
+    {  9775729147674874978ULL,  1710569414459005213ULL },
+    { 16831347453020981627ULL,  2138211768073756516ULL },
+    {  1296220121283337709ULL,  1336382355046097823ULL },
+    { 15455333206886335848ULL,  1670477943807622278ULL },
+    { 10095794471753144002ULL,  2088097429759527848ULL },
+    {  6309871544845715001ULL,  1305060893599704905ULL },
+    { 12499025449484531656ULL,  1631326116999631131ULL },
+    { 11012095793428276666ULL,  2039157646249538914ULL },
+    { 11494245889320060820ULL,  1274473528905961821ULL },
+    {   532749306367912313ULL,  1593091911132452277ULL },
+    {  5277622651387278295ULL,  1991364888915565346ULL },
+    {  7910200175544436838ULL,  1244603055572228341ULL },
+    { 14499436237857933952ULL,  1555753819465285426ULL },
+    {  8900923260467641632ULL,  1944692274331606783ULL },
+    { 12480606065433357876ULL,  1215432671457254239ULL },
+    { 10989071563364309441ULL,  1519290839321567799ULL },
+    {  9124653435777998898ULL,  1899113549151959749ULL },
+    {  8008751406574943263ULL,  1186945968219974843ULL },
+    {  5399253239791291175ULL,  1483682460274968554ULL },
+    { 15972438586593889776ULL,  1854603075343710692ULL },
+    {   759402079766405302ULL,  1159126922089819183ULL },
+    { 14784310654990170340ULL,  1448908652612273978ULL },
+    {  9257016281882937117ULL,  1811135815765342473ULL },
+    { 16182956370781059300ULL,  2263919769706678091ULL },
+    {  7808504722524468110ULL,  1414949856066673807ULL },
+    {  5148944884728197234ULL,  1768687320083342259ULL },
+    {  1824495087482858639ULL,  2210859150104177824ULL },
+    {  1140309429676786649ULL,  1381786968815111140ULL },
+    {  1425386787095983311ULL,  1727233711018888925ULL },
+    {  6393419502297367043ULL,  2159042138773611156ULL },
+    { 13219259225790630210ULL,  1349401336733506972ULL },
+    { 16524074032238287762ULL,  1686751670916883715ULL },
+    { 16043406521870471799ULL,  2108439588646104644ULL },
+    {   803757039314269066ULL,  1317774742903815403ULL },
+    { 14839754354425000045ULL,  1647218428629769253ULL },
+    {  4714634887749086344ULL,  2059023035787211567ULL },
+    {  9864175832484260821ULL,  1286889397367007229ULL },
+    { 16941905809032713930ULL,  1608611746708759036ULL },
+    {  2730638187581340797ULL,  2010764683385948796ULL },
+    { 10930020904093113806ULL,  1256727927116217997ULL },
+    { 18274212148543780162ULL,  1570909908895272496ULL },
+    {  4396021111970173586ULL,  1963637386119090621ULL },
+    {  5053356204195052443ULL,  1227273366324431638ULL },
+    { 15540067292098591362ULL,  1534091707905539547ULL },
+    { 14813398096695851299ULL,  1917614634881924434ULL },
+    { 13870059828862294966ULL,  1198509146801202771ULL },
+    { 12725888767650480803ULL,  1498136433501503464ULL },
+    { 15907360959563101004ULL,  1872670541876879330ULL },
+    { 14553786618154326031ULL,  1170419088673049581ULL },
+    {  4357175217410743827ULL,  1463023860841311977ULL },
+    { 10058155040190817688ULL,  1828779826051639971ULL },
+    {  7961007781811134206ULL,  2285974782564549964ULL },
+    { 14199001900486734687ULL,  1428734239102843727ULL },
+    { 13137066357181030455ULL,  1785917798878554659ULL },
+    { 11809646928048900164ULL,  2232397248598193324ULL },
+    { 16604401366885338411ULL,  1395248280373870827ULL },
+    { 16143815690179285109ULL,  1744060350467338534ULL },
+    { 10956397575869330579ULL,  2180075438084173168ULL },
+    {  6847748484918331612ULL,  1362547148802608230ULL },
+    { 17783057643002690323ULL,  1703183936003260287ULL },
+    { 17617136035325974999ULL,  2128979920004075359ULL },
+    { 17928239049719816230ULL,  1330612450002547099ULL },
+    { 17798612793722382384ULL,  1663265562503183874ULL },
+    { 13024893955298202172ULL,  2079081953128979843ULL },
+    {  5834715712847682405ULL,  1299426220705612402ULL },
+    { 16516766677914378815ULL,  1624282775882015502ULL },
+    { 11422586310538197711ULL,  2030353469852519378ULL },
+    { 11750802462513761473ULL,  1268970918657824611ULL },
+    { 10076817059714813937ULL,  1586213648322280764ULL },
+    { 12596021324643517422ULL,  1982767060402850955ULL },
+    {  5566670318688504437ULL,  1239229412751781847ULL },
+    {  2346651879933242642ULL,  1549036765939727309ULL },
+    {  7545000868343941206ULL,  1936295957424659136ULL },
+    {  4715625542714963254ULL,  1210184973390411960ULL },
+    {  5894531928393704067ULL,  1512731216738014950ULL },
+    { 16591536947346905892ULL,  1890914020922518687ULL },
+    { 17287239619732898039ULL,  1181821263076574179ULL },
+    { 16997363506238734644ULL,  1477276578845717724ULL },
+    {  2799960309088866689ULL,  1846595723557147156ULL },
+    { 10973347230035317489ULL,  1154122327223216972ULL },
+    { 13716684037544146861ULL,  1442652909029021215ULL },
+    { 12534169028502795672ULL,  1803316136286276519ULL },
+    { 11056025267201106687ULL,  2254145170357845649ULL },
+    { 18439230838069161439ULL,  1408840731473653530ULL },
+    { 13825666510731675991ULL,  1761050914342066913ULL },
+    {  3447025083132431277ULL,  2201313642927583642ULL },
+    {  6766076695385157452ULL,  1375821026829739776ULL },
+    {  8457595869231446815ULL,  1719776283537174720ULL },
+    { 10571994836539308519ULL,  2149720354421468400ULL },
+    {  6607496772837067824ULL,  1343575221513417750ULL },
+    { 17482743002901110588ULL,  1679469026891772187ULL },
+    { 17241742735199000331ULL,  2099336283614715234ULL },
+    { 15387775227926763111ULL,  1312085177259197021ULL },
+    {  5399660979626290177ULL,  1640106471573996277ULL },
+    { 11361262242960250625ULL,  2050133089467495346ULL },
+    { 11712474920277544544ULL,  1281333180917184591ULL },
+    { 10028907631919542777ULL,  1601666476146480739ULL },
+    {  7924448521472040567ULL,  2002083095183100924ULL },
+    { 14176152362774801162ULL,  1251301934489438077ULL },
+    {  3885132398186337741ULL,  1564127418111797597ULL },
+    {  9468101516160310080ULL,  1955159272639746996ULL },
+    { 15140935484454969608ULL,  1221974545399841872ULL },
+    {   479425281859160394ULL,  1527468181749802341ULL },
+    {  5210967620751338397ULL,  1909335227187252926ULL },
+    { 17091912818251750210ULL,  1193334516992033078ULL },
+    { 12141518985959911954ULL,  1491668146240041348ULL },
+    { 15176898732449889943ULL,  1864585182800051685ULL },
+    { 11791404716994875166ULL,  1165365739250032303ULL },
+    { 10127569877816206054ULL,  1456707174062540379ULL },
+    {  8047776328842869663ULL,  1820883967578175474ULL },
+    {   836348374198811271ULL,  2276104959472719343ULL },
+    {  7440246761515338900ULL,  1422565599670449589ULL },
+    { 13911994470321561530ULL,  1778206999588061986ULL },
+    {  8166621051047176104ULL,  2222758749485077483ULL },
+    {  2798295147690791113ULL,  1389224218428173427ULL },
+    { 17332926989895652603ULL,  1736530273035216783ULL },
+    { 17054472718942177850ULL,  2170662841294020979ULL },
+    {  8353202440125167204ULL,  1356664275808763112ULL },
+    { 10441503050156459005ULL,  1695830344760953890ULL },
+    {  3828506775840797949ULL,  2119787930951192363ULL },
+    {    86973725686804766ULL,  1324867456844495227ULL },
+    { 13943775212390669669ULL,  1656084321055619033ULL },
+    {  3594660960206173375ULL,  2070105401319523792ULL },
+    {  2246663100128858359ULL,  1293815875824702370ULL },
+    { 12031700912015848757ULL,  1617269844780877962ULL },
+    {  5816254103165035138ULL,  2021587305976097453ULL },
+    {  5941001823691840913ULL,  1263492066235060908ULL },
+    {  7426252279614801142ULL,  1579365082793826135ULL },
+    {  4671129331091113523ULL,  1974206353492282669ULL },
+    {  5225298841145639904ULL,  1233878970932676668ULL },
+    {  6531623551432049880ULL,  1542348713665845835ULL },
+    {  3552843420862674446ULL,  1927935892082307294ULL },
+    { 16055585193321335241ULL,  1204959932551442058ULL },
+    { 10846109454796893243ULL,  1506199915689302573ULL },
+    { 18169322836923504458ULL,  1882749894611628216ULL },
+    { 11355826773077190286ULL,  1176718684132267635ULL },
+    {  9583097447919099954ULL,  1470898355165334544ULL },
+    { 11978871809898874942ULL,  1838622943956668180ULL },
+    { 14973589762373593678ULL,  2298278679945835225ULL },
+    {  2440964573842414192ULL,  1436424174966147016ULL },
+    {  3051205717303017741ULL,  1795530218707683770ULL },
+    { 13037379183483547984ULL,  2244412773384604712ULL },
+    {  8148361989677217490ULL,  1402757983365377945ULL },
+    { 14797138505523909766ULL,  1753447479206722431ULL },
+    { 13884737113477499304ULL,  2191809349008403039ULL },
+    { 15595489723564518921ULL,  1369880843130251899ULL },
+    { 14882676136028260747ULL,  1712351053912814874ULL },
+    {  9379973133180550126ULL,  2140438817391018593ULL },
+    { 17391698254306313589ULL,  1337774260869386620ULL },
+    {  3292878744173340370ULL,  1672217826086733276ULL },
+    {  4116098430216675462ULL,  2090272282608416595ULL },
+    {   266718509671728212ULL,  1306420176630260372ULL },
+    {   333398137089660265ULL,  1633025220787825465ULL },
+    {  5028433689789463235ULL,  2041281525984781831ULL },
+    { 10060300083759496378ULL,  1275800953740488644ULL },
+    { 12575375104699370472ULL,  1594751192175610805ULL },
+    {  1884160825592049379ULL,  1993438990219513507ULL },
+    { 17318501580490888525ULL,  1245899368887195941ULL },
+    {  7813068920331446945ULL,  1557374211108994927ULL },
+    {  5154650131986920777ULL,  1946717763886243659ULL },
+    {   915813323278131534ULL,  1216698602428902287ULL },
+    { 14979824709379828129ULL,  1520873253036127858ULL },
+    {  9501408849870009354ULL,  1901091566295159823ULL },
+    { 12855909558809837702ULL,  1188182228934474889ULL },
+    {  2234828893230133415ULL,  1485227786168093612ULL },
+    {  2793536116537666769ULL,  1856534732710117015ULL },
+    {  8663489100477123587ULL,  1160334207943823134ULL },
+    {  1605989338741628675ULL,  1450417759929778918ULL },
+    { 11230858710281811652ULL,  1813022199912223647ULL },
+    {  9426887369424876662ULL,  2266277749890279559ULL },
+    { 12809333633531629769ULL,  1416423593681424724ULL },
+    { 16011667041914537212ULL,  1770529492101780905ULL },
+    {  6179525747111007803ULL,  2213161865127226132ULL },
+    { 13085575628799155685ULL,  1383226165704516332ULL },
+    { 16356969535998944606ULL,  1729032707130645415ULL },
+    { 15834525901571292854ULL,  2161290883913306769ULL },
+    {  2979049660840976177ULL,  1350806802445816731ULL },
+    { 17558870131333383934ULL,  1688508503057270913ULL },
+    {  8113529608884566205ULL,  2110635628821588642ULL },
+    {  9682642023980241782ULL,  1319147268013492901ULL },
+    { 16714988548402690132ULL,  1648934085016866126ULL },
+    { 11670363648648586857ULL,  2061167606271082658ULL },
+    { 11905663298832754689ULL,  1288229753919426661ULL },
+    {  1047021068258779650ULL,  1610287192399283327ULL },
+    { 15143834390605638274ULL,  2012858990499104158ULL },
+    {  4853210475701136017ULL,  1258036869061940099ULL },
+    {  1454827076199032118ULL,  1572546086327425124ULL },
+    {  1818533845248790147ULL,  1965682607909281405ULL },
+    {  3442426662494187794ULL,  1228551629943300878ULL },
+    { 13526405364972510550ULL,  1535689537429126097ULL },
+    {  3072948650933474476ULL,  1919611921786407622ULL },
+    { 15755650962115585259ULL,  1199757451116504763ULL },
+    { 15082877684217093670ULL,  1499696813895630954ULL },
+    {  9630225068416591280ULL,  1874621017369538693ULL },
+    {  8324733676974063502ULL,  1171638135855961683ULL },
+    {  5794231077790191473ULL,  1464547669819952104ULL },
+    {  7242788847237739342ULL,  1830684587274940130ULL },
+    { 18276858095901949986ULL,  2288355734093675162ULL },
+    { 16034722328366106645ULL,  1430222333808546976ULL },
+    {  1596658836748081690ULL,  1787777917260683721ULL },
+    {  6607509564362490017ULL,  2234722396575854651ULL },
+    {  1823850468512862308ULL,  1396701497859909157ULL },
+    {  6891499104068465790ULL,  1745876872324886446ULL },
+    { 17837745916940358045ULL,  2182346090406108057ULL },
+    {  4231062170446641922ULL,  1363966306503817536ULL },
+    {  5288827713058302403ULL,  1704957883129771920ULL },
+    {  6611034641322878003ULL,  2131197353912214900ULL },
+    { 13355268687681574560ULL,  1331998346195134312ULL },
+    { 16694085859601968200ULL,  1664997932743917890ULL },
+    { 11644235287647684442ULL,  2081247415929897363ULL },
+    {  4971804045566108824ULL,  1300779634956185852ULL },
+    {  6214755056957636030ULL,  1625974543695232315ULL },
+    {  3156757802769657134ULL,  2032468179619040394ULL },
+    {  6584659645158423613ULL,  1270292612261900246ULL },
+    { 17454196593302805324ULL,  1587865765327375307ULL },
+    { 17206059723201118751ULL,  1984832206659219134ULL },
+    {  6142101308573311315ULL,  1240520129162011959ULL },
+    {  3065940617289251240ULL,  1550650161452514949ULL },
+    {  8444111790038951954ULL,  1938312701815643686ULL },
+    {   665883850346957067ULL,  1211445438634777304ULL },
+    {   832354812933696334ULL,  1514306798293471630ULL },
+    { 10263815553021896226ULL,  1892883497866839537ULL },
+    { 17944099766707154901ULL,  1183052186166774710ULL },
+    { 13206752671529167818ULL,  1478815232708468388ULL },
+    { 16508440839411459773ULL,  1848519040885585485ULL },
+    { 12623618533845856310ULL,  1155324400553490928ULL },
+    { 15779523167307320387ULL,  1444155500691863660ULL },
+    {  1277659885424598868ULL,  1805194375864829576ULL },
+    {  1597074856780748586ULL,  2256492969831036970ULL },
+    {  5609857803915355770ULL,  1410308106144398106ULL },
+    { 16235694291748970521ULL,  1762885132680497632ULL },
+    {  1847873790976661535ULL,  2203606415850622041ULL },
+    { 12684136165428883219ULL,  1377254009906638775ULL },
+    { 11243484188358716120ULL,  1721567512383298469ULL },
+    {   219297180166231438ULL,  2151959390479123087ULL },
+    {  7054589765244976505ULL,  1344974619049451929ULL },
+    { 13429923224983608535ULL,  1681218273811814911ULL },
+    { 12175718012802122765ULL,  2101522842264768639ULL },
+    { 14527352785642408584ULL,  1313451776415480399ULL },
+    { 13547504963625622826ULL,  1641814720519350499ULL },
+    { 12322695186104640628ULL,  2052268400649188124ULL },
+    { 16925056528170176201ULL,  1282667750405742577ULL },
+    {  7321262604930556539ULL,  1603334688007178222ULL },
+    { 18374950293017971482ULL,  2004168360008972777ULL },
+    {  4566814905495150320ULL,  1252605225005607986ULL },
+    { 14931890668723713708ULL,  1565756531257009982ULL },
+    {  9441491299049866327ULL,  1957195664071262478ULL },
+    {  1289246043478778550ULL,  1223247290044539049ULL },
+    {  6223243572775861092ULL,  1529059112555673811ULL },
+    {  3167368447542438461ULL,  1911323890694592264ULL },
+    {  1979605279714024038ULL,  1194577431684120165ULL },
+    {  7086192618069917952ULL,  1493221789605150206ULL },
+    { 18081112809442173248ULL,  1866527237006437757ULL },
+    { 13606538515115052232ULL,  1166579523129023598ULL },
+    {  7784801107039039482ULL,  1458224403911279498ULL },
+    {   507629346944023544ULL,  1822780504889099373ULL },
+    {  5246222702107417334ULL,  2278475631111374216ULL },
+    {  3278889188817135834ULL,  1424047269444608885ULL },
+    {  8710297504448807696ULL,  1780059086805761106ULL },
+};
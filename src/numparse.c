@@ -0,0 +1,311 @@
+/*
+ *  Name: numparse.c
+ *  Description: Locale independent number parsing
+ *
+ *  Copyright (C) 2012  Jason Hall
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Numbers of up to 19 significant digits, which is everything the entry
+ * boxes and numfmt.c produce, are converted with the Eisel-Lemire method
+ * (Daniel Lemire, "Number Parsing at a Gigabyte per Second", 2021): the
+ * digits are multiplied by a 128 bit approximation of the power of ten
+ * and the top 53 bits are the answer unless they sit too close to a
+ * rounding boundary to tell. Those rare cases, longer inputs that the
+ * truncated digits leave ambiguous, denormals and overflow go to
+ * g_ascii_strtod(), which is exact and also ignores the locale.
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <glib.h>
+
+#include "numparse.h"
+#include "numparse_table.h"
+
+#define DOUBLE_MANTISSA_BITS	52
+#define DOUBLE_BIAS		1023
+#define DOUBLE_INFINITY		0x7ff0000000000000ULL
+#define DOUBLE_NAN		0x7ff8000000000000ULL
+#define MAX_DIGITS		19	/* 10^19 - 1 still fits 64 bits */
+#define FALLBACK_BUFFER		64
+
+/* the 128 bit product a * b */
+static inline void
+mul64(uint64_t a, uint64_t b, uint64_t *hi, uint64_t *lo)
+{
+#ifdef __SIZEOF_INT128__
+    unsigned __int128 r = (unsigned __int128) a * b;
+
+    *hi = (uint64_t) (r >> 64);
+    *lo = (uint64_t) r;
+#else
+    // the same with 32 bit halves
+    uint64_t a_lo = (uint32_t) a, a_hi = a >> 32;
+    uint64_t b_lo = (uint32_t) b, b_hi = b >> 32;
+    uint64_t ll = a_lo * b_lo, lh = a_lo * b_hi;
+    uint64_t hl = a_hi * b_lo, hh = a_hi * b_hi;
+    uint64_t mid = (ll >> 32) + (uint32_t) lh + (uint32_t) hl;
+
+    *hi = hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+    *lo = (mid << 32) | (uint32_t) ll;
+#endif
+}
+
+static inline int
+leading_zeros(uint64_t v)
+{
+#ifdef __GNUC__
+    return __builtin_clzll(v);
+#else
+    int n = 0;
+
+    while (!(v & (1ULL << 63))) {
+	v <<= 1;
+	n++;
+    }
+    return n;
+#endif
+}
+
+/*
+ * A double from its sign and the bits after it. Built by hand, since
+ * -ffast-math lets the compiler drop the sign of zero and nan.
+ */
+static inline double
+make_double(gboolean neg, uint64_t bits)
+{
+    double v;
+
+    if (neg)
+	bits |= 1ULL << 63;
+    memcpy(&v, &bits, sizeof(v));
+    return v;
+}
+
+/*
+ * man * 10^exp10 correctly rounded, for man != 0. Returns FALSE if the
+ * result can't be decided this way or is denormal or out of range.
+ */
+static gboolean
+eisel_lemire(uint64_t man, long exp10, gboolean neg, double *v)
+{
+    const uint64_t *pow10;
+    uint64_t hi, lo, y_hi, y_lo, merged_hi, merged_lo, mantissa, exp2, bits;
+    uint64_t msb;
+    int clz;
+
+    if (exp10 < POW10_MIN || exp10 > POW10_MAX)
+	return FALSE;
+    pow10 = pow10_split[exp10 - POW10_MIN];
+
+    clz = leading_zeros(man);
+    man <<= clz;
+    // 217706 / 2^16 is log2(10)
+    exp2 = (uint64_t) (((217706 * exp10) >> 16) + 64 + DOUBLE_BIAS - clz);
+
+    mul64(man, pow10[1], &hi, &lo);
+
+    // when the bits below the mantissa are all ones the low half of the
+    // power may still carry into them
+    if ((hi & 0x1ff) == 0x1ff && lo + man < man) {
+	mul64(man, pow10[0], &y_hi, &y_lo);
+	merged_hi = hi;
+	merged_lo = lo + y_hi;
+	if (merged_lo < lo)
+	    merged_hi++;
+	if ((merged_hi & 0x1ff) == 0x1ff && merged_lo + 1 == 0 &&
+		y_lo + man < man)
+	    return FALSE;
+	hi = merged_hi;
+	lo = merged_lo;
+    }
+
+    // keep 54 bits, one more than the mantissa for rounding
+    msb = hi >> 63;
+    mantissa = hi >> (msb + 9);
+    exp2 -= 1 ^ msb;
+
+    // exactly halfway between two doubles, or too close to know
+    if (lo == 0 && (hi & 0x1ff) == 0 && (mantissa & 3) == 1)
+	return FALSE;
+
+    mantissa += mantissa & 1;
+    mantissa >>= 1;
+    if (mantissa >> (DOUBLE_MANTISSA_BITS + 1)) {
+	mantissa >>= 1;
+	exp2++;
+    }
+
+    // zero (wrapped around) is denormal, 0x7ff and up is infinity
+    if (exp2 - 1 >= 0x7ff - 1)
+	return FALSE;
+
+    bits = exp2 << DOUBLE_MANTISSA_BITS |
+	(mantissa & ((1ULL << DOUBLE_MANTISSA_BITS) - 1));
+    *v = make_double(neg, bits);
+    return TRUE;
+}
+
+/* the slow exact path for the text from s to end */
+static double
+fallback(const char *s, const char *end)
+{
+    char buf[FALLBACK_BUFFER], *copy;
+    size_t len = end - s;
+    double v;
+
+    // copy so g_ascii_strtod() can't read past what was accepted,
+    // like the hex digits of "0x1p3"
+    if (len < sizeof(buf)) {
+	memcpy(buf, s, len);
+	buf[len] = '\0';
+	return g_ascii_strtod(buf, NULL);
+    }
+
+    copy = g_strndup(s, len);
+    v = g_ascii_strtod(copy, NULL);
+    g_free(copy);
+    return v;
+}
+
+/* inf, infinity or nan after the sign, in any case */
+static const char *
+parse_special(const char *p, gboolean neg, double *v)
+{
+    if (g_ascii_strncasecmp(p, "inf", 3) == 0) {
+	*v = make_double(neg, DOUBLE_INFINITY);
+	if (g_ascii_strncasecmp(p + 3, "inity", 5) == 0)
+	    return p + 8;
+	return p + 3;
+    }
+    if (g_ascii_strncasecmp(p, "nan", 3) == 0) {
+	*v = make_double(neg, DOUBLE_NAN);
+	return p + 3;
+    }
+    return NULL;
+}
+
+/*
+ * Parse the number at s into *v. Returns the end of the number, or NULL
+ * if s doesn't start with one, leaving *v alone.
+ */
+const char *
+numparse_double(const char *s, double *v)
+{
+    const char *p = s, *start, *e;
+    uint64_t man = 0;
+    long exp10 = 0, exp_part;
+    int ndigits = 0, any = 0, point = 0, truncated = 0, d;
+    gboolean neg = FALSE, exp_neg;
+    double r1;
+
+    while (g_ascii_isspace(*p))
+	p++;
+    start = p;
+    if (*p == '+' || *p == '-')
+	neg = *p++ == '-';
+
+    for (;; p++) {
+	if (*p >= '0' && *p <= '9') {
+	    d = *p - '0';
+	    any = 1;
+	    if (ndigits < MAX_DIGITS) {
+		man = man * 10 + d;
+		// leading zeros don't use up digits
+		if (man != 0)
+		    ndigits++;
+		if (point)
+		    exp10--;
+	    } else {
+		truncated |= d != 0;
+		if (!point)
+		    exp10++;
+	    }
+	} else if (*p == '.' && !point) {
+	    point = 1;
+	} else {
+	    break;
+	}
+    }
+    if (!any)
+	return parse_special(start + (start[0] == '+' || start[0] == '-'),
+		neg, v);
+
+    if (*p == 'e' || *p == 'E') {
+	e = p + 1;
+	exp_neg = *e == '-';
+	if (*e == '+' || *e == '-')
+	    e++;
+	if (*e >= '0' && *e <= '9') {
+	    exp_part = 0;
+	    for (; *e >= '0' && *e <= '9'; e++) {
+		// far beyond any double, but no overflow
+		if (exp_part < 100000)
+		    exp_part = exp_part * 10 + (*e - '0');
+	    }
+	    exp10 += exp_neg ? -exp_part : exp_part;
+	    p = e;
+	}
+    }
+
+    if (man == 0) {
+	*v = make_double(neg, 0);
+	return p;
+    }
+
+    // with digits dropped the value lies between man and man + 1, which
+    // is good enough if both round the same way
+    if (eisel_lemire(man, exp10, neg, v) &&
+	    (!truncated || (eisel_lemire(man + 1, exp10, neg, &r1) && r1 == *v)))
+	return p;
+
+    *v = fallback(start, p);
+    return p;
+}
+
+/*
+ * Parse up to n numbers into v. Returns how many were read. *end, if not
+ * NULL, is set past the last number and the white space after it, so it
+ * points at the '\0' when the whole string was numbers and at whatever
+ * could not be parsed otherwise. A comma left dangling is not consumed.
+ */
+size_t
+numparse_array(const char *s, double *v, size_t n, const char **end)
+{
+    const char *p = s, *next;
+    size_t i;
+
+    for (i = 0; i < n; i++) {
+	next = p;
+	if (i > 0) {
+	    while (g_ascii_isspace(*next))
+		next++;
+	    if (*next == ',')
+		next++;
+	}
+	next = numparse_double(next, &v[i]);
+	if (next == NULL)
+	    break;
+	p = next;
+    }
+
+    while (g_ascii_isspace(*p))
+	p++;
+    if (end != NULL)
+	*end = p;
+    return i;
+}
@@ -0,0 +1,47 @@
+/*
+ *  Name: numparse.h
+ *  Description: Locale independent number parsing
+ *
+ *  Copyright (C) 2012  Jason Hall
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NUMPARSE_H
+#define NUMPARSE_H
+
+#include <stddef.h>
+
+/*
+ * Decimal numbers are read the same way in every locale: an optional
+ * sign, digits with an optional '.' fraction and an optional e or E
+ * exponent, or inf, infinity or nan in any case. Leading white space is
+ * skipped. The result is the correctly rounded double, like strtod() in
+ * the C locale.
+ */
+
+const char *numparse_double(const char *s, double *v);
+
+/*
+ * numparse_array() reads numbers separated by white space and/or a comma,
+ * which covers both hand typed and CSV input. vec3_t, quat_t and mat4x4_t
+ * arrays are plain arrays of real, so
+ *
+ *	numparse_array(text, (real *) vectors, 3 * n, &end)
+ *
+ * fills n vectors straight from text.
+ */
+size_t numparse_array(const char *s, double *v, size_t n, const char **end);
+
+#endif /* NUMPARSE_H */
@@ -0,0 +1,257 @@
+/*
+ *  Name: numparse_check.c
+ *  Description: Checks for the number parsing (make check)
+ *
+ *  Copyright (C) 2012  Jason Hall
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Parses random and edge case numbers with numparse_double() and
+ * g_ascii_strtod(), which must agree bit for bit and on where the number
+ * ends, checks that non-numbers give NULL and that numparse_array()
+ * splits on commas and white space and stops where it should:
+ *
+ *	numparse_check
+ *
+ * Exits with 1 if any check failed.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+
+#include <glib.h>
+
+#include "numparse.h"
+
+/* random numbers of each kind */
+#define CHECK_RANDOM	100000
+
+/* what *v is set to beforehand, to see it left alone */
+#define UNTOUCHED	12345.0
+
+static int failures;
+
+static void
+check(gboolean ok, const char *what)
+{
+    printf("%-48s %s\n", what, ok ? "ok" : "FAILED");
+    if (!ok)
+	failures++;
+}
+
+/* compared as bits, -ffast-math may not keep -0 and nan apart otherwise */
+static uint64_t
+to_bits(double v)
+{
+    uint64_t bits;
+
+    memcpy(&bits, &v, sizeof(bits));
+    return bits;
+}
+
+/*
+ * numparse_double() reads s the same as g_ascii_strtod() and ends in the
+ * same place. Prints the first few that don't.
+ */
+static gboolean
+agrees(const char *s)
+{
+    static int reported;
+    const char *end;
+    char *ref_end;
+    double v, ref;
+
+    end = numparse_double(s, &v);
+    ref = g_ascii_strtod(s, &ref_end);
+    if (end != NULL && end == ref_end && to_bits(v) == to_bits(ref))
+	return TRUE;
+
+    if (reported++ < 10)
+	printf("  \"%s\" read as %.17g (0x%016llx), not %.17g\n", s,
+		end != NULL ? v : 0.0, (unsigned long long) to_bits(v), ref);
+    return FALSE;
+}
+
+/*
+ * The ones the fast path has to hand over: exact ties, more digits than
+ * fit in 64 bits, denormals, overflow and underflow.
+ */
+static void
+check_edges(void)
+{
+    static const char *edges[] = {
+	"0", "-0", "0.0", "000.000e5", "1", "-1", "0.1", "0.3", "1e23",
+	"  42", "\t\n-7.5", "+3", ".5", "5.", "1e", "1e+", "2e-", "3.e2",
+	"1.7976931348623157e308", "-1.7976931348623157e308",
+	"2.2250738585072014e-308", "123456789012345678",
+	"12345678901234567890", "1234567890123456789012345678901234567890",
+	"1E+300", "1e-300", "7.038531e-26", "1.5e-3junk",
+	"infinity", "-Inf", "INFx", "nan", "-NaN", "+inf",
+	NULL
+    };
+    static const char *fallbacks[] = {
+	// halfway between two doubles, ties to even either way
+	"9007199254740993", "9007199254740995", "-9007199254740993e10",
+	"1.00000000000000011102230246251565404236316680908203125",
+	"1.00000000000000011102230246251565404236316680908203124",
+	"1.00000000000000011102230246251565404236316680908203126",
+	// 20 digits and more, the dropped ones decide the rounding
+	"90071992547409930000000000000000000000000000000000001e-37",
+	"0.1000000000000000055511151231257827021181583404541015625",
+	"3.141592653589793238462643383279502884197169399375105820974944",
+	// denormals, the smallest, the largest and a tie between
+	"4.9406564584124654e-324", "5e-324", "2.4703282292062328e-324",
+	"2.4703282292062327e-324", "2.2250738585072009e-308",
+	"2.2250738585072011e-308", "1e-310", "-3e-320",
+	// out of range
+	"1.7976931348623158e308", "1.7976931348623159e308", "1e309",
+	"-1e400", "1e-400", "-1e-324", "1e99999999999999999",
+	NULL
+    };
+    gboolean ok;
+    int i;
+
+    ok = TRUE;
+    for (i = 0; edges[i] != NULL; i++)
+	ok &= agrees(edges[i]);
+    check(ok, "edge values");
+
+    ok = TRUE;
+    for (i = 0; fallbacks[i] != NULL; i++)
+	ok &= agrees(fallbacks[i]);
+    check(ok, "the g_ascii_strtod() fallback cases");
+}
+
+/* rand() is never seeded, so every run checks the same numbers */
+static void
+check_random(void)
+{
+    char buf[64];
+    gboolean ok;
+    double v;
+    int i, j, len;
+
+    // what the entry boxes and %g give
+    ok = TRUE;
+    for (i = 0; i < CHECK_RANDOM; i++) {
+	v = (rand() / (double) RAND_MAX - 0.5) * pow(10, rand() % 40 - 20);
+	snprintf(buf, sizeof(buf), "%.*g", 1 + rand() % 17, v);
+	ok &= agrees(buf);
+    }
+    check(ok, "random values, 1 to 17 digits");
+
+    // any digits with any exponent, up to 25 digits so some are cut
+    ok = TRUE;
+    for (i = 0; i < CHECK_RANDOM; i++) {
+	len = 1 + rand() % 25;
+	for (j = 0; j < len; j++)
+	    buf[j] = '0' + rand() % 10;
+	snprintf(buf + len, sizeof(buf) - len, "e%d", rand() % 700 - 350);
+	ok &= agrees(buf);
+    }
+    check(ok, "random digits and exponents");
+}
+
+/* nothing that starts with a number gives NULL and leaves *v alone */
+static void
+check_not_numbers(void)
+{
+    static const char *bad[] = {
+	"", " ", "abc", "-", "+", ".", "-.", "e5", ".e1", "+-1", "in", "na",
+	"- 1", ",1", "x1", "\t",
+	NULL
+    };
+    gboolean ok = TRUE;
+    double v;
+    int i;
+
+    for (i = 0; bad[i] != NULL; i++) {
+	v = UNTOUCHED;
+	ok &= numparse_double(bad[i], &v) == NULL && v == UNTOUCHED;
+    }
+    check(ok, "not numbers give NULL");
+}
+
+/* s parsed into at most n gives count numbers of 1 to count, ends at rest */
+static gboolean
+array_is(const char *s, size_t n, size_t count, const char *rest)
+{
+    double v[8];
+    const char *end;
+    size_t got, i;
+    gboolean ok;
+
+    for (i = 0; i < G_N_ELEMENTS(v); i++)
+	v[i] = UNTOUCHED;
+
+    got = numparse_array(s, v, n, &end);
+    ok = got == count && strcmp(end, rest) == 0;
+    for (i = 0; i < count; i++)
+	ok &= v[i] == i + 1;
+    for (; i < G_N_ELEMENTS(v); i++)
+	ok &= v[i] == UNTOUCHED;
+
+    if (!ok)
+	printf("  \"%s\" gave %d numbers, stopped at \"%s\"\n", s, (int) got,
+		end);
+    return ok;
+}
+
+static void
+check_array(void)
+{
+    check(array_is("1 2 3", 8, 3, "") &&
+	  array_is("1,2,3", 8, 3, "") &&
+	  array_is(" 1 , 2,\t3\n,4 ,5  ", 8, 5, "") &&
+	  array_is("1\n2\r\n3", 8, 3, ""),
+	  "numparse_array separators");
+
+    check(array_is("1 2 3 abc", 8, 3, "abc") &&
+	  array_is("1,2, x", 8, 2, ", x") &&
+	  array_is("1,2,", 8, 2, ",") &&
+	  array_is("1,,2", 8, 1, ",,2") &&
+	  array_is(",1", 8, 0, ",1") &&
+	  array_is("1 2e", 8, 2, "e") &&
+	  array_is("", 8, 0, ""),
+	  "numparse_array trailing garbage");
+
+    check(array_is("1 2 3 4 5", 3, 3, "4 5") &&
+	  array_is("1,2,3,4", 3, 3, ",4") &&
+	  array_is("1 2", 0, 0, "1 2") &&
+	  array_is("  1", 0, 0, "1"),
+	  "numparse_array more numbers than room");
+
+    check(numparse_array("1 2 3", NULL, 0, NULL) == 0,
+	  "numparse_array no end pointer");
+}
+
+int
+main(int argc, char **argv)
+{
+    check_edges();
+    check_random();
+    check_not_numbers();
+    check_array();
+
+    if (failures > 0) {
+	printf("%d checks FAILED\n", failures);
+	return 1;
+    }
+    return 0;
+}
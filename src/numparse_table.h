@@ -0,0 +1,726 @@
+/*
+ *  Name: numparse_table.h
+ *  Description: Powers of 10 for numparse.c, generated, do not edit
+ *
+ *  Copyright (C) 2012  Jason Hall
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * pow10_split[e - POW10_MIN] is 10^e scaled by a power of 2 to exactly 128
+ * significant bits and rounded down, split into its low and high 64 bits.
+ */
+
+#define POW10_MIN		(-348)
+#define POW10_MAX		347
+
+static const uint64_t pow10_split[POW10_MAX - POW10_MIN + 1][2] = {
+    {  1671618768450675795ULL, 18054884314459144840ULL },
+    {  1044761730281672372ULL, 11284302696536965525ULL },
+    {  5917638181279478369ULL, 14105378370671206906ULL },
+    { 16620419763454123769ULL, 17631722963339008632ULL },
+    { 10387762352158827356ULL, 11019826852086880395ULL },
+    {  8373016921771146291ULL, 13774783565108600494ULL },
+    {  1242899115359157055ULL, 17218479456385750618ULL },
+    {  5388497965526861063ULL, 10761549660241094136ULL },
+    {  6735622456908576329ULL, 13451937075301367670ULL },
+    { 17642900107990496220ULL, 16814921344126709587ULL },
+    {  8720969558280366185ULL, 10509325840079193492ULL },
+    { 10901211947850457732ULL, 13136657300098991865ULL },
+    { 18238200953240460069ULL, 16420821625123739831ULL },
+    { 18316404623416369399ULL, 10263013515702337394ULL },
+    { 13672133742415685941ULL, 12828766894627921743ULL },
+    { 12478481159592219522ULL, 16035958618284902179ULL },
+    {  5493207715531443249ULL, 10022474136428063862ULL },
+    { 16089881681269079869ULL, 12528092670535079827ULL },
+    { 15500666083158961933ULL, 15660115838168849784ULL },
+    {  9687916301974351208ULL,  9787572398855531115ULL },
+    {  7498209359040551106ULL, 12234465498569413894ULL },
+    {   149389661945913074ULL, 15293081873211767368ULL },
+    {    93368538716195671ULL,  9558176170757354605ULL },
+    {  4728396691822632493ULL, 11947720213446693256ULL },
+    {  5910495864778290617ULL, 14934650266808366570ULL },
+    {  8305745933913819539ULL,  9334156416755229106ULL },
+    {  1158810380537498616ULL, 11667695520944036383ULL },
+    { 15283571030954036982ULL, 14584619401180045478ULL },
+    {  9881091751837770420ULL, 18230774251475056848ULL },
+    {  6175682344898606512ULL, 11394233907171910530ULL },
+    { 16942974967978033949ULL, 14242792383964888162ULL },
+    { 11955346673117766628ULL, 17803490479956110203ULL },
+    {  5166248661484910190ULL, 11127181549972568877ULL },
+    { 11069496845283525642ULL, 13908976937465711096ULL },
+    { 13836871056604407053ULL, 17386221171832138870ULL },
+    {  4036358391950366504ULL, 10866388232395086794ULL },
+    { 14268820026792733938ULL, 13582985290493858492ULL },
+    { 17836025033490917422ULL, 16978731613117323115ULL },
+    {  8841672636718129437ULL, 10611707258198326947ULL },
+    {  6440404777470273892ULL, 13264634072747908684ULL },
+    {  8050505971837842365ULL, 16580792590934885855ULL },
+    { 11949095260039733334ULL, 10362995369334303659ULL },
+    { 10324683056622278764ULL, 12953744211667879574ULL },
+    {  3682481783923072647ULL, 16192180264584849468ULL },
+    { 11524923151806696212ULL, 10120112665365530917ULL },
+    {   571095884476206553ULL, 12650140831706913647ULL },
+    { 14548927910877421904ULL, 15812676039633642058ULL },
+    { 13704765962725776594ULL,  9882922524771026286ULL },
+    {  7907585416552444934ULL, 12353653155963782858ULL },
+    {   661109733835780360ULL, 15442066444954728573ULL },
+    {  2719036592861056677ULL,  9651291528096705358ULL },
+    { 12622167777931096654ULL, 12064114410120881697ULL },
+    {  1942651667131707105ULL, 15080143012651102122ULL },
+    {  5825843310384704845ULL,  9425089382906938826ULL },
+    { 16505676174835656864ULL, 11781361728633673532ULL },
+    {  2185351144835019464ULL, 14726702160792091916ULL },
+    {  2731688931043774330ULL, 18408377700990114895ULL },
+    {  8624834609543440812ULL, 11505236063118821809ULL },
+    { 15392729280356688919ULL, 14381545078898527261ULL },
+    {  5405853545163697437ULL, 17976931348623159077ULL },
+    {  5684501474941004850ULL, 11235582092889474423ULL },
+    {  2493940825248868159ULL, 14044477616111843029ULL },
+    {  7729112049988473103ULL, 17555597020139803786ULL },
+    {  9442381049670183593ULL, 10972248137587377366ULL },
+    {  2579604275232953683ULL, 13715310171984221708ULL },
+    {  3224505344041192104ULL, 17144137714980277135ULL },
+    {  8932844867666826921ULL, 10715086071862673209ULL },
+    { 15777742103010921555ULL, 13393857589828341511ULL },
+    { 15110491610336264040ULL, 16742321987285426889ULL },
+    {  2526528228819083169ULL, 10463951242053391806ULL },
+    { 12381532322878629770ULL, 13079939052566739757ULL },
+    {  1641857348316123500ULL, 16349923815708424697ULL },
+    { 12555375888766046947ULL, 10218702384817765435ULL },
+    { 11082533842530170780ULL, 12773377981022206794ULL },
+    {  4629795266307937667ULL, 15966722476277758493ULL },
+    {  5199465050656154994ULL,  9979201547673599058ULL },
+    { 15722703350174969551ULL, 12474001934591998822ULL },
+    { 10430007150863936130ULL, 15592502418239998528ULL },
+    {  6518754469289960081ULL,  9745314011399999080ULL },
+    {  8148443086612450102ULL, 12181642514249998850ULL },
+    {   962181821410786819ULL, 15227053142812498563ULL },
+    { 16742264702877599426ULL,  9516908214257811601ULL },
+    {  7092772823314835570ULL, 11896135267822264502ULL },
+    { 18089338065998320271ULL, 14870169084777830627ULL },
+    {  8999993282035256217ULL,  9293855677986144142ULL },
+    {  2026619565689294464ULL, 11617319597482680178ULL },
+    { 11756646493966393888ULL, 14521649496853350222ULL },
+    {  5472436080603216552ULL, 18152061871066687778ULL },
+    {  8031958568804398249ULL, 11345038669416679861ULL },
+    { 14651634229432885715ULL, 14181298336770849826ULL },
+    {  9091170749936331336ULL, 17726622920963562283ULL },
+    {  3376138709496513133ULL, 11079139325602226427ULL },
+    { 18055231442152805128ULL, 13848924157002783033ULL },
+    {  8733981247408842698ULL, 17311155196253478792ULL },
+    {  5458738279630526686ULL, 10819471997658424245ULL },
+    { 11435108867965546262ULL, 13524339997073030306ULL },
+    {  5070514048102157020ULL, 16905424996341287883ULL },
+    {   863228270850154185ULL, 10565890622713304927ULL },
+    { 14914093393844856443ULL, 13207363278391631158ULL },
+    {  9419244705451294746ULL, 16509204097989538948ULL },
+    { 15110399977761835024ULL, 10318252561243461842ULL },
+    {  9664627935347517973ULL, 12897815701554327303ULL },
+    {  7469098900757009562ULL, 16122269626942909129ULL },
+    { 16197401859041600736ULL, 10076418516839318205ULL },
+    {  6411694268519837208ULL, 12595523146049147757ULL },
+    { 12626303854077184414ULL, 15744403932561434696ULL },
+    {  7891439908798240259ULL,  9840252457850896685ULL },
+    { 14475985904425188227ULL, 12300315572313620856ULL },
+    { 18094982380531485284ULL, 15375394465392026070ULL },
+    {  6697677969404790399ULL,  9609621540870016294ULL },
+    { 17595469498610763806ULL, 12012026926087520367ULL },
+    { 17382650854836066854ULL, 15015033657609400459ULL },
+    {  8558313775058847832ULL,  9384396036005875287ULL },
+    {  6086206200396171886ULL, 11730495045007344109ULL },
+    { 12219443768922602761ULL, 14663118806259180136ULL },
+    { 15274304711153253452ULL, 18328898507823975170ULL },
+    { 14158126462898171311ULL, 11455561567389984481ULL },
+    {  3862600023340550427ULL, 14319451959237480602ULL },
+    { 14051622066030463842ULL, 17899314949046850752ULL },
+    {  8782263791269039901ULL, 11187071843154281720ULL },
+    { 10977829739086299876ULL, 13983839803942852150ULL },
+    {  4498915137003099037ULL, 17479799754928565188ULL },
+    { 12035193997481712706ULL, 10924874846830353242ULL },
+    {  5820620459997365075ULL, 13656093558537941553ULL },
+    { 11887461593424094248ULL, 17070116948172426941ULL },
+    {  9735506505103752857ULL, 10668823092607766838ULL },
+    {  2946011094524915263ULL, 13336028865759708548ULL },
+    {  3682513868156144079ULL, 16670036082199635685ULL },
+    {  4607414176811284001ULL, 10418772551374772303ULL },
+    {  1147581702586717097ULL, 13023465689218465379ULL },
+    { 15269535183515560084ULL, 16279332111523081723ULL },
+    {  7237616480483531100ULL, 10174582569701926077ULL },
+    { 13658706619031801779ULL, 12718228212127407596ULL },
+    { 17073383273789752224ULL, 15897785265159259495ULL },
+    { 17588393573759676996ULL,  9936115790724537184ULL },
+    {  3538747893490044629ULL, 12420144738405671481ULL },
+    {  9035120885289943691ULL, 15525180923007089351ULL },
+    { 12564479580947296663ULL,  9703238076879430844ULL },
+    { 15705599476184120828ULL, 12129047596099288555ULL },
+    { 15020313326802763131ULL, 15161309495124110694ULL },
+    {  4776009810824339053ULL,  9475818434452569184ULL },
+    {  5970012263530423816ULL, 11844773043065711480ULL },
+    {  7462515329413029771ULL, 14805966303832139350ULL },
+    {    52386062455755702ULL,  9253728939895087094ULL },
+    {  9288854614924470436ULL, 11567161174868858867ULL },
+    {  6999382250228200141ULL, 14458951468586073584ULL },
+    {  8749227812785250177ULL, 18073689335732591980ULL },
+    { 14691639419845557168ULL, 11296055834832869987ULL },
+    { 13752863256379558556ULL, 14120069793541087484ULL },
+    { 17191079070474448196ULL, 17650087241926359355ULL },
+    {  8438581409832836170ULL, 11031304526203974597ULL },
+    { 15159912780718433117ULL, 13789130657754968246ULL },
+    {  9726518939043265588ULL, 17236413322193710308ULL },
+    { 15302446373756816800ULL, 10772758326371068942ULL },
+    {  9904685930341245193ULL, 13465947907963836178ULL },
+    {  3157485376071780683ULL, 16832434884954795223ULL },
+    {  8890957387685944783ULL, 10520271803096747014ULL },
+    {  1890324697752655170ULL, 13150339753870933768ULL },
+    {  2362905872190818963ULL, 16437924692338667210ULL },
+    {  6088502188546649756ULL, 10273702932711667006ULL },
+    { 16833999772538088003ULL, 12842128665889583757ULL },
+    {  7207441660390446292ULL, 16052660832361979697ULL },
+    { 16033866083812498692ULL, 10032913020226237310ULL },
+    { 10818960567910847557ULL, 12541141275282796638ULL },
+    {  4300328673033783639ULL, 15676426594103495798ULL },
+    { 16522763475928278486ULL,  9797766621314684873ULL },
+    {  6818396289628184396ULL, 12247208276643356092ULL },
+    {  8522995362035230495ULL, 15309010345804195115ULL },
+    {  3021029092058325107ULL,  9568131466127621947ULL },
+    { 17611344420355070096ULL, 11960164332659527433ULL },
+    {  8179122470161673908ULL, 14950205415824409292ULL },
+    { 14335323580705822000ULL,  9343878384890255807ULL },
+    { 13307468457454889596ULL, 11679847981112819759ULL },
+    { 12022649553391224092ULL, 14599809976391024699ULL },
+    { 10416625923311642211ULL, 18249762470488780874ULL },
+    { 11122077220497164286ULL, 11406101544055488046ULL },
+    {  4679224488766679549ULL, 14257626930069360058ULL },
+    { 15072402647813125244ULL, 17822033662586700072ULL },
+    {  9420251654883203278ULL, 11138771039116687545ULL },
+    { 16387000587031392001ULL, 13923463798895859431ULL },
+    { 15872064715361852097ULL, 17404329748619824289ULL },
+    {  3002511419460075705ULL, 10877706092887390181ULL },
+    {  8364825292752482535ULL, 13597132616109237726ULL },
+    {  1232659579085827361ULL, 16996415770136547158ULL },
+    { 14605470292210805812ULL, 10622759856335341973ULL },
+    {  4421779809981343554ULL, 13278449820419177467ULL },
+    {   915538744049291538ULL, 16598062275523971834ULL },
+    {  5183897733458195115ULL, 10373788922202482396ULL },
+    {  6479872166822743894ULL, 12967236152753102995ULL },
+    {  3488154190101041964ULL, 16209045190941378744ULL },
+    {  2180096368813151227ULL, 10130653244338361715ULL },
+    { 16560178516298602746ULL, 12663316555422952143ULL },
+    { 16088537126945865529ULL, 15829145694278690179ULL },
+    {  7749492695127472003ULL,  9893216058924181362ULL },
+    {   463493832054564196ULL, 12366520073655226703ULL },
+    { 14414425345350368957ULL, 15458150092069033378ULL },
+    { 13620701859271368502ULL,  9661343807543145861ULL },
+    {  3190819268807046916ULL, 12076679759428932327ULL },
+    { 17823582141290972357ULL, 15095849699286165408ULL },
+    { 11139738838306857723ULL,  9434906062053853380ULL },
+    { 13924673547883572154ULL, 11793632577567316725ULL },
+    {  3570783879572301480ULL, 14742040721959145907ULL },
+    { 18298537904747540562ULL, 18427550902448932383ULL },
+    { 18354115218108294707ULL, 11517219314030582739ULL },
+    { 18330958004207980480ULL, 14396524142538228424ULL },
+    {  4466953431550423984ULL, 17995655178172785531ULL },
+    {   486002885505321038ULL, 11247284486357990957ULL },
+    {  5219189625309039202ULL, 14059105607947488696ULL },
+    {  6523987031636299002ULL, 17573882009934360870ULL },
+    { 17912549950054850588ULL, 10983676256208975543ULL },
+    { 17779001419141175331ULL, 13729595320261219429ULL },
+    {  8388693718644305452ULL, 17161994150326524287ULL },
+    { 12160462601793772764ULL, 10726246343954077679ULL },
+    { 10588892233814828051ULL, 13407807929942597099ULL },
+    {  8624429273841147159ULL, 16759759912428246374ULL },
+    {   778582277723329070ULL, 10474849945267653984ULL },
+    {   973227847154161338ULL, 13093562431584567480ULL },
+    {  1216534808942701673ULL, 16366953039480709350ULL },
+    { 14595392310871352257ULL, 10229345649675443343ULL },
+    { 13632554370161802418ULL, 12786682062094304179ULL },
+    { 12429006944274865118ULL, 15983352577617880224ULL },
+    {  7768129340171790699ULL,  9989595361011175140ULL },
+    {  9710161675214738374ULL, 12486994201263968925ULL },
+    { 16749388112445810871ULL, 15608742751579961156ULL },
+    {  1244995533423855986ULL,  9755464219737475723ULL },
+    { 15391302472061983695ULL, 12194330274671844653ULL },
+    {  5404070034795315907ULL, 15242912843339805817ULL },
+    { 14906758817815542202ULL,  9526820527087378635ULL },
+    { 14021762503842039848ULL, 11908525658859223294ULL },
+    {  8303831092947774002ULL, 14885657073574029118ULL },
+    {   578208414664970847ULL,  9303535670983768199ULL },
+    { 14557818573613377271ULL, 11629419588729710248ULL },
+    { 18197273217016721589ULL, 14536774485912137810ULL },
+    { 13523219484416126178ULL, 18170968107390172263ULL },
+    { 15369541205401160717ULL, 11356855067118857664ULL },
+    {   765182433041899281ULL, 14196068833898572081ULL },
+    {  5568164059729762005ULL, 17745086042373215101ULL },
+    {  5785945546544795205ULL, 11090678776483259438ULL },
+    { 16455803970035769814ULL, 13863348470604074297ULL },
+    {  6734696907262548556ULL, 17329185588255092872ULL },
+    {  4209185567039092847ULL, 10830740992659433045ULL },
+    {  9873167977226253963ULL, 13538426240824291306ULL },
+    {  3118087934678041646ULL, 16923032801030364133ULL },
+    {  4254647968387469981ULL, 10576895500643977583ULL },
+    {   706623942056949572ULL, 13221119375804971979ULL },
+    { 14718337982853350677ULL, 16526399219756214973ULL },
+    { 11504804248497038125ULL, 10328999512347634358ULL },
+    {  5157633273766521849ULL, 12911249390434542948ULL },
+    {  6447041592208152311ULL, 16139061738043178685ULL },
+    {  6335244004343789146ULL, 10086913586276986678ULL },
+    { 17142427042284512241ULL, 12608641982846233347ULL },
+    { 16816347784428252397ULL, 15760802478557791684ULL },
+    {  1286845328412881940ULL,  9850501549098619803ULL },
+    { 15443614715798266137ULL, 12313126936373274753ULL },
+    {  5469460339465668959ULL, 15391408670466593442ULL },
+    {  8030098730593431003ULL,  9619630419041620901ULL },
+    { 14649309431669176658ULL, 12024538023802026126ULL },
+    {  9088264752731695015ULL, 15030672529752532658ULL },
+    { 10291851488884697288ULL,  9394170331095332911ULL },
+    {  8253128342678483706ULL, 11742712913869166139ULL },
+    {  5704724409920716729ULL, 14678391142336457674ULL },
+    { 16354277549255671720ULL, 18347988927920572092ULL },
+    {   998051431430019017ULL, 11467493079950357558ULL },
+    { 10470936326142299579ULL, 14334366349937946947ULL },
+    {  8476984389250486570ULL, 17917957937422433684ULL },
+    { 14521487280136329914ULL, 11198723710889021052ULL },
+    { 18151859100170412392ULL, 13998404638611276315ULL },
+    { 18078137856785627587ULL, 17498005798264095394ULL },
+    { 15910522178918405146ULL, 10936253623915059621ULL },
+    {  6053094668365842720ULL, 13670317029893824527ULL },
+    {  2954682317029915496ULL, 17087896287367280659ULL },
+    { 17987577512639554849ULL, 10679935179604550411ULL },
+    { 17872785872372055657ULL, 13349918974505688014ULL },
+    { 13117610303610293764ULL, 16687398718132110018ULL },
+    { 12810192458183821506ULL, 10429624198832568761ULL },
+    {  2177682517447613171ULL, 13037030248540710952ULL },
+    {  2722103146809516464ULL, 16296287810675888690ULL },
+    {  6313000485183335694ULL, 10185179881672430431ULL },
+    {  3279564588051781713ULL, 12731474852090538039ULL },
+    { 17934513790346890853ULL, 15914343565113172548ULL },
+    {  1985699082112030975ULL,  9946464728195732843ULL },
+    { 16317181907922202431ULL, 12433080910244666053ULL },
+    {  6561419329620589327ULL, 15541351137805832567ULL },
+    { 11018416108653950185ULL,  9713344461128645354ULL },
+    {  4549648098962661924ULL, 12141680576410806693ULL },
+    { 10298746142130715309ULL, 15177100720513508366ULL },
+    {  1825030320404309164ULL,  9485687950320942729ULL },
+    {  6892973918932774359ULL, 11857109937901178411ULL },
+    {  4004531380238580045ULL, 14821387422376473014ULL },
+    { 16337890167931276240ULL,  9263367138985295633ULL },
+    {  6587304654631931588ULL, 11579208923731619542ULL },
+    { 17457502855144690293ULL, 14474011154664524427ULL },
+    { 17210192550503474962ULL, 18092513943330655534ULL },
+    {  6144684325637283947ULL, 11307821214581659709ULL },
+    { 12292541425473992838ULL, 14134776518227074636ULL },
+    { 15365676781842491048ULL, 17668470647783843295ULL },
+    { 16521077016292638761ULL, 11042794154864902059ULL },
+    { 16039660251938410547ULL, 13803492693581127574ULL },
+    { 10826203278068237376ULL, 17254365866976409468ULL },
+    { 15989749085647424168ULL, 10783978666860255917ULL },
+    {  6152128301777116498ULL, 13479973333575319897ULL },
+    { 12301846395648783526ULL, 16849966666969149871ULL },
+    { 14606183024921571560ULL, 10531229166855718669ULL },
+    {  4422670725869800738ULL, 13164036458569648337ULL },
+    { 10140024425764638826ULL, 16455045573212060421ULL },
+    {  8643358275316593218ULL, 10284403483257537763ULL },
+    {  6192511825718353619ULL, 12855504354071922204ULL },
+    {  7740639782147942024ULL, 16069380442589902755ULL },
+    {  2532056854628769813ULL, 10043362776618689222ULL },
+    { 12388443105140738074ULL, 12554203470773361527ULL },
+    { 10873867862998534689ULL, 15692754338466701909ULL },
+    {  9102010423587778132ULL,  9807971461541688693ULL },
+    { 15989199047912110569ULL, 12259964326927110866ULL },
+    { 10763126773035362404ULL, 15324955408658888583ULL },
+    { 13644483260788183358ULL,  9578097130411805364ULL },
+    { 17055604075985229198ULL, 11972621413014756705ULL },
+    {  7484447039699372786ULL, 14965776766268445882ULL },
+    {  9289465418239495895ULL,  9353610478917778676ULL },
+    { 11611831772799369869ULL, 11692013098647223345ULL },
+    {   679731660717048624ULL, 14615016373309029182ULL },
+    { 10073036612751086588ULL, 18268770466636286477ULL },
+    {  8601490892183123069ULL, 11417981541647679048ULL },
+    { 10751863615228903837ULL, 14272476927059598810ULL },
+    {  4216457482181353988ULL, 17840596158824498513ULL },
+    { 14164500972431816002ULL, 11150372599265311570ULL },
+    {  8482254178684994195ULL, 13937965749081639463ULL },
+    {  5991131704928854840ULL, 17422457186352049329ULL },
+    { 15273672361649004035ULL, 10889035741470030830ULL },
+    {  9868718415206479236ULL, 13611294676837538538ULL },
+    {  3112525982153323237ULL, 17014118346046923173ULL },
+    {  4251171748059520975ULL, 10633823966279326983ULL },
+    {   702278666647013314ULL, 13292279957849158729ULL },
+    {  5489534351736154547ULL, 16615349947311448411ULL },
+    {  1125115960621402640ULL, 10384593717069655257ULL },
+    {  6018080969204141204ULL, 12980742146337069071ULL },
+    {  2910915193077788601ULL, 16225927682921336339ULL },
+    { 17960223060169475539ULL, 10141204801825835211ULL },
+    { 17838592806784456520ULL, 12676506002282294014ULL },
+    { 13074868971625794843ULL, 15845632502852867518ULL },
+    {  3560107088838733872ULL,  9903520314283042199ULL },
+    { 18285191916330581053ULL, 12379400392853802748ULL },
+    {  4409745821703674700ULL, 15474250491067253436ULL },
+    { 11979463175419572495ULL,  9671406556917033397ULL },
+    {  1139270913992301907ULL, 12089258196146291747ULL },
+    { 15259146697772541096ULL, 15111572745182864683ULL },
+    {  7231123676894144233ULL,  9444732965739290427ULL },
+    {  4427218577690292387ULL, 11805916207174113034ULL },
+    { 14757395258967641292ULL, 14757395258967641292ULL },
+    {                    0ULL,  9223372036854775808ULL },
+    {                    0ULL, 11529215046068469760ULL },
+    {                    0ULL, 14411518807585587200ULL },
+    {                    0ULL, 18014398509481984000ULL },
+    {                    0ULL, 11258999068426240000ULL },
+    {                    0ULL, 14073748835532800000ULL },
+    {                    0ULL, 17592186044416000000ULL },
+    {                    0ULL, 10995116277760000000ULL },
+    {                    0ULL, 13743895347200000000ULL },
+    {                    0ULL, 17179869184000000000ULL },
+    {                    0ULL, 10737418240000000000ULL },
+    {                    0ULL, 13421772800000000000ULL },
+    {                    0ULL, 16777216000000000000ULL },
+    {                    0ULL, 10485760000000000000ULL },
+    {                    0ULL, 13107200000000000000ULL },
+    {                    0ULL, 16384000000000000000ULL },
+    {                    0ULL, 10240000000000000000ULL },
+    {                    0ULL, 12800000000000000000ULL },
+    {                    0ULL, 16000000000000000000ULL },
+    {                    0ULL, 10000000000000000000ULL },
+    {                    0ULL, 12500000000000000000ULL },
+    {                    0ULL, 15625000000000000000ULL },
+    {                    0ULL,  9765625000000000000ULL },
+    {                    0ULL, 12207031250000000000ULL },
+    {                    0ULL, 15258789062500000000ULL },
+    {                    0ULL,  9536743164062500000ULL },
+    {                    0ULL, 11920928955078125000ULL },
+    {                    0ULL, 14901161193847656250ULL },
+    {  4611686018427387904ULL,  9313225746154785156ULL },
+    {  5764607523034234880ULL, 11641532182693481445ULL },
+    { 11817445422220181504ULL, 14551915228366851806ULL },
+    {  5548434740920451072ULL, 18189894035458564758ULL },
+    { 17302829768357445632ULL, 11368683772161602973ULL },
+    {  7793479155164643328ULL, 14210854715202003717ULL },
+    { 14353534962383192064ULL, 17763568394002504646ULL },
+    {  4359273333062107136ULL, 11102230246251565404ULL },
+    {  5449091666327633920ULL, 13877787807814456755ULL },
+    {  2199678564482154496ULL, 17347234759768070944ULL },
+    {  1374799102801346560ULL, 10842021724855044340ULL },
+    {  1718498878501683200ULL, 13552527156068805425ULL },
+    {  6759809616554491904ULL, 16940658945086006781ULL },
+    {  6530724019560251392ULL, 10587911840678754238ULL },
+    { 17386777061305090048ULL, 13234889800848442797ULL },
+    {  7898413271349198848ULL, 16543612251060553497ULL },
+    { 16465723340661719040ULL, 10339757656912845935ULL },
+    { 15970468157399760896ULL, 12924697071141057419ULL },
+    { 15351399178322313216ULL, 16155871338926321774ULL },
+    {  4982938468024057856ULL, 10097419586828951109ULL },
+    { 10840359103457460224ULL, 12621774483536188886ULL },
+    {  4327076842467049472ULL, 15777218104420236108ULL },
+    { 11927795063396681728ULL,  9860761315262647567ULL },
+    { 10298057810818464256ULL, 12325951644078309459ULL },
+    {  8260886245095692416ULL, 15407439555097886824ULL },
+    {  5163053903184807760ULL,  9629649721936179265ULL },
+    { 11065503397408397604ULL, 12037062152420224081ULL },
+    { 18443565265187884909ULL, 15046327690525280101ULL },
+    { 13833071299956122020ULL,  9403954806578300063ULL },
+    { 12679653106517764621ULL, 11754943508222875079ULL },
+    { 11237880364719817872ULL, 14693679385278593849ULL },
+    {   212292400617608628ULL, 18367099231598242312ULL },
+    {   132682750386005392ULL, 11479437019748901445ULL },
+    {  4777539456409894645ULL, 14349296274686126806ULL },
+    { 15195296357367144114ULL, 17936620343357658507ULL },
+    {  7191217214140771119ULL, 11210387714598536567ULL },
+    {  4377335499248575995ULL, 14012984643248170709ULL },
+    { 10083355392488107898ULL, 17516230804060213386ULL },
+    { 10913783138732455340ULL, 10947644252537633366ULL },
+    {  4418856886560793367ULL, 13684555315672041708ULL },
+    {  5523571108200991709ULL, 17105694144590052135ULL },
+    { 10369760970266701674ULL, 10691058840368782584ULL },
+    { 12962201212833377092ULL, 13363823550460978230ULL },
+    {  6979379479186945558ULL, 16704779438076222788ULL },
+    { 13585484211346616781ULL, 10440487148797639242ULL },
+    {  7758483227328495169ULL, 13050608935997049053ULL },
+    { 14309790052588006865ULL, 16313261169996311316ULL },
+    { 18166990819722280098ULL, 10195788231247694572ULL },
+    {  4261994450943298507ULL, 12744735289059618216ULL },
+    {  5327493063679123134ULL, 15930919111324522770ULL },
+    {  7941369183226839863ULL,  9956824444577826731ULL },
+    {  5315025460606161924ULL, 12446030555722283414ULL },
+    { 15867153862612478214ULL, 15557538194652854267ULL },
+    {  7611128154919104931ULL,  9723461371658033917ULL },
+    { 14125596212076269068ULL, 12154326714572542396ULL },
+    { 17656995265095336336ULL, 15192908393215677995ULL },
+    {  8729779031470891258ULL,  9495567745759798747ULL },
+    {  6300537770911226168ULL, 11869459682199748434ULL },
+    { 17099044250493808518ULL, 14836824602749685542ULL },
+    {  6075216638131242420ULL,  9273015376718553464ULL },
+    {  7594020797664053025ULL, 11591269220898191830ULL },
+    {   269153960225290473ULL, 14489086526122739788ULL },
+    {   336442450281613091ULL, 18111358157653424735ULL },
+    {  7127805559067090038ULL, 11319598848533390459ULL },
+    {  4298070930406474644ULL, 14149498560666738074ULL },
+    { 14595960699862869113ULL, 17686873200833422592ULL },
+    {  9122475437414293195ULL, 11054295750520889120ULL },
+    { 11403094296767866494ULL, 13817869688151111400ULL },
+    { 14253867870959833118ULL, 17272337110188889250ULL },
+    { 13520353437777283602ULL, 10795210693868055781ULL },
+    {  3065383741939440791ULL, 13494013367335069727ULL },
+    { 17666787732706464701ULL, 16867516709168837158ULL },
+    {  6430056314514152534ULL, 10542197943230523224ULL },
+    {  8037570393142690668ULL, 13177747429038154030ULL },
+    {   823590954573587527ULL, 16472184286297692538ULL },
+    {  5126430365035880108ULL, 10295115178936057836ULL },
+    {  6408037956294850135ULL, 12868893973670072295ULL },
+    {  3398361426941174765ULL, 16086117467087590369ULL },
+    { 13653190937906703988ULL, 10053823416929743980ULL },
+    { 17066488672383379985ULL, 12567279271162179975ULL },
+    { 16721424822051837077ULL, 15709099088952724969ULL },
+    {  3533361486141316317ULL,  9818186930595453106ULL },
+    { 13640073894531421205ULL, 12272733663244316382ULL },
+    {  7826720331309500698ULL, 15340917079055395478ULL },
+    {   280014188641050032ULL,  9588073174409622174ULL },
+    {  9573389772656088348ULL, 11985091468012027717ULL },
+    { 16578423234247498339ULL, 14981364335015034646ULL },
+    {  5749828502977298558ULL,  9363352709384396654ULL },
+    { 16410657665576399005ULL, 11704190886730495817ULL },
+    {  6678264026688335045ULL, 14630238608413119772ULL },
+    {  8347830033360418806ULL, 18287798260516399715ULL },
+    {  2911550761636567802ULL, 11429873912822749822ULL },
+    { 12862810488900485560ULL, 14287342391028437277ULL },
+    {  2243455055843443238ULL, 17859177988785546597ULL },
+    {  3708002419115845976ULL, 11161986242990966623ULL },
+    {    23317005467419566ULL, 13952482803738708279ULL },
+    { 13864204312116438170ULL, 17440603504673385348ULL },
+    { 17888499731927549664ULL, 10900377190420865842ULL },
+    { 13137252628054661272ULL, 13625471488026082303ULL },
+    { 11809879766640938686ULL, 17031839360032602879ULL },
+    { 14298703881791668535ULL, 10644899600020376799ULL },
+    { 13261693833812197764ULL, 13306124500025470999ULL },
+    { 11965431273837859301ULL, 16632655625031838749ULL },
+    {  9784237555362356015ULL, 10395409765644899218ULL },
+    {  3006924907348169211ULL, 12994262207056124023ULL },
+    { 17593714189467375226ULL, 16242827758820155028ULL },
+    {  1772699331562333708ULL, 10151767349262596893ULL },
+    {  6827560182880305039ULL, 12689709186578246116ULL },
+    {  8534450228600381299ULL, 15862136483222807645ULL },
+    {  7639874402088932264ULL,  9913835302014254778ULL },
+    {   326470965756389522ULL, 12392294127517818473ULL },
+    {  5019774725622874806ULL, 15490367659397273091ULL },
+    {   831516194300602802ULL,  9681479787123295682ULL },
+    { 10262767279730529310ULL, 12101849733904119602ULL },
+    {  3605087062808385830ULL, 15127312167380149503ULL },
+    {  9170708441896323000ULL,  9454570104612593439ULL },
+    {  6851699533943015846ULL, 11818212630765741799ULL },
+    {  3952938399001381903ULL, 14772765788457177249ULL },
+    { 13999801545444333449ULL,  9232978617785735780ULL },
+    { 17499751931805416812ULL, 11541223272232169725ULL },
+    {  8039631859474607303ULL, 14426529090290212157ULL },
+    { 14661225842770647033ULL, 18033161362862765196ULL },
+    { 18386638188586430203ULL, 11270725851789228247ULL },
+    { 18371611717305649850ULL, 14088407314736535309ULL },
+    {  9129456591349898601ULL, 17610509143420669137ULL },
+    { 17235125415662156385ULL, 11006568214637918210ULL },
+    { 12320534732722919674ULL, 13758210268297397763ULL },
+    { 10788982397476261688ULL, 17197762835371747204ULL },
+    { 15966486035277439363ULL, 10748601772107342002ULL },
+    { 10734735507242023396ULL, 13435752215134177503ULL },
+    {  8806733365625141341ULL, 16794690268917721879ULL },
+    { 12421737381156795194ULL, 10496681418073576174ULL },
+    {  6303799689591218185ULL, 13120851772591970218ULL },
+    { 17103121648843798539ULL, 16401064715739962772ULL },
+    {  1466078993672598279ULL, 10250665447337476733ULL },
+    {  6444284760518135752ULL, 12813331809171845916ULL },
+    {  8055355950647669691ULL, 16016664761464807395ULL },
+    {  2728754459941099604ULL, 10010415475915504622ULL },
+    { 12634315111781150314ULL, 12513019344894380777ULL },
+    {  1957835834444274180ULL, 15641274181117975972ULL },
+    { 10447019433382447170ULL,  9775796363198734982ULL },
+    {  3835402254873283155ULL, 12219745453998418728ULL },
+    {  4794252818591603944ULL, 15274681817498023410ULL },
+    {  7608094030047140369ULL,  9546676135936264631ULL },
+    {  4898431519131537557ULL, 11933345169920330789ULL },
+    { 10734725417341809851ULL, 14916681462400413486ULL },
+    {  2097517367411243253ULL,  9322925914000258429ULL },
+    {  7233582727691441970ULL, 11653657392500323036ULL },
+    {  9041978409614302462ULL, 14567071740625403795ULL },
+    {  6690786993590490174ULL, 18208839675781754744ULL },
+    {  4181741870994056359ULL, 11380524797363596715ULL },
+    {   615491320315182544ULL, 14225655996704495894ULL },
+    {  9992736187248753989ULL, 17782069995880619867ULL },
+    {  3939617107816777291ULL, 11113793747425387417ULL },
+    {  9536207403198359517ULL, 13892242184281734271ULL },
+    {  7308573235570561493ULL, 17365302730352167839ULL },
+    { 11485387299872682789ULL, 10853314206470104899ULL },
+    {  9745048106413465582ULL, 13566642758087631124ULL },
+    { 12181310133016831978ULL, 16958303447609538905ULL },
+    {   695789805494438130ULL, 10598939654755961816ULL },
+    {   869737256868047663ULL, 13248674568444952270ULL },
+    { 10310543607939835386ULL, 16560843210556190337ULL },
+    { 17973304801030866876ULL, 10350527006597618960ULL },
+    {  4019886927579031980ULL, 12938158758247023701ULL },
+    {  9636544677901177879ULL, 16172698447808779626ULL },
+    { 10634526442115624078ULL, 10107936529880487266ULL },
+    {  4069786015789754290ULL, 12634920662350609083ULL },
+    {   475546501309804958ULL, 15793650827938261354ULL },
+    {  4908902581746016003ULL,  9871031767461413346ULL },
+    { 15359500264037295811ULL, 12338789709326766682ULL },
+    {  9976003293191843956ULL, 15423487136658458353ULL },
+    { 17764217104313372233ULL,  9639679460411536470ULL },
+    { 12981899343536939483ULL, 12049599325514420588ULL },
+    { 16227374179421174354ULL, 15061999156893025735ULL },
+    { 17059637889779315827ULL,  9413749473058141084ULL },
+    {  2877803288514593168ULL, 11767186841322676356ULL },
+    {  3597254110643241460ULL, 14708983551653345445ULL },
+    {  9108253656731439729ULL, 18386229439566681806ULL },
+    {  1080972517029761926ULL, 11491393399729176129ULL },
+    {  5962901664714590312ULL, 14364241749661470161ULL },
+    { 12065313099320625794ULL, 17955302187076837701ULL },
+    {  9846663696289085073ULL, 11222063866923023563ULL },
+    {  7696643601933968437ULL, 14027579833653779454ULL },
+    {   397432465562684739ULL, 17534474792067224318ULL },
+    { 14083453346258841674ULL, 10959046745042015198ULL },
+    {  8380944645968776284ULL, 13698808431302518998ULL },
+    {  1252808770606194547ULL, 17123510539128148748ULL },
+    { 10006377518483647400ULL, 10702194086955092967ULL },
+    {  7896285879677171346ULL, 13377742608693866209ULL },
+    { 14482043368023852087ULL, 16722178260867332761ULL },
+    {  2133748077373825698ULL, 10451361413042082976ULL },
+    {  2667185096717282123ULL, 13064201766302603720ULL },
+    {  3333981370896602653ULL, 16330252207878254650ULL },
+    {  6695424375237764562ULL, 10206407629923909156ULL },
+    {  8369280469047205703ULL, 12758009537404886445ULL },
+    { 15073286604736395033ULL, 15947511921756108056ULL },
+    {  9420804127960246895ULL,  9967194951097567535ULL },
+    {  7164319141522920715ULL, 12458993688871959419ULL },
+    {  4343712908476262990ULL, 15573742111089949274ULL },
+    {  7326506586225052273ULL,  9733588819431218296ULL },
+    {  9158133232781315341ULL, 12166986024289022870ULL },
+    {  2224294504121868368ULL, 15208732530361278588ULL },
+    { 10613556101930943538ULL,  9505457831475799117ULL },
+    { 17878631145841067327ULL, 11881822289344748896ULL },
+    {  3901544858591782542ULL, 14852277861680936121ULL },
+    { 13967680582688333849ULL,  9282673663550585075ULL },
+    { 12847914709933029407ULL, 11603342079438231344ULL },
+    { 16059893387416286759ULL, 14504177599297789180ULL },
+    {  1628122660560806833ULL, 18130221999122236476ULL },
+    { 10240948699705280078ULL, 11331388749451397797ULL },
+    { 17412871893058988002ULL, 14164235936814247246ULL },
+    { 12542717829468959195ULL, 17705294921017809058ULL },
+    { 12450884661845487401ULL, 11065809325636130661ULL },
+    {  1728547772024695539ULL, 13832261657045163327ULL },
+    { 15995742770313033136ULL, 17290327071306454158ULL },
+    {  5385653213018257806ULL, 10806454419566533849ULL },
+    { 11343752534700210161ULL, 13508068024458167311ULL },
+    {  9568004649947874797ULL, 16885085030572709139ULL },
+    {  3674159897003727796ULL, 10553178144107943212ULL },
+    {  4592699871254659745ULL, 13191472680134929015ULL },
+    {  1129188820640936778ULL, 16489340850168661269ULL },
+    {  3011586022114279438ULL, 10305838031355413293ULL },
+    {  8376168546070237202ULL, 12882297539194266616ULL },
+    { 10470210682587796502ULL, 16102871923992833270ULL },
+    {  1932195658189984910ULL, 10064294952495520794ULL },
+    { 11638616609592256945ULL, 12580368690619400992ULL },
+    { 14548270761990321182ULL, 15725460863274251240ULL },
+    {  9092669226243950738ULL,  9828413039546407025ULL },
+    { 15977522551232326327ULL, 12285516299433008781ULL },
+    {  6136845133758244197ULL, 15356895374291260977ULL },
+    { 15364743254667372383ULL,  9598059608932038110ULL },
+    {  9982557031479439671ULL, 11997574511165047638ULL },
+    {  3254824252494523781ULL, 14996968138956309548ULL },
+    { 11257637194663853171ULL,  9373105086847693467ULL },
+    {  9460360474902428559ULL, 11716381358559616834ULL },
+    {  2602078556773259891ULL, 14645476698199521043ULL },
+    { 17087656251248738576ULL, 18306845872749401303ULL },
+    { 17597314184671543466ULL, 11441778670468375814ULL },
+    { 12773270693984653525ULL, 14302223338085469768ULL },
+    { 15966588367480816906ULL, 17877779172606837210ULL },
+    { 14590803748102898470ULL, 11173611982879273256ULL },
+    { 18238504685128623088ULL, 13967014978599091570ULL },
+    { 13574758819556003052ULL, 17458768723248864463ULL },
+    { 15401753289863583763ULL, 10911730452030540289ULL },
+    {  5417133557047315992ULL, 13639663065038175362ULL },
+    { 15994788983163920798ULL, 17049578831297719202ULL },
+    { 14608429132904838403ULL, 10655986769561074501ULL },
+    {  4425478360848884291ULL, 13319983461951343127ULL },
+    {   920161932633717460ULL, 16649979327439178909ULL },
+    {  2880944217109767365ULL, 10406237079649486818ULL },
+    { 12824552308241985014ULL, 13007796349561858522ULL },
+    {  6807318348447705459ULL, 16259745436952323153ULL },
+    { 15783789013848285672ULL, 10162340898095201970ULL },
+    { 10506364230455581282ULL, 12702926122619002463ULL },
+    {  8521269269642088699ULL, 15878657653273753079ULL },
+    { 12243322321167387293ULL,  9924161033296095674ULL },
+    {  6080780864604458308ULL, 12405201291620119593ULL },
+    { 12212662099182960789ULL, 15506501614525149491ULL },
+    {  5327070802775656541ULL,  9691563509078218432ULL },
+    {  6658838503469570676ULL, 12114454386347773040ULL },
+    {  8323548129336963345ULL, 15143067982934716300ULL },
+    { 14425589617690377899ULL,  9464417489334197687ULL },
+    { 13420301003685584469ULL, 11830521861667747109ULL },
+    {  2940318199324816875ULL, 14788152327084683887ULL },
+    {  8755227902219092403ULL,  9242595204427927429ULL },
+    { 15555720896201253407ULL, 11553244005534909286ULL },
+    { 10221279083396790951ULL, 14441555006918636608ULL },
+    { 12776598854245988689ULL, 18051943758648295760ULL },
+    {  7985374283903742931ULL, 11282464849155184850ULL },
+    {   758345818024902856ULL, 14103081061443981063ULL },
+    { 14782990327813292282ULL, 17628851326804976328ULL },
+    {  9239368954883307676ULL, 11018032079253110205ULL },
+    { 16160897212031522499ULL, 13772540099066387756ULL },
+    {  1754377441329851508ULL, 17215675123832984696ULL },
+    {  1096485900831157192ULL, 10759796952395615435ULL },
+    { 15205665431321110202ULL, 13449746190494519293ULL },
+    {  5172023733869224041ULL, 16812182738118149117ULL },
+    {  5538357842881958977ULL, 10507614211323843198ULL },
+    { 16146319340457224530ULL, 13134517764154803997ULL },
+    {  6347841120289366950ULL, 16418147205193504997ULL },
+    {  6273243709394548296ULL, 10261342003245940623ULL },
+    {  3229868618315797466ULL, 12826677504057425779ULL },
+    { 17872393828176910545ULL, 16033346880071782223ULL },
+    { 18087775170251650946ULL, 10020841800044863889ULL },
+    {  8774660907532399971ULL, 12526052250056079862ULL },
+    {  1744954097560724156ULL, 15657565312570099828ULL },
+    { 10313968347830228405ULL,  9785978320356312392ULL },
+    { 12892460434787785506ULL, 12232472900445390490ULL },
+    {  6892203506629956075ULL, 15290591125556738113ULL },
+    { 15836842237712192307ULL,  9556619453472961320ULL },
+    {  1349308723430688768ULL, 11945774316841201651ULL },
+    { 15521693959570524672ULL, 14932217896051502063ULL },
+    { 16618587752372659776ULL,  9332636185032188789ULL },
+    {  6938176635183661008ULL, 11665795231290235987ULL },
+    {  4061034775552188356ULL, 14582244039112794984ULL },
+    {  5076293469440235445ULL, 18227805048890993730ULL },
+    {  7784369436827535057ULL, 11392378155556871081ULL },
+    { 14342147814461806725ULL, 14240472694446088851ULL },
+    { 13315998749649870503ULL, 17800590868057611064ULL },
+    {  8322499218531169064ULL, 11125369292536006915ULL },
+    {  5791438004736573426ULL, 13906711615670008644ULL },
+    {  7239297505920716783ULL, 17383389519587510805ULL },
+    {  6830403950414141941ULL, 10864618449742194253ULL },
+    { 13149690956445065330ULL, 13580773062177742816ULL },
+    { 16437113695556331663ULL, 16975966327722178520ULL },
+    { 10273196059722707289ULL, 10609978954826361575ULL },
+    {  8229809056225996208ULL, 13262473693532951969ULL },
+    { 14898947338709883164ULL, 16578092116916189961ULL },
+    {  2394313059052595121ULL, 10361307573072618726ULL },
+    { 12216263360670519709ULL, 12951634466340773407ULL },
+    { 10658643182410761733ULL, 16189543082925966759ULL },
+    { 13579181016647807939ULL, 10118464426828729224ULL },
+    { 16973976270809759924ULL, 12648080533535911530ULL },
+    { 11994098301657424097ULL, 15810100666919889413ULL },
+    {  9802154447749584012ULL,  9881312916824930883ULL },
+    {  7641007041259592112ULL, 12351641146031163604ULL },
+    {  9551258801574490140ULL, 15439551432538954505ULL },
+    { 17498751797052526097ULL,  9649719645336846565ULL },
+    {  8038381691033493909ULL, 12062149556671058207ULL },
+    {  5436291095364479483ULL, 15077686945838822759ULL },
+};
@@ -0,0 +1,518 @@
+/*
+ *  Name: pose_stream.c
+ *  Description: Streaming operation chains over binary pose files
+ *
+ *  Copyright (C) 2012  Jason Hall
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Applies a chain of operations to every record of a pose file:
+ *
+ *	mvqcalc --poses [--chunk RECORDS] [--stats] IN OUT OP...
+ *
+ * IN and OUT may be '-' for stdin and stdout. The operations are applied
+ * in the order given:
+ *
+ *	transform=M0,...,M15	p = m * p, m column major like mat4x4_t
+ *	translate=X,Y,Z		p = p + v
+ *	rotate=X,Y,Z,W		rotate position and orientation by q
+ *	euler=X,Y,Z		same with quat_set3(), degrees
+ *	norm[=exact|fast|lazy]	normalize the orientation
+ *
+ * The file is processed a chunk of records at a time. A reader thread
+ * fills the next chunk and a writer thread drains the previous one while
+ * the chain runs on the current one, so I/O and math overlap. Only
+ * POSE_STREAM_BUFFERS chunks exist at any time, memory use does not
+ * depend on the file size.
+ *
+ * Each chunk is split into a vec3_t array of positions and a quat_soa_t
+ * of orientations so the chain can use the batched functions of
+ * mathlib_batch.c, which also spread large chunks over the worker pool.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+/* open()/read()/write() */
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "pose_stream.h"
+#include "numparse.h"
+
+/* one being read, one being processed, one being written */
+#define POSE_STREAM_BUFFERS	3
+
+typedef struct {
+    pose_record_t *records;
+    int32_t n;
+    gboolean last;
+} pose_buffer_t;
+
+typedef struct {
+    int in_fd, out_fd;
+    int32_t chunk;
+
+    GAsyncQueue *free_q;	/* empty buffers, for the reader */
+    GAsyncQueue *full_q;	/* read buffers, for the chain */
+    GAsyncQueue *done_q;	/* processed buffers, for the writer */
+
+    volatile gint abort;	/* set by the writer when output fails */
+    int read_errno;
+    int write_errno;
+    gboolean truncated;
+} pose_stream_t;
+
+///////////////////////////////////////////////////////////////////////
+//////////////////////////  OPERATIONS  ///////////////////////////////
+///////////////////////////////////////////////////////////////////////
+
+/*
+ * Parse up to n comma separated reals after the '='. Returns the number
+ * found, or -1 if there is anything else.
+ */
+static int
+parse_reals(const char *s, real *r, int n)
+{
+    const char *end;
+    int count;
+
+    if (*s != '=')
+	return 0;
+
+    count = numparse_array(s + 1, r, n, &end);
+    return *end == '\0' ? count : -1;
+}
+
+static gboolean
+op_is(const char *spec, const char *name)
+{
+    size_t len = strlen(name);
+
+    return strncmp(spec, name, len) == 0 &&
+	(spec[len] == '\0' || spec[len] == '=');
+}
+
+/* Parse one OP argument of the command line. */
+gboolean
+pose_op_parse(const char *spec, pose_op_t *op)
+{
+    const char *arg = strchr(spec, '=');
+    vec3_t angles;
+
+    memset(op, 0, sizeof(*op));
+
+    if (op_is(spec, "transform")) {
+	op->type = POSE_OP_TRANSFORM;
+	return parse_reals(spec + 9, op->m, 16) == 16;
+    }
+    if (op_is(spec, "translate")) {
+	op->type = POSE_OP_TRANSLATE;
+	return parse_reals(spec + 9, op->v, 3) == 3;
+    }
+    if (op_is(spec, "rotate")) {
+	op->type = POSE_OP_ROTATE;
+	if (parse_reals(spec + 6, op->q, 4) != 4)
+	    return FALSE;
+	quat_to_mat(op->q, op->m);
+	return TRUE;
+    }
+    if (op_is(spec, "euler")) {
+	op->type = POSE_OP_ROTATE;
+	if (parse_reals(spec + 5, angles, 3) != 3)
+	    return FALSE;
+	quat_set3(op->q, angles[X], angles[Y], angles[Z]);
+	quat_to_mat(op->q, op->m);
+	return TRUE;
+    }
+    if (op_is(spec, "norm")) {
+	op->type = POSE_OP_NORM;
+	if (arg == NULL || strcmp(arg, "=exact") == 0)
+	    op->mode = NORM_EXACT;
+	else if (strcmp(arg, "=fast") == 0)
+	    op->mode = NORM_FAST;
+	else if (strcmp(arg, "=lazy") == 0)
+	    op->mode = NORM_LAZY;
+	else
+	    return FALSE;
+	return TRUE;
+    }
+
+    return FALSE;
+}
+
+/*
+ * Run the chain over n poses. tmp needs room for n quaternions, it holds
+ * the rotation broadcast to every lane for quat_mult_n().
+ */
+void
+pose_chain_apply(pose_op_t *ops, int nops, vec3_t *p, quat_soa_t *q,
+	quat_soa_t *tmp, int32_t n)
+{
+    int32_t i;
+    int k;
+
+    for (k = 0; k < nops; k++) {
+	pose_op_t *op = &ops[k];
+
+	switch (op->type) {
+	    case POSE_OP_TRANSFORM:
+		vec3_transform_n(p, p, n, op->m);
+		break;
+	    case POSE_OP_TRANSLATE:
+		for (i = 0; i < n; i++)
+		    vec3_add(p[i], op->v, p[i]);
+		break;
+	    case POSE_OP_ROTATE:
+		vec3_transform_n(p, p, n, op->m);
+		for (i = 0; i < n; i++) {
+		    tmp->x[i] = op->q[X];
+		    tmp->y[i] = op->q[Y];
+		    tmp->z[i] = op->q[Z];
+		    tmp->w[i] = op->q[W];
+		}
+		// q = rotation * q
+		quat_mult_n(q, tmp, q, n);
+		break;
+	    case POSE_OP_NORM:
+		quat_norm_n(q, n, op->mode);
+		break;
+	}
+    }
+}
+
+///////////////////////////////////////////////////////////////////////
+///////////////////////////  STREAMING  ///////////////////////////////
+///////////////////////////////////////////////////////////////////////
+
+static GThread *
+pose_thread_new(GThreadFunc func, gpointer data)
+{
+#if GLIB_CHECK_VERSION(2,32,0)
+    return g_thread_new(NULL, func, data);
+#else
+    return g_thread_create(func, data, TRUE, NULL);
+#endif
+}
+
+/*
+ * Fill buf completely unless the input ends first. Returns the number of
+ * bytes read, -1 on error.
+ */
+static ssize_t
+read_full(int fd, void *buf, size_t size)
+{
+    size_t done = 0;
+    ssize_t r;
+
+    while (done < size) {
+	r = read(fd, (char *) buf + done, size - done);
+	if (r < 0 && errno == EINTR)
+	    continue;
+	if (r < 0)
+	    return -1;
+	if (r == 0)
+	    break;
+	done += r;
+    }
+
+    return done;
+}
+
+static gboolean
+write_full(int fd, const void *buf, size_t size)
+{
+    size_t done = 0;
+    ssize_t r;
+
+    while (done < size) {
+	r = write(fd, (const char *) buf + done, size - done);
+	if (r < 0 && errno == EINTR)
+	    continue;
+	if (r < 0)
+	    return FALSE;
+	done += r;
+    }
+
+    return TRUE;
+}
+
+static gpointer
+pose_reader(gpointer data)
+{
+    pose_stream_t *s = data;
+    size_t size = s->chunk * sizeof(pose_record_t);
+    pose_buffer_t *buf;
+    gboolean last;
+    ssize_t r;
+
+    do {
+	buf = g_async_queue_pop(s->free_q);
+
+	if (g_atomic_int_get(&s->abort)) {
+	    buf->n = 0;
+	    buf->last = TRUE;
+	} else {
+	    r = read_full(s->in_fd, buf->records, size);
+	    if (r < 0) {
+		s->read_errno = errno;
+		r = 0;
+	    } else if (r % sizeof(pose_record_t) != 0) {
+		s->truncated = TRUE;
+	    }
+	    buf->n = r / sizeof(pose_record_t);
+	    buf->last = (size_t) r < size;
+	}
+
+	// buf belongs to the other threads once pushed
+	last = buf->last;
+	g_async_queue_push(s->full_q, buf);
+    } while (!last);
+
+    return NULL;
+}
+
+static gpointer
+pose_writer(gpointer data)
+{
+    pose_stream_t *s = data;
+    pose_buffer_t *buf;
+    gboolean last;
+
+    do {
+	buf = g_async_queue_pop(s->done_q);
+	last = buf->last;
+
+	// after an error keep recycling buffers so the reader finishes
+	if (s->write_errno == 0 && buf->n > 0 &&
+		!write_full(s->out_fd, buf->records,
+		    buf->n * sizeof(pose_record_t))) {
+	    s->write_errno = errno;
+	    g_atomic_int_set(&s->abort, 1);
+	}
+
+	g_async_queue_push(s->free_q, buf);
+    } while (!last);
+
+    return NULL;
+}
+
+static void
+soa_alloc(quat_soa_t *q, int32_t n)
+{
+    q->x = g_new(real, n);
+    q->y = g_new(real, n);
+    q->z = g_new(real, n);
+    q->w = g_new(real, n);
+}
+
+static void
+soa_free(quat_soa_t *q)
+{
+    g_free(q->x);
+    g_free(q->y);
+    g_free(q->z);
+    g_free(q->w);
+}
+
+/*
+ * Stream every record of in_fd through the chain to out_fd, chunk
+ * records at a time (0 for POSE_STREAM_CHUNK). Returns FALSE after
+ * reporting an I/O error or an input that ends in a partial record.
+ * stats may be NULL.
+ */
+gboolean
+pose_stream_run(int in_fd, int out_fd, pose_op_t *ops, int nops,
+	int32_t chunk, pose_stream_stats_t *stats)
+{
+    pose_buffer_t buffers[POSE_STREAM_BUFFERS], *buf;
+    pose_stream_t s;
+    GThread *reader, *writer;
+    quat_soa_t q, tmp;
+    vec3_t *p;
+    GTimer *timer;
+    guint64 records = 0;
+    gboolean last;
+    int32_t i;
+    int k;
+
+    if (chunk <= 0)
+	chunk = POSE_STREAM_CHUNK;
+
+    memset(&s, 0, sizeof(s));
+    s.in_fd  = in_fd;
+    s.out_fd = out_fd;
+    s.chunk  = chunk;
+    s.free_q = g_async_queue_new();
+    s.full_q = g_async_queue_new();
+    s.done_q = g_async_queue_new();
+
+    for (k = 0; k < POSE_STREAM_BUFFERS; k++) {
+	buffers[k].records = g_new(pose_record_t, chunk);
+	g_async_queue_push(s.free_q, &buffers[k]);
+    }
+    p = g_new(vec3_t, chunk);
+    soa_alloc(&q, chunk);
+    soa_alloc(&tmp, chunk);
+
+    timer = g_timer_new();
+    reader = pose_thread_new(pose_reader, &s);
+    writer = pose_thread_new(pose_writer, &s);
+
+    do {
+	buf = g_async_queue_pop(s.full_q);
+
+	for (i = 0; i < buf->n; i++) {
+	    pose_record_t *r = &buf->records[i];
+
+	    vec3_cp(r->p, p[i]);
+	    q.x[i] = r->q[X];
+	    q.y[i] = r->q[Y];
+	    q.z[i] = r->q[Z];
+	    q.w[i] = r->q[W];
+	}
+
+	pose_chain_apply(ops, nops, p, &q, &tmp, buf->n);
+
+	for (i = 0; i < buf->n; i++) {
+	    pose_record_t *r = &buf->records[i];
+
+	    vec3_cp(p[i], r->p);
+	    r->q[X] = q.x[i];
+	    r->q[Y] = q.y[i];
+	    r->q[Z] = q.z[i];
+	    r->q[W] = q.w[i];
+	}
+
+	records += buf->n;
+	last = buf->last;
+	g_async_queue_push(s.done_q, buf);
+    } while (!last);
+
+    g_thread_join(reader);
+    g_thread_join(writer);
+    g_timer_stop(timer);
+
+    if (stats != NULL) {
+	stats->records = records;
+	stats->seconds = g_timer_elapsed(timer, NULL);
+    }
+
+    g_timer_destroy(timer);
+    for (k = 0; k < POSE_STREAM_BUFFERS; k++)
+	g_free(buffers[k].records);
+    g_free(p);
+    soa_free(&q);
+    soa_free(&tmp);
+    g_async_queue_unref(s.free_q);
+    g_async_queue_unref(s.full_q);
+    g_async_queue_unref(s.done_q);
+
+    if (s.read_errno != 0)
+	fprintf(stderr, "mvqcalc: read error: %s\n", g_strerror(s.read_errno));
+    if (s.write_errno != 0)
+	fprintf(stderr, "mvqcalc: write error: %s\n", g_strerror(s.write_errno));
+    if (s.truncated)
+	fprintf(stderr, "mvqcalc: input ends in a partial record\n");
+
+    return s.read_errno == 0 && s.write_errno == 0 && !s.truncated;
+}
+
+///////////////////////////////////////////////////////////////////////
+////////////////////////  COMMAND LINE  ///////////////////////////////
+///////////////////////////////////////////////////////////////////////
+
+static void
+pose_usage(void)
+{
+    fprintf(stderr, "usage: mvqcalc --poses [--chunk RECORDS] [--stats] "
+	    "IN OUT OP...\n"
+	    "ops: transform=M0,...,M15 translate=X,Y,Z rotate=X,Y,Z,W "
+	    "euler=X,Y,Z norm[=exact|fast|lazy]\n");
+    exit(2);
+}
+
+/* Entry point for --poses, argv[0] is the --poses argument itself. */
+int
+pose_stream_main(int argc, char **argv)
+{
+    pose_stream_stats_t stats;
+    gboolean show_stats = FALSE, ok;
+    const char *in_name, *out_name;
+    int32_t chunk = 0;
+    pose_op_t *ops;
+    int in_fd, out_fd, nops, i;
+
+    for (i = 1; i < argc && argv[i][0] == '-' && argv[i][1] == '-'; i++) {
+	if (strcmp(argv[i], "--chunk") == 0 && i + 1 < argc)
+	    chunk = atoi(argv[++i]);
+	else if (strcmp(argv[i], "--stats") == 0)
+	    show_stats = TRUE;
+	else
+	    pose_usage();
+    }
+    if (argc - i < 3)
+	pose_usage();
+
+    in_name  = argv[i++];
+    out_name = argv[i++];
+
+    nops = argc - i;
+    ops = g_new(pose_op_t, nops);
+    for (nops = 0; i < argc; i++, nops++) {
+	if (!pose_op_parse(argv[i], &ops[nops])) {
+	    fprintf(stderr, "mvqcalc: bad operation '%s'\n", argv[i]);
+	    pose_usage();
+	}
+    }
+
+    if (strcmp(in_name, "-") == 0) {
+	in_fd = STDIN_FILENO;
+    } else if ((in_fd = open(in_name, O_RDONLY)) < 0) {
+	perror(in_name);
+	return 1;
+    }
+    if (strcmp(out_name, "-") == 0) {
+	out_fd = STDOUT_FILENO;
+    } else if ((out_fd = open(out_name, O_WRONLY | O_CREAT | O_TRUNC, 0666)) < 0) {
+	perror(out_name);
+	return 1;
+    }
+
+    ok = pose_stream_run(in_fd, out_fd, ops, nops, chunk, &stats);
+
+    if (out_fd != STDOUT_FILENO && close(out_fd) != 0) {
+	perror(out_name);
+	ok = FALSE;
+    }
+    if (in_fd != STDIN_FILENO)
+	close(in_fd);
+    g_free(ops);
+
+    if (show_stats) {
+	double mb = stats.records * sizeof(pose_record_t) / 1e6;
+
+	fprintf(stderr, "%" G_GUINT64_FORMAT " records, %.1f MB in %.3f s, "
+		"%.1f MB/s\n", stats.records, mb, stats.seconds,
+		stats.seconds > 0.0 ? mb / stats.seconds : 0.0);
+    }
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,67 @@
+/*
+ *  Name: pose_stream.h
+ *  Description: Streaming operation chains over binary pose files
+ *
+ *  Copyright (C) 2012  Jason Hall
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef POSE_STREAM_H
+#define POSE_STREAM_H
+
+#include <stddef.h>
+
+#include "mathlib.h"
+
+/*
+ * A pose file is a plain sequence of these records in native byte order,
+ * with no header.
+ */
+typedef struct {
+    vec3_t p;	/* position */
+    quat_t q;	/* orientation */
+} pose_record_t;
+
+typedef enum {
+    POSE_OP_TRANSFORM,	/* p = m * p */
+    POSE_OP_TRANSLATE,	/* p = p + v */
+    POSE_OP_ROTATE,	/* p = q * p, orientation = q * orientation */
+    POSE_OP_NORM	/* normalize the orientation */
+} pose_op_type_t;
+
+typedef struct {
+    pose_op_type_t type;
+    mat4x4_t m;		/* POSE_OP_TRANSFORM, POSE_OP_ROTATE */
+    vec3_t v;		/* POSE_OP_TRANSLATE */
+    quat_t q;		/* POSE_OP_ROTATE */
+    norm_mode_t mode;	/* POSE_OP_NORM */
+} pose_op_t;
+
+typedef struct {
+    guint64 records;
+    double seconds;
+} pose_stream_stats_t;
+
+/* records per chunk when 0 is passed to pose_stream_run() */
+#define POSE_STREAM_CHUNK	65536
+
+gboolean pose_op_parse(const char *spec, pose_op_t *op);
+void pose_chain_apply(pose_op_t *ops, int nops, vec3_t *p, quat_soa_t *q,
+	quat_soa_t *tmp, int32_t n);
+gboolean pose_stream_run(int in_fd, int out_fd, pose_op_t *ops, int nops,
+	int32_t chunk, pose_stream_stats_t *stats);
+int pose_stream_main(int argc, char **argv);
+
+#endif /* POSE_STREAM_H */
@@ -0,0 +1,290 @@
+/*
+ *  Name: pose_stream_check.c
+ *  Description: Checks for the pose file streaming (make check)
+ *
+ *  Copyright (C) 2012  Jason Hall
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Runs every operation of mvqcalc --poses over a small generated file,
+ * with a chunk size that leaves a short chunk at the end, compares the
+ * output with the same operations done one record at a time with the
+ * scalar functions of mathlib.c, and makes sure an input that ends in a
+ * partial record exits with 1:
+ *
+ *	pose_stream_check [DIRECTORY]
+ *
+ * The scratch files go to DIRECTORY, the current one by default. Exits
+ * with 1 if any check failed.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+/* unlink() */
+#include <unistd.h>
+
+#include "pose_stream.h"
+
+/* records in the file, and a chunk size that doesn't divide it */
+#define CHECK_COUNT	1000
+#define CHECK_CHUNK	"64"
+
+/*
+ * the batched kernels against the scalar functions, relative to the
+ * value past 1: bit for bit in strict mode, see mathlib_check.c
+ */
+#ifdef MATHLIB_STRICT
+#define CHECK_TOLERANCE	0
+#else
+#define CHECK_TOLERANCE	1e-13
+#endif
+
+static int failures;
+
+static void
+check(gboolean ok, const char *what)
+{
+    printf("%-48s %s\n", what, ok ? "ok" : "FAILED");
+    if (!ok)
+	failures++;
+}
+
+/* rand() is never seeded, so every run checks the same numbers */
+static real
+check_random(real lo, real hi)
+{
+    return lo + (hi - lo) * (rand() / (double) RAND_MAX);
+}
+
+static gboolean
+write_file(const char *path, pose_record_t *r, size_t size)
+{
+    FILE *fp;
+    gboolean ok;
+
+    if ((fp = fopen(path, "wb")) == NULL) {
+	perror(path);
+	return FALSE;
+    }
+    ok = fwrite(r, 1, size, fp) == size;
+    return fclose(fp) == 0 && ok;
+}
+
+/* read CHECK_COUNT records, FALSE if there are more or fewer */
+static gboolean
+read_file(const char *path, pose_record_t *r)
+{
+    FILE *fp;
+    size_t n;
+
+    if ((fp = fopen(path, "rb")) == NULL) {
+	perror(path);
+	return FALSE;
+    }
+    n = fread(r, sizeof(pose_record_t), CHECK_COUNT + 1, fp);
+    fclose(fp);
+    return n == CHECK_COUNT;
+}
+
+static double
+diff(real a, real b)
+{
+    return fabs((double) a - (double) b) / MAX(1, fabs((double) b));
+}
+
+/* the largest difference between the records */
+static double
+records_diff(pose_record_t *a, pose_record_t *b)
+{
+    double d = 0;
+    int i, j;
+
+    for (i = 0; i < CHECK_COUNT; i++) {
+	for (j = 0; j < 3; j++)
+	    d = MAX(d, diff(a[i].p[j], b[i].p[j]));
+	for (j = 0; j < 4; j++)
+	    d = MAX(d, diff(a[i].q[j], b[i].q[j]));
+    }
+    return d;
+}
+
+/* what the chain does to one record, with the scalar functions */
+static void
+apply_scalar(pose_op_t *ops, int nops, pose_record_t *r)
+{
+    int k;
+
+    for (k = 0; k < nops; k++) {
+	switch (ops[k].type) {
+	    case POSE_OP_TRANSFORM:
+		vec3_transform(&r->p, 1, ops[k].m);
+		break;
+	    case POSE_OP_TRANSLATE:
+		vec3_add(r->p, ops[k].v, r->p);
+		break;
+	    case POSE_OP_ROTATE:
+		vec3_transform(&r->p, 1, ops[k].m);
+		quat_mult(r->q, ops[k].q);
+		break;
+	    case POSE_OP_NORM:
+		quat_norm_mode(r->q, ops[k].mode);
+		break;
+	}
+    }
+}
+
+/*
+ * Run mvqcalc --poses --chunk CHECK_CHUNK in out OPS over records and
+ * compare out with apply_scalar(). The ops are given the way the command
+ * line takes them, the scalar side parses them with pose_op_parse().
+ */
+static void
+check_ops(const char *in, const char *out, pose_record_t *records,
+	const char **specs, int nspecs)
+{
+    pose_record_t *ref, *got;
+    pose_op_t *ops;
+    char *argv[32], what[64];
+    double worst;
+    gboolean ok;
+    int argc, i;
+
+    ref = g_new(pose_record_t, CHECK_COUNT + 1);
+    got = g_new(pose_record_t, CHECK_COUNT + 1);
+    ops = g_new(pose_op_t, nspecs);
+
+    ok = TRUE;
+    for (i = 0; i < nspecs; i++)
+	ok &= pose_op_parse(specs[i], &ops[i]);
+    memcpy(ref, records, CHECK_COUNT * sizeof(pose_record_t));
+    for (i = 0; i < CHECK_COUNT; i++)
+	apply_scalar(ops, nspecs, &ref[i]);
+
+    argc = 0;
+    argv[argc++] = "--poses";
+    argv[argc++] = "--chunk";
+    argv[argc++] = CHECK_CHUNK;
+    argv[argc++] = (char *) in;
+    argv[argc++] = (char *) out;
+    for (i = 0; i < nspecs; i++)
+	argv[argc++] = (char *) specs[i];
+    argv[argc] = NULL;
+
+    ok = ok && pose_stream_main(argc, argv) == 0 && read_file(out, got);
+    worst = ok ? records_diff(got, ref) : 0;
+
+    snprintf(what, sizeof(what), "%s%s", specs[0], nspecs > 1 ? " ..." : "");
+    if (strlen(what) > 40)
+	strcpy(what + 37, "...");
+    check(ok && worst <= CHECK_TOLERANCE, what);
+    if (worst > CHECK_TOLERANCE)
+	printf("  off by %g\n", worst);
+
+    g_free(ref);
+    g_free(got);
+    g_free(ops);
+}
+
+int
+main(int argc, char **argv)
+{
+    const char *dir = argc > 1 ? argv[1] : ".";
+    char *in, *out, *transform, *rotate;
+    const char *chain[4];
+    pose_record_t *records, *got;
+    mat4x4_t m;
+    quat_t q;
+    char *argv_partial[6];
+    int i;
+
+    in = g_strdup_printf("%s/pose_stream_check.%d.in", dir, (int) getpid());
+    out = g_strdup_printf("%s/pose_stream_check.%d.out", dir, (int) getpid());
+
+    records = g_new(pose_record_t, CHECK_COUNT);
+    got = g_new(pose_record_t, CHECK_COUNT + 1);
+    for (i = 0; i < CHECK_COUNT; i++) {
+	vec3_set(records[i].p, check_random(-10, 10), check_random(-10, 10),
+		check_random(-10, 10));
+	vec4_set(records[i].q, check_random(-1, 1), check_random(-1, 1),
+		check_random(-1, 1), check_random(-1, 1));
+    }
+    check(write_file(in, records, CHECK_COUNT * sizeof(pose_record_t)),
+	    "write the input");
+
+    // the stream and apply_scalar() both parse this same text
+    for (i = 0; i < 16; i++)
+	m[i] = check_random(-2, 2);
+    transform = g_strdup_printf("transform=%.17g,%.17g,%.17g,%.17g,"
+	    "%.17g,%.17g,%.17g,%.17g,%.17g,%.17g,%.17g,%.17g,"
+	    "%.17g,%.17g,%.17g,%.17g", m[0], m[1], m[2], m[3], m[4], m[5],
+	    m[6], m[7], m[8], m[9], m[10], m[11], m[12], m[13], m[14], m[15]);
+    quat_set_euler(q, 30, -45, 60, EULER_ZYX);
+    rotate = g_strdup_printf("rotate=%.17g,%.17g,%.17g,%.17g",
+	    q[X], q[Y], q[Z], q[W]);
+
+    chain[0] = transform;
+    check_ops(in, out, records, chain, 1);
+    chain[0] = "translate=1.5,-2.25,1e-3";
+    check_ops(in, out, records, chain, 1);
+    chain[0] = rotate;
+    check_ops(in, out, records, chain, 1);
+    chain[0] = "euler=10,-20,30";
+    check_ops(in, out, records, chain, 1);
+    chain[0] = "norm";
+    check_ops(in, out, records, chain, 1);
+    chain[0] = "norm=fast";
+    check_ops(in, out, records, chain, 1);
+    chain[0] = "norm=lazy";
+    check_ops(in, out, records, chain, 1);
+
+    chain[0] = "norm=exact";
+    chain[1] = "euler=90,0,-45";
+    chain[2] = "translate=0,0,-5";
+    chain[3] = transform;
+    check_ops(in, out, records, chain, 4);
+
+    // half a record more, the whole ones still get written
+    check(write_file(in, records, CHECK_COUNT * sizeof(pose_record_t) +
+		sizeof(pose_record_t) / 2), "write a partial record");
+    argv_partial[0] = "--poses";
+    argv_partial[1] = "--chunk";
+    argv_partial[2] = CHECK_CHUNK;
+    argv_partial[3] = in;
+    argv_partial[4] = out;
+    argv_partial[5] = "norm";
+    printf("  (the message below is expected)\n");
+    fflush(stdout);
+    check(pose_stream_main(6, argv_partial) == 1 && read_file(out, got),
+	    "a partial record exits with 1");
+
+    unlink(in);
+    unlink(out);
+    g_free(in);
+    g_free(out);
+    g_free(transform);
+    g_free(rotate);
+    g_free(records);
+    g_free(got);
+
+    if (failures > 0) {
+	printf("%d checks FAILED\n", failures);
+	return 1;
+    }
+    return 0;
+}